@@ -10,7 +10,7 @@ cmake ..
 # Build the project
 make -j$(nproc)
 
-# Copy assets
-cp -r ../res ./
+# Cook assets (only changed files are reconverted)
+./asset-cooker ../res ./res
 
 echo "Build complete! Run ./Ag-n to start the game."
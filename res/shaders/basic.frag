@@ -16,8 +16,30 @@ uniform vec3 objectColor;
 uniform sampler2D diffuseTexture;
 uniform bool hasTexture;
 
+// LOD cross-fade: 0 = opaque, > 0 = fading in, < 0 = fading out
+uniform float lodFade;
+
+float bayer4x4(vec2 fragCoord)
+{
+    int x = int(mod(fragCoord.x, 4.0));
+    int y = int(mod(fragCoord.y, 4.0));
+    int index = x + y * 4;
+    const float pattern[16] = float[16](0.0, 8.0, 2.0, 10.0,
+                                        12.0, 4.0, 14.0, 6.0,
+                                        3.0, 11.0, 1.0, 9.0,
+                                        15.0, 7.0, 13.0, 5.0);
+    return (pattern[index] + 0.5) / 16.0;
+}
+
 void main()
 {
+    // Dithered LOD transition: the two levels cover complementary pixels
+    if (lodFade != 0.0) {
+        float threshold = bayer4x4(gl_FragCoord.xy);
+        if (lodFade > 0.0 ? threshold >= lodFade : threshold < -lodFade)
+            discard;
+    }
+
     // Ambient
     float ambientStrength = 0.1;
     vec3 ambient = ambientStrength * lightColor;
@@ -0,0 +1,40 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 DecalCoords;        // [-1, 1] across the full decal
+flat in float Type;         // 0 = bullet hole, 1 = blood
+flat in float Seed;
+
+float hash(vec2 p)
+{
+    return fract(sin(dot(p, vec2(127.1, 311.7)) + Seed * 43758.5453) * 43758.5453);
+}
+
+void main()
+{
+    // Random rotation per decal
+    float angle = Seed * 6.2831853;
+    vec2 p = mat2(cos(angle), -sin(angle), sin(angle), cos(angle)) * DecalCoords;
+    float r = length(p);
+    float theta = atan(p.y, p.x);
+
+    vec4 color;
+    if (Type < 0.5) {
+        // Dark hole, scorched ring with a ragged edge
+        float edge = 0.8 + 0.15 * sin(theta * 7.0 + Seed * 20.0);
+        float ring = 1.0 - smoothstep(0.3, edge, r);
+        float hole = 1.0 - smoothstep(0.22, 0.3, r);
+        color = vec4(mix(vec3(0.12, 0.11, 0.1), vec3(0.02), hole), max(hole, ring * 0.7));
+    } else {
+        // Irregular splat plus droplets
+        float edge = 0.55 + 0.15 * sin(theta * 5.0 + Seed * 13.0) + 0.08 * sin(theta * 11.0 + Seed * 7.0);
+        float splat = 1.0 - smoothstep(edge - 0.05, edge, r);
+        vec2 cell = floor(p * 4.0);
+        vec2 offset = fract(p * 4.0) - 0.5;
+        float droplet = step(0.8, hash(cell)) * (1.0 - smoothstep(0.1, 0.18, length(offset))) * step(edge, r);
+        color = vec4(0.35, 0.02, 0.02, max(splat, droplet) * 0.9);
+    }
+
+    if (color.a <= 0.01) discard;
+    FragColor = color;
+}
@@ -0,0 +1,24 @@
+#version 330 core
+layout (location = 0) in vec4 aCenterType;
+layout (location = 1) in vec4 aAxisUSeed;
+layout (location = 2) in vec4 aAxisV;
+layout (location = 3) in vec4 aClipRect;
+
+out vec2 DecalCoords;
+flat out float Type;
+flat out float Seed;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    // Triangle strip over the clipped rectangle
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    DecalCoords = mix(aClipRect.xy, aClipRect.zw, corner);
+    Type = aCenterType.w;
+    Seed = aAxisUSeed.w;
+
+    vec3 position = aCenterType.xyz + aAxisUSeed.xyz * DecalCoords.x + aAxisV.xyz * DecalCoords.y;
+    gl_Position = projection * view * vec4(position, 1.0);
+}
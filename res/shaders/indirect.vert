@@ -0,0 +1,38 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+// Instanced attribute: the draw's baseInstance selects the object index
+layout (location = 3) in uint aObjectIndex;
+
+struct ObjectData {
+    mat4 model;
+    vec4 boundingSphere;
+    uvec4 lodFirstIndex;
+    uvec4 lodIndexCount;
+    int baseVertex;
+    uint lodCount;
+    uint pad0;
+    uint pad1;
+};
+
+layout(std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    mat4 model = objects[aObjectIndex].model;
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    TexCoords = aTexCoords;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec4 Color;
+
+// Signed distance field: 0.5 on the glyph edge, 1 inside
+uniform sampler2D glyphAtlas;
+
+// Dark outline for readability over the scene, in distance-field units
+const float OUTLINE = 0.2;
+
+void main()
+{
+    float distance = texture(glyphAtlas, TexCoords).r;
+    float width = max(fwidth(distance) * 0.75, 1e-3);
+
+    float fill = smoothstep(0.5 - width, 0.5 + width, distance);
+    float outline = smoothstep(0.5 - OUTLINE - width, 0.5 - OUTLINE + width, distance);
+
+    float alpha = max(fill, outline * 0.75) * Color.a;
+    if (alpha <= 0.0) discard;
+    FragColor = vec4(Color.rgb * fill, alpha);
+}
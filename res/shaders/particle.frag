@@ -0,0 +1,18 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 Corner;
+in vec4 Color;
+flat in float Additive;
+
+void main()
+{
+    // Soft round sprite
+    float r2 = dot(Corner, Corner);
+    if (r2 >= 1.0) discard;
+    float falloff = (1.0 - r2) * (1.0 - r2);
+    float alpha = Color.a * falloff;
+
+    // Premultiplied; additive particles leave the destination unattenuated
+    FragColor = vec4(Color.rgb * alpha, alpha * (1.0 - Additive));
+}
@@ -0,0 +1,25 @@
+#version 330 core
+layout (location = 0) in vec4 aPositionSize;   // xyz + half-size, negative = alpha blended
+layout (location = 1) in vec4 aColor;
+
+out vec2 Corner;
+out vec4 Color;
+flat out float Additive;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    // Triangle strip quad from gl_VertexID
+    Corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+    Color = aColor;
+    Additive = aPositionSize.w > 0.0 ? 1.0 : 0.0;
+
+    // Camera-facing: offset along the view's right and up axes
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+    float size = abs(aPositionSize.w);
+    vec3 position = aPositionSize.xyz + (right * Corner.x + up * Corner.y) * size;
+    gl_Position = projection * view * vec4(position, 1.0);
+}
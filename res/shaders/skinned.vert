@@ -0,0 +1,36 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 3) in uvec4 aJoints;
+layout (location = 4) in vec4 aWeights;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+// Skinning matrices of the character being drawn
+const int MAX_JOINTS = 32;
+layout (std140) uniform JointPalette {
+    mat4 joints[MAX_JOINTS];
+};
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    mat4 skin = joints[aJoints.x] * aWeights.x +
+                joints[aJoints.y] * aWeights.y +
+                joints[aJoints.z] * aWeights.z +
+                joints[aJoints.w] * aWeights.w;
+
+    // Rigid joint transforms and a rigid model matrix: no inverse-transpose needed
+    mat4 skinnedModel = model * skin;
+    FragPos = vec3(skinnedModel * vec4(aPos, 1.0));
+    Normal = mat3(skinnedModel) * aNormal;
+    TexCoords = vec2(0.0);
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D sceneTexture;
+uniform vec2 uvScale;       // Rendered region / texture size
+uniform vec2 texelSize;     // 1 / texture size
+uniform float sharpness;    // 0 = plain bilinear, 1 = strongest
+
+// Contrast-adaptive sharpening on top of the bilinear upscale
+void main()
+{
+    vec2 uvMin = 0.5 * texelSize;
+    vec2 uvMax = uvScale - 0.5 * texelSize;
+    vec2 uv = clamp(TexCoords * uvScale, uvMin, uvMax);
+
+    vec3 center = texture(sceneTexture, uv).rgb;
+    vec3 north = texture(sceneTexture, clamp(uv + vec2(0.0, texelSize.y), uvMin, uvMax)).rgb;
+    vec3 south = texture(sceneTexture, clamp(uv - vec2(0.0, texelSize.y), uvMin, uvMax)).rgb;
+    vec3 east = texture(sceneTexture, clamp(uv + vec2(texelSize.x, 0.0), uvMin, uvMax)).rgb;
+    vec3 west = texture(sceneTexture, clamp(uv - vec2(texelSize.x, 0.0), uvMin, uvMax)).rgb;
+
+    // Sharpen less where local contrast is already high, to avoid ringing
+    vec3 minColor = min(center, min(min(north, south), min(east, west)));
+    vec3 maxColor = max(center, max(max(north, south), max(east, west)));
+    vec3 amount = sqrt(clamp(min(minColor, 1.0 - maxColor) / max(maxColor, vec3(1e-4)), 0.0, 1.0));
+
+    vec3 weight = amount * sharpness * (-1.0 / mix(8.0, 5.0, sharpness));
+    vec3 result = (center + (north + south + east + west) * weight) / (1.0 + 4.0 * weight);
+
+    FragColor = vec4(clamp(result, 0.0, 1.0), 1.0);
+}
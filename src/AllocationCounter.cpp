@@ -0,0 +1,95 @@
+#include "AllocationCounter.hpp"
+#include "MemoryTracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> s_allocations(0);
+static std::atomic<uint64_t> s_deallocations(0);
+static std::atomic<uint64_t> s_bytes(0);
+
+AllocationCounter::Snapshot AllocationCounter::get() {
+    Snapshot snapshot;
+    snapshot.allocations = s_allocations.load(std::memory_order_relaxed);
+    snapshot.deallocations = s_deallocations.load(std::memory_order_relaxed);
+    snapshot.bytes = s_bytes.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+// Stored just before every block so frees can be charged to the allocating tag
+struct BlockHeader {
+    uint64_t size;
+    uint16_t tag;
+    uint16_t aligned;       // Over-aligned block (separate free on Windows)
+    uint32_t offset;        // From the start of the underlying allocation
+};
+static_assert(sizeof(BlockHeader) == 16, "BlockHeader keeps blocks 16-byte aligned");
+
+static void* countedAlloc(std::size_t size, std::size_t alignment) {
+    const bool aligned = alignment > alignof(std::max_align_t);
+    const std::size_t headerSize = std::max(sizeof(BlockHeader), alignment);
+    unsigned char* raw;
+#ifdef _WIN32
+    raw = static_cast<unsigned char*>(aligned ? _aligned_malloc(headerSize + size, alignment) : std::malloc(headerSize + size));
+#else
+    // aligned_alloc wants a multiple of the alignment
+    raw = static_cast<unsigned char*>(aligned ? std::aligned_alloc(alignment, (headerSize + size + alignment - 1) / alignment * alignment)
+                                              : std::malloc(headerSize + size));
+#endif
+    if (!raw) return nullptr;
+
+    const MemoryTag tag = MemoryTracker::getCurrentTag();
+    unsigned char* pointer = raw + headerSize;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(pointer) - 1;
+    header->size = size;
+    header->tag = static_cast<uint16_t>(tag);
+    header->aligned = aligned ? 1 : 0;
+    header->offset = static_cast<uint32_t>(headerSize);
+
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+    MemoryTracker::recordAllocation(tag, size);
+    return pointer;
+}
+
+static void countedFree(void* pointer) {
+    if (!pointer) return;
+    const BlockHeader* header = static_cast<const BlockHeader*>(pointer) - 1;
+    s_deallocations.fetch_add(1, std::memory_order_relaxed);
+    MemoryTracker::recordFree(static_cast<MemoryTag>(header->tag), header->size);
+
+    void* raw = static_cast<unsigned char*>(pointer) - header->offset;
+#ifdef _WIN32
+    if (header->aligned) {
+        _aligned_free(raw);
+        return;
+    }
+#endif
+    std::free(raw);
+}
+
+static void* countedNew(std::size_t size, std::size_t alignment) {
+    void* pointer = countedAlloc(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(std::size_t size) { return countedNew(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return countedNew(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedNew(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedNew(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { countedFree(pointer); }
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts calls to the global operator new/delete, which AllocationCounter.cpp
+// replaces for the game executable. Used to verify that steady-state frames do
+// not allocate from the heap (transient data belongs in the FrameArena). Each
+// block carries a 16-byte header recording its size and MemoryTracker tag.
+class AllocationCounter {
+public:
+    struct Snapshot {
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t bytes = 0;         // Requested, not including allocator overhead
+
+        Snapshot operator-(const Snapshot& start) const {
+            Snapshot delta;
+            delta.allocations = allocations - start.allocations;
+            delta.deallocations = deallocations - start.deallocations;
+            delta.bytes = bytes - start.bytes;
+            return delta;
+        }
+    };
+
+    static Snapshot get();
+};
@@ -0,0 +1,249 @@
+#include "Animation.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ANIMATION_SSE
+#endif
+
+// Pose
+
+void Pose::resize(int joints) {
+    jointCount = joints;
+    size_t padded = static_cast<size_t>((joints + 3) & ~3);
+    for (std::vector<float>* array : { &rotationX, &rotationY, &rotationZ, &translationX, &translationY, &translationZ }) {
+        array->assign(padded, 0.0f);
+    }
+    rotationW.assign(padded, 1.0f);
+}
+
+void Pose::setJoint(int joint, const glm::quat& rotation, const glm::vec3& translation) {
+    rotationX[joint] = rotation.x;
+    rotationY[joint] = rotation.y;
+    rotationZ[joint] = rotation.z;
+    rotationW[joint] = rotation.w;
+    translationX[joint] = translation.x;
+    translationY[joint] = translation.y;
+    translationZ[joint] = translation.z;
+}
+
+glm::quat Pose::getRotation(int joint) const {
+    return glm::quat(rotationW[joint], rotationX[joint], rotationY[joint], rotationZ[joint]);
+}
+
+glm::vec3 Pose::getTranslation(int joint) const {
+    return glm::vec3(translationX[joint], translationY[joint], translationZ[joint]);
+}
+
+// AnimationClip
+
+namespace {
+
+uint64_t packRotation(const glm::quat& q) {
+    // q and -q are the same rotation; keep w positive so interpolation between keys stays short
+    glm::quat n = glm::normalize(q);
+    if (n.w < 0.0f) n = -n;
+    return glm::packSnorm4x16(glm::vec4(n.x, n.y, n.z, n.w));
+}
+
+glm::quat unpackRotation(uint64_t packed) {
+    glm::vec4 v = glm::unpackSnorm4x16(packed);
+    return glm::quat(v.w, v.x, v.y, v.z);
+}
+
+// Quantization step (fraction of the track range) below which a translation track counts as constant
+const float CONSTANT_TOLERANCE = 1e-4f;
+
+} // namespace
+
+AnimationClip::AnimationClip()
+    : m_jointCount(0)
+    , m_frameCount(0)
+    , m_sampleRate(30.0f)
+    , m_looping(true)
+{
+}
+
+void AnimationClip::compress(const std::vector<glm::quat>& rotations,
+                             const std::vector<glm::vec3>& translations,
+                             int jointCount, int frameCount, float sampleRate, bool looping) {
+    m_jointCount = jointCount;
+    m_frameCount = std::max(frameCount, 1);
+    m_sampleRate = sampleRate;
+    m_looping = looping;
+    m_tracks.assign(jointCount, Track());
+    m_rotationKeys.clear();
+    m_translationKeys.clear();
+
+    for (int joint = 0; joint < jointCount; joint++) {
+        Track& track = m_tracks[joint];
+
+        // Rotation keys; a track whose keys all quantize identically keeps one
+        track.rotationOffset = static_cast<uint32_t>(m_rotationKeys.size());
+        uint64_t first = packRotation(rotations[joint]);
+        track.constantRotation = true;
+        for (int frame = 1; frame < m_frameCount && track.constantRotation; frame++) {
+            track.constantRotation = packRotation(rotations[frame * jointCount + joint]) == first;
+        }
+        for (int frame = 0; frame < (track.constantRotation ? 1 : m_frameCount); frame++) {
+            m_rotationKeys.push_back(packRotation(rotations[frame * jointCount + joint]));
+        }
+
+        // Translation range
+        glm::vec3 minimum = translations[joint];
+        glm::vec3 maximum = minimum;
+        for (int frame = 1; frame < m_frameCount; frame++) {
+            minimum = glm::min(minimum, translations[frame * jointCount + joint]);
+            maximum = glm::max(maximum, translations[frame * jointCount + joint]);
+        }
+        glm::vec3 extent = maximum - minimum;
+        track.translationMin = minimum;
+        track.translationExtent = extent;
+        track.constantTranslation = std::max(extent.x, std::max(extent.y, extent.z)) < CONSTANT_TOLERANCE;
+
+        track.translationOffset = static_cast<uint32_t>(m_translationKeys.size());
+        for (int frame = 0; frame < (track.constantTranslation ? 1 : m_frameCount); frame++) {
+            glm::vec3 t = translations[frame * jointCount + joint];
+            glm::vec3 normalized(extent.x > 0.0f ? (t.x - minimum.x) / extent.x : 0.0f,
+                                 extent.y > 0.0f ? (t.y - minimum.y) / extent.y : 0.0f,
+                                 extent.z > 0.0f ? (t.z - minimum.z) / extent.z : 0.0f);
+            m_translationKeys.push_back(glm::packUnorm4x16(glm::vec4(normalized, 0.0f)));
+        }
+    }
+}
+
+float AnimationClip::getDuration() const {
+    // Looping clips wrap from the last key back to the first
+    return (m_looping ? m_frameCount : m_frameCount - 1) / m_sampleRate;
+}
+
+void AnimationClip::sample(float time, Pose& pose) const {
+    if (pose.jointCount != m_jointCount) pose.resize(m_jointCount);
+    if (m_jointCount == 0) return;
+
+    float frame = time * m_sampleRate;
+    int frame0, frame1;
+    if (m_looping) {
+        frame = std::fmod(frame, static_cast<float>(m_frameCount));
+        if (frame < 0.0f) frame += m_frameCount;
+        frame0 = std::min(static_cast<int>(frame), m_frameCount - 1);
+        frame1 = (frame0 + 1) % m_frameCount;
+    } else {
+        frame = std::min(std::max(frame, 0.0f), static_cast<float>(m_frameCount - 1));
+        frame0 = static_cast<int>(frame);
+        frame1 = std::min(frame0 + 1, m_frameCount - 1);
+    }
+    float alpha = frame - frame0;
+
+    for (int joint = 0; joint < m_jointCount; joint++) {
+        const Track& track = m_tracks[joint];
+
+        glm::quat rotation;
+        if (track.constantRotation) {
+            rotation = unpackRotation(m_rotationKeys[track.rotationOffset]);
+        } else {
+            glm::quat q0 = unpackRotation(m_rotationKeys[track.rotationOffset + frame0]);
+            glm::quat q1 = unpackRotation(m_rotationKeys[track.rotationOffset + frame1]);
+            if (glm::dot(q0, q1) < 0.0f) q1 = -q1;
+            rotation = glm::normalize(q0 * (1.0f - alpha) + q1 * alpha);
+        }
+
+        glm::vec3 translation;
+        if (track.constantTranslation) {
+            translation = glm::vec3(glm::unpackUnorm4x16(m_translationKeys[track.translationOffset]));
+        } else {
+            glm::vec3 t0 = glm::vec3(glm::unpackUnorm4x16(m_translationKeys[track.translationOffset + frame0]));
+            glm::vec3 t1 = glm::vec3(glm::unpackUnorm4x16(m_translationKeys[track.translationOffset + frame1]));
+            translation = glm::mix(t0, t1, alpha);
+        }
+        translation = track.translationMin + translation * track.translationExtent;
+
+        pose.setJoint(joint, rotation, translation);
+    }
+}
+
+size_t AnimationClip::getMemoryUsage() const {
+    return m_tracks.size() * sizeof(Track) +
+           (m_rotationKeys.size() + m_translationKeys.size()) * sizeof(uint64_t);
+}
+
+// Blending and skinning
+
+void Animation::blendPoses(const Pose& a, const Pose& b, float weight, Pose& out) {
+    if (out.jointCount != a.jointCount) out.resize(a.jointCount);
+    const int padded = (a.jointCount + 3) & ~3;
+
+#if defined(ANIMATION_SSE)
+    const __m128 wb = _mm_set1_ps(weight);
+    const __m128 wa = _mm_set1_ps(1.0f - weight);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (int i = 0; i < padded; i += 4) {
+        __m128 ax = _mm_loadu_ps(&a.rotationX[i]), ay = _mm_loadu_ps(&a.rotationY[i]);
+        __m128 az = _mm_loadu_ps(&a.rotationZ[i]), aw = _mm_loadu_ps(&a.rotationW[i]);
+        __m128 bx = _mm_loadu_ps(&b.rotationX[i]), by = _mm_loadu_ps(&b.rotationY[i]);
+        __m128 bz = _mm_loadu_ps(&b.rotationZ[i]), bw = _mm_loadu_ps(&b.rotationW[i]);
+
+        // Shortest path: flip b's weight where the quaternions point apart
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                                _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+        __m128 w = _mm_xor_ps(wb, _mm_and_ps(dot, signMask));
+
+        __m128 x = _mm_add_ps(_mm_mul_ps(ax, wa), _mm_mul_ps(bx, w));
+        __m128 y = _mm_add_ps(_mm_mul_ps(ay, wa), _mm_mul_ps(by, w));
+        __m128 z = _mm_add_ps(_mm_mul_ps(az, wa), _mm_mul_ps(bz, w));
+        __m128 q = _mm_add_ps(_mm_mul_ps(aw, wa), _mm_mul_ps(bw, w));
+
+        // Normalize (padding lanes are identity quaternions, never zero length)
+        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                     _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(q, q)));
+        __m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq));
+        _mm_storeu_ps(&out.rotationX[i], _mm_mul_ps(x, inverse));
+        _mm_storeu_ps(&out.rotationY[i], _mm_mul_ps(y, inverse));
+        _mm_storeu_ps(&out.rotationZ[i], _mm_mul_ps(z, inverse));
+        _mm_storeu_ps(&out.rotationW[i], _mm_mul_ps(q, inverse));
+
+        _mm_storeu_ps(&out.translationX[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&a.translationX[i]), wa),
+                                                       _mm_mul_ps(_mm_loadu_ps(&b.translationX[i]), wb)));
+        _mm_storeu_ps(&out.translationY[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&a.translationY[i]), wa),
+                                                       _mm_mul_ps(_mm_loadu_ps(&b.translationY[i]), wb)));
+        _mm_storeu_ps(&out.translationZ[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&a.translationZ[i]), wa),
+                                                       _mm_mul_ps(_mm_loadu_ps(&b.translationZ[i]), wb)));
+    }
+#else
+    for (int i = 0; i < padded; i++) {
+        float dot = a.rotationX[i] * b.rotationX[i] + a.rotationY[i] * b.rotationY[i] +
+                    a.rotationZ[i] * b.rotationZ[i] + a.rotationW[i] * b.rotationW[i];
+        float w = dot < 0.0f ? -weight : weight;
+        float x = a.rotationX[i] * (1.0f - weight) + b.rotationX[i] * w;
+        float y = a.rotationY[i] * (1.0f - weight) + b.rotationY[i] * w;
+        float z = a.rotationZ[i] * (1.0f - weight) + b.rotationZ[i] * w;
+        float q = a.rotationW[i] * (1.0f - weight) + b.rotationW[i] * w;
+        float inverse = 1.0f / std::sqrt(x * x + y * y + z * z + q * q);
+        out.rotationX[i] = x * inverse;
+        out.rotationY[i] = y * inverse;
+        out.rotationZ[i] = z * inverse;
+        out.rotationW[i] = q * inverse;
+        out.translationX[i] = a.translationX[i] * (1.0f - weight) + b.translationX[i] * weight;
+        out.translationY[i] = a.translationY[i] * (1.0f - weight) + b.translationY[i] * weight;
+        out.translationZ[i] = a.translationZ[i] * (1.0f - weight) + b.translationZ[i] * weight;
+    }
+#endif
+}
+
+void Animation::computeSkinningMatrices(const Skeleton& skeleton, const Pose& pose, glm::mat4* out) {
+    // Model-space joint transforms first (parents precede children), then apply the inverse bind
+    const int jointCount = skeleton.getJointCount();
+    for (int joint = 0; joint < jointCount; joint++) {
+        glm::mat4 local = glm::mat4_cast(pose.getRotation(joint));
+        local[3] = glm::vec4(pose.getTranslation(joint), 1.0f);
+
+        int parent = skeleton.parents[joint];
+        out[joint] = parent >= 0 ? out[parent] * local : local;
+    }
+    for (int joint = 0; joint < jointCount; joint++) {
+        out[joint] = out[joint] * skeleton.inverseBind[joint];
+    }
+}
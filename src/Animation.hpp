@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Joint hierarchy. Joints are ordered so every parent precedes its children.
+struct Skeleton {
+    std::vector<int> parents;               // -1 for the root
+    std::vector<glm::mat4> inverseBind;     // Model space -> joint space in the bind pose
+
+    int getJointCount() const { return static_cast<int>(parents.size()); }
+};
+
+// Local joint transforms in structure-of-arrays layout. Arrays are padded to
+// a multiple of four joints for the blend kernel.
+struct Pose {
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> translationX, translationY, translationZ;
+    int jointCount = 0;
+
+    void resize(int joints);
+    void setJoint(int joint, const glm::quat& rotation, const glm::vec3& translation);
+    glm::quat getRotation(int joint) const;
+    glm::vec3 getTranslation(int joint) const;
+};
+
+// Uniformly sampled animation clip with quantized keys.
+// Rotations are stored as four 16-bit snorm components (glm::packSnorm4x16),
+// translations as 16-bit unorm values inside a per-track range. Tracks that
+// never change are stored as a single key, which covers most translations.
+class AnimationClip {
+public:
+    AnimationClip();
+
+    // Raw keys are laid out [frame * jointCount + joint]
+    void compress(const std::vector<glm::quat>& rotations,
+                  const std::vector<glm::vec3>& translations,
+                  int jointCount, int frameCount, float sampleRate, bool looping);
+
+    // Sample every joint at `time` seconds (wrapped for looping clips)
+    void sample(float time, Pose& pose) const;
+
+    float getDuration() const;
+    int getJointCount() const { return m_jointCount; }
+    size_t getMemoryUsage() const;
+
+private:
+    struct Track {
+        uint32_t rotationOffset;
+        uint32_t translationOffset;
+        bool constantRotation;
+        bool constantTranslation;
+        glm::vec3 translationMin;
+        glm::vec3 translationExtent;
+    };
+
+    std::vector<Track> m_tracks;
+    std::vector<uint64_t> m_rotationKeys;
+    std::vector<uint64_t> m_translationKeys;
+    int m_jointCount;
+    int m_frameCount;
+    float m_sampleRate;
+    bool m_looping;
+};
+
+namespace Animation {
+
+// out = a blended towards b by `weight`: translations lerp, rotations take the
+// shortest-path normalized lerp. Processes four joints per step with SSE.
+void blendPoses(const Pose& a, const Pose& b, float weight, Pose& out);
+
+// Skinning matrices (model-space joint transform times inverse bind) for every joint
+void computeSkinningMatrices(const Skeleton& skeleton, const Pose& pose, glm::mat4* out);
+
+}
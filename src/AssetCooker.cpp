@@ -0,0 +1,436 @@
+#include "AssetCooker.hpp"
+#include "GltfImporter.hpp"
+#include "LevelFile.hpp"
+#include "MappedFile.hpp"
+#include "ObjImporter.hpp"
+#include "TextureCompressor.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* MANIFEST_NAME = ".cook-manifest";
+const uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+const uint64_t FNV_PRIME = 0x100000001b3ull;
+
+uint64_t hashBytes(uint64_t hash, const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool hasExtension(const std::string& path, const char* extension) {
+    size_t length = std::strlen(extension);
+    if (path.size() < length) return false;
+    for (size_t i = 0; i < length; i++) {
+        char c = path[path.size() - length + i];
+        if (std::tolower(static_cast<unsigned char>(c)) != extension[i]) return false;
+    }
+    return true;
+}
+
+std::string replaceExtension(const std::string& path, const char* extension) {
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + extension;
+    return path.substr(0, dot) + extension;
+}
+
+// Comments, trailing whitespace and blank lines removed; preprocessor lines kept
+std::string stripShader(const char* text, size_t size) {
+    std::string out;
+    std::string line;
+    bool inBlockComment = false;
+    for (size_t i = 0; i <= size; i++) {
+        char c = i < size ? text[i] : '\n';
+        if (inBlockComment) {
+            if (c == '*' && i + 1 < size && text[i + 1] == '/') {
+                inBlockComment = false;
+                i++;
+            }
+            continue;
+        }
+        if (c == '/' && i + 1 < size && text[i + 1] == '*') {
+            inBlockComment = true;
+            i++;
+            continue;
+        }
+        if (c == '/' && i + 1 < size && text[i + 1] == '/') {
+            while (i + 1 < size && text[i + 1] != '\n') i++;
+            continue;
+        }
+        if (c == '\n') {
+            while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.pop_back();
+            if (!line.empty()) out += line + '\n';
+            line.clear();
+            continue;
+        }
+        line += c;
+    }
+    return out;
+}
+
+struct ShaderVariable {
+    std::string type;
+    std::string name;
+    int location;
+};
+
+struct ShaderInfo {
+    std::string version;
+    std::vector<ShaderVariable> inputs;
+    std::vector<ShaderVariable> outputs;
+    std::vector<ShaderVariable> uniforms;
+    std::vector<std::string> blocks;
+};
+
+// Declarations at global scope of a comment-free shader
+ShaderInfo parseShader(const std::string& source) {
+    ShaderInfo info;
+    std::string body;
+    std::istringstream lines(source);
+    std::string line;
+    while (std::getline(lines, line)) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start != std::string::npos && line[start] == '#') {
+            if (line.compare(start, 8, "#version") == 0) {
+                info.version = line.substr(line.find_first_not_of(" \t", start + 8));
+            }
+            continue;
+        }
+        body += line + '\n';
+    }
+
+    // Split at ';' and at closing braces that return to global scope
+    std::vector<std::string> statements;
+    std::string current;
+    int depth = 0;
+    for (char c : body) {
+        if (c == '{') depth++;
+        if (c == '}') depth--;
+        current += c;
+        if ((c == ';' && depth == 0) || (c == '}' && depth == 0)) {
+            statements.push_back(current);
+            current.clear();
+        }
+    }
+
+    for (const auto& statement : statements) {
+        // layout(location = N) qualifiers
+        int location = -1;
+        std::string text = statement;
+        size_t layout = text.find("layout");
+        if (layout != std::string::npos) {
+            size_t close = text.find(')', layout);
+            std::string qualifiers = text.substr(layout, close == std::string::npos ? std::string::npos : close - layout);
+            size_t key = qualifiers.find("location");
+            if (key != std::string::npos) {
+                size_t equals = qualifiers.find('=', key);
+                if (equals != std::string::npos) location = std::atoi(qualifiers.c_str() + equals + 1);
+            }
+            if (close != std::string::npos) text.erase(layout, close - layout + 1);
+        }
+
+        std::istringstream tokens(text.substr(0, text.find('{')));
+        std::vector<std::string> words;
+        std::string word;
+        while (tokens >> word) {
+            if (word == "flat" || word == "smooth" || word == "noperspective" || word == "centroid" ||
+                word == "highp" || word == "mediump" || word == "lowp" || word == "const") continue;
+            words.push_back(word);
+        }
+        if (words.size() < 2) continue;
+
+        const std::string& storage = words[0];
+        if (storage != "in" && storage != "out" && storage != "uniform") continue;
+
+        if (text.find('{') != std::string::npos) {
+            info.blocks.push_back(words[1]);
+            continue;
+        }
+        if (words.size() < 3) continue;
+
+        // "type a, b[4];" -> one entry per name
+        std::string names;
+        for (size_t i = 2; i < words.size(); i++) names += words[i];
+        std::istringstream list(names);
+        std::string name;
+        while (std::getline(list, name, ',')) {
+            name = name.substr(0, name.find_first_of("[;="));
+            if (name.empty()) continue;
+            ShaderVariable variable = { words[1], name, location };
+            if (storage == "in") info.inputs.push_back(variable);
+            else if (storage == "out") info.outputs.push_back(variable);
+            else info.uniforms.push_back(variable);
+        }
+    }
+    return info;
+}
+
+void writeVariables(std::ostringstream& out, const char* name, const std::vector<ShaderVariable>& variables) {
+    out << "  \"" << name << "\": [";
+    for (size_t i = 0; i < variables.size(); i++) {
+        out << (i ? ", " : "") << "{\"name\": \"" << variables[i].name << "\", \"type\": \"" << variables[i].type << "\"";
+        if (variables[i].location >= 0) out << ", \"location\": " << variables[i].location;
+        out << "}";
+    }
+    out << "]";
+}
+
+bool writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(contents.data(), contents.size())) {
+        std::cerr << "AssetCooker: failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+AssetCooker::AssetCooker(const Settings& settings)
+    : m_settings(settings)
+{
+}
+
+AssetCooker::Kind AssetCooker::classify(const std::string& path) {
+    if (hasExtension(path, ".obj") || hasExtension(path, ".glb") || hasExtension(path, ".gltf")) return Kind::Mesh;
+    if (hasExtension(path, ".tga") || hasExtension(path, ".ppm")) return Kind::Texture;
+    if (hasExtension(path, ".vert") || hasExtension(path, ".frag") || hasExtension(path, ".comp")) return Kind::Shader;
+    return Kind::Copy;
+}
+
+std::vector<std::string> AssetCooker::outputsFor(const std::string& path, Kind kind) {
+    switch (kind) {
+    case Kind::Mesh: return { replaceExtension(path, ".agl") };
+    case Kind::Texture: return { replaceExtension(path, ".dds") };
+    case Kind::Shader: return { path, path + ".meta" };
+    case Kind::Copy: break;
+    }
+    return { path };
+}
+
+bool AssetCooker::run() {
+    auto start = std::chrono::steady_clock::now();
+    m_stats = Stats();
+
+    std::error_code error;
+    fs::path sourceRoot = fs::weakly_canonical(m_settings.sourceDir, error);
+    if (error || !fs::is_directory(sourceRoot)) {
+        std::cerr << "AssetCooker: source directory not found: " << m_settings.sourceDir << std::endl;
+        return false;
+    }
+    fs::create_directories(m_settings.outputDir, error);
+    fs::path outputRoot = fs::weakly_canonical(m_settings.outputDir, error);
+    if (error) {
+        std::cerr << "AssetCooker: cannot create output directory: " << m_settings.outputDir << std::endl;
+        return false;
+    }
+
+    // Gather inputs, skipping the output tree if it lives inside the source tree
+    std::vector<Job> jobs;
+    for (auto it = fs::recursive_directory_iterator(sourceRoot); it != fs::recursive_directory_iterator(); ++it) {
+        if (it->is_directory() && it->path() == outputRoot) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file()) continue;
+
+        Job job;
+        job.path = fs::relative(it->path(), sourceRoot).generic_string();
+        job.kind = classify(job.path);
+        job.hash = 0;
+        job.cooked = false;
+        job.failed = false;
+        job.bytes = 0;
+        jobs.push_back(job);
+    }
+    std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.path < b.path; });
+
+    // Directories up front so workers never race to create them
+    for (const auto& job : jobs) {
+        fs::create_directories((outputRoot / job.path).parent_path(), error);
+    }
+
+    if (!m_settings.force) loadManifest();
+
+    // ThreadPool(0) sizes itself to the hardware, so a single thread runs inline
+    if (m_settings.threads == 1) {
+        for (auto& job : jobs) processJob(job);
+    } else {
+        ThreadPool pool(m_settings.threads > 0 ? m_settings.threads - 1 : 0);
+        pool.parallelFor(static_cast<int>(jobs.size()), [this, &jobs](int i) {
+            processJob(jobs[i]);
+        });
+    }
+
+    for (const auto& job : jobs) {
+        m_stats.inputBytes += job.bytes;
+        if (job.failed) {
+            m_stats.failed++;
+        } else if (job.cooked) {
+            m_stats.cooked++;
+            m_stats.cookedBytes += job.bytes;
+        } else {
+            m_stats.skipped++;
+        }
+    }
+
+    bool saved = saveManifest(jobs);
+    m_stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return saved && m_stats.failed == 0;
+}
+
+void AssetCooker::processJob(Job& job) const {
+    const std::string source = (fs::path(m_settings.sourceDir) / job.path).string();
+    const std::vector<std::string> outputs = outputsFor(job.path, job.kind);
+    const std::string output = (fs::path(m_settings.outputDir) / outputs[0]).string();
+
+    // Empty files cannot be mapped; they hash to the seed and are copied
+    MappedFile file;
+    std::error_code error;
+    bool empty = fs::file_size(source, error) == 0 && !error;
+    if (!empty && !file.open(source)) {
+        job.failed = true;
+        return;
+    }
+    job.bytes = file.getSize();
+
+    const uint32_t seed[2] = { VERSION, static_cast<uint32_t>(job.kind) };
+    job.hash = hashBytes(FNV_OFFSET, reinterpret_cast<const unsigned char*>(seed), sizeof(seed));
+    job.hash = hashBytes(job.hash, file.getData(), file.getSize());
+
+    auto cached = m_manifest.find(job.path);
+    if (cached != m_manifest.end() && cached->second == job.hash) {
+        bool present = true;
+        for (const auto& name : outputs) {
+            present = present && fs::exists(fs::path(m_settings.outputDir) / name);
+        }
+        if (present) return;
+    }
+
+    bool ok = false;
+    if (empty) {
+        ok = writeFile(output, std::string());
+    } else {
+        switch (job.kind) {
+        case Kind::Mesh:
+            ok = cookMesh(source, output);
+            break;
+        case Kind::Texture:
+            ok = cookTexture(source, output);
+            break;
+        case Kind::Shader:
+            ok = cookShader(source, output, reinterpret_cast<const char*>(file.getData()), file.getSize());
+            break;
+        case Kind::Copy:
+            ok = writeFile(output, std::string(reinterpret_cast<const char*>(file.getData()), file.getSize()));
+            break;
+        }
+    }
+
+    job.cooked = ok;
+    job.failed = !ok;
+    if (m_settings.verbose) {
+        std::cout << (ok ? "cooked " : "FAILED ") << job.path << std::endl;
+    }
+}
+
+bool AssetCooker::cookMesh(const std::string& source, const std::string& output) const {
+    // Files are already spread over the pool, so glTF accessors decode serially
+    std::vector<Mesh> meshes;
+    GltfImporter gltf;
+    bool imported = hasExtension(source, ".obj") ? ObjImporter::import(source, meshes) : gltf.load(source, meshes);
+    if (!imported) return false;
+
+    // Texture references follow the textures into the output tree, under their cooked names
+    const fs::path sourceRoot = fs::absolute(m_settings.sourceDir).lexically_normal();
+    for (auto& mesh : meshes) {
+        mesh.generateLods();
+
+        std::vector<Texture> textures = mesh.getTextures();
+        for (auto& texture : textures) {
+            if (texture.path.find('#') != std::string::npos) continue;
+            fs::path relative = fs::absolute(texture.path).lexically_normal().lexically_relative(sourceRoot);
+            if (relative.empty() || *relative.begin() == "..") continue;
+
+            std::string path = relative.generic_string();
+            if (classify(path) == Kind::Texture) path = replaceExtension(path, ".dds");
+            texture.path = (fs::path(m_settings.outputDir) / path).generic_string();
+        }
+        mesh.setTextures(textures);
+    }
+    return LevelFile::writeMeshes(meshes, output);
+}
+
+bool AssetCooker::cookTexture(const std::string& source, const std::string& output) const {
+    TextureCompressor::Image image;
+    return TextureCompressor::loadImage(source, image) && TextureCompressor::writeDds(output, image);
+}
+
+bool AssetCooker::cookShader(const std::string& source, const std::string& output, const char* text, size_t size) const {
+    std::string stripped = stripShader(text, size);
+    ShaderInfo info = parseShader(stripped);
+    if (info.version.empty()) {
+        std::cerr << "AssetCooker: " << source << " has no #version" << std::endl;
+        return false;
+    }
+
+    const char* stage = hasExtension(source, ".vert") ? "vertex" : hasExtension(source, ".frag") ? "fragment" : "compute";
+    std::ostringstream meta;
+    meta << "{\n"
+         << "  \"stage\": \"" << stage << "\",\n"
+         << "  \"version\": \"" << info.version << "\",\n";
+    writeVariables(meta, "inputs", info.inputs);
+    meta << ",\n";
+    writeVariables(meta, "outputs", info.outputs);
+    meta << ",\n";
+    writeVariables(meta, "uniforms", info.uniforms);
+    meta << ",\n  \"blocks\": [";
+    for (size_t i = 0; i < info.blocks.size(); i++) {
+        meta << (i ? ", " : "") << "\"" << info.blocks[i] << "\"";
+    }
+    meta << "]\n}\n";
+
+    return writeFile(output, stripped) && writeFile(output + ".meta", meta.str());
+}
+
+std::string AssetCooker::manifestPath() const {
+    return (fs::path(m_settings.outputDir) / MANIFEST_NAME).string();
+}
+
+void AssetCooker::loadManifest() {
+    m_manifest.clear();
+    std::ifstream file(manifestPath());
+    std::string line;
+    while (std::getline(file, line)) {
+        // "<hash> <path>"; the path may contain spaces
+        size_t space = line.find(' ');
+        if (line.empty() || line[0] == '#' || space == std::string::npos) continue;
+        m_manifest[line.substr(space + 1)] = std::strtoull(line.substr(0, space).c_str(), nullptr, 16);
+    }
+}
+
+bool AssetCooker::saveManifest(const std::vector<Job>& jobs) const {
+    std::ostringstream out;
+    out << "# asset-cooker " << VERSION << "\n";
+    for (const auto& job : jobs) {
+        if (job.failed) continue;
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(job.hash));
+        out << hash << " " << job.path << "\n";
+    }
+    return writeFile(manifestPath(), out.str());
+}
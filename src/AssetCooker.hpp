@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Offline asset pipeline: mirrors a source tree into an output tree, converting
+//  - meshes (.obj, .glb, .gltf) to the binary level format with LODs (.agl),
+//    referencing their textures by cooked name
+//  - textures (.tga, .ppm) to BC1 DDS with mip chains (.dds), which the game
+//    loads with TextureLoader
+//  - shaders (.vert, .frag, .comp) to comment-stripped sources plus a .meta JSON
+//    listing their version, inputs, outputs, uniforms and uniform blocks
+// and copying everything else. Files are processed in parallel on a thread pool.
+// A manifest of content hashes in the output tree skips inputs that have not
+// changed since they were last cooked.
+class AssetCooker {
+public:
+    struct Settings {
+        std::string sourceDir;
+        std::string outputDir;
+        unsigned int threads = 0;      // 0 = one per hardware thread
+        bool force = false;            // Ignore the manifest
+        bool verbose = false;
+    };
+
+    struct Stats {
+        int cooked = 0;
+        int skipped = 0;
+        int failed = 0;
+        size_t inputBytes = 0;          // Read and hashed
+        size_t cookedBytes = 0;         // Inputs that were converted
+        double seconds = 0.0;
+    };
+
+    // Bump when any conversion changes its output
+    static const uint32_t VERSION = 2;
+
+    explicit AssetCooker(const Settings& settings);
+
+    // Returns false if any asset failed to cook
+    bool run();
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    enum class Kind { Mesh, Texture, Shader, Copy };
+
+    struct Job {
+        std::string path;               // Relative to the source directory, '/' separated
+        Kind kind;
+        uint64_t hash;
+        bool cooked;
+        bool failed;
+        size_t bytes;
+    };
+
+    Settings m_settings;
+    Stats m_stats;
+    std::map<std::string, uint64_t> m_manifest;
+
+    static Kind classify(const std::string& path);
+    static std::vector<std::string> outputsFor(const std::string& path, Kind kind);
+
+    void processJob(Job& job) const;
+    bool cookMesh(const std::string& source, const std::string& output) const;
+    bool cookTexture(const std::string& source, const std::string& output) const;
+    bool cookShader(const std::string& source, const std::string& output, const char* text, size_t size) const;
+
+    std::string manifestPath() const;
+    void loadManifest();
+    bool saveManifest(const std::vector<Job>& jobs) const;
+};
@@ -0,0 +1,44 @@
+#include "AssetCooker.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Cooks a source asset tree into runtime formats:
+//   asset-cooker <source> <output> [--threads N] [--force] [--verbose]
+int main(int argc, char** argv) {
+    AssetCooker::Settings settings;
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            settings.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--force") == 0) {
+            settings.force = true;
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            settings.verbose = true;
+        } else if (argv[i][0] != '-' && positional == 0) {
+            settings.sourceDir = argv[i];
+            positional++;
+        } else if (argv[i][0] != '-' && positional == 1) {
+            settings.outputDir = argv[i];
+            positional++;
+        } else {
+            positional = -1;
+            break;
+        }
+    }
+    if (positional != 2) {
+        std::cerr << "Usage: " << argv[0] << " <source> <output> [--threads N] [--force] [--verbose]" << std::endl;
+        return 1;
+    }
+
+    AssetCooker cooker(settings);
+    bool ok = cooker.run();
+
+    const AssetCooker::Stats& stats = cooker.getStats();
+    const double megabytes = stats.inputBytes / (1024.0 * 1024.0);
+    std::cout << "asset-cooker: " << stats.cooked << " cooked, " << stats.skipped << " up to date, "
+              << stats.failed << " failed (" << megabytes << " MB in " << stats.seconds << " s";
+    if (stats.seconds > 0.0) std::cout << ", " << megabytes / stats.seconds << " MB/s";
+    std::cout << ")" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,562 @@
+#include "Benchmark.hpp"
+#include "AllocationCounter.hpp"
+#include "BvhRaycaster.hpp"
+#include "FrameArena.hpp"
+#include "Framebuffer.hpp"
+#include "GpuTimer.hpp"
+#include "Level.hpp"
+#include "MemoryTracker.hpp"
+#include "ParticleSystem.hpp"
+#include "Random.hpp"
+#include "Renderer.hpp"
+#include "SpatialHashGrid.hpp"
+#include "ThreadPool.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const float EYE_HEIGHT = 1.7f;
+
+// Simulated shooters: fixed time step and SMG cadence; every fourth hit leaves blood
+const float SIMULATION_STEP = 1.0f / 60.0f;
+const float SHOT_INTERVAL = 1.0f / 12.0f;
+const float MAX_SHOT_DISTANCE = 50.0f;
+const int BLOOD_INTERVAL = 4;
+
+// Characters run laps of this radius around the room centers
+const float CHARACTER_LAP_RADIUS = 1.2f;
+const float CHARACTER_SPEED = 3.5f;
+
+// Broadphase entities: players, projectiles and pickups in turn, spread at a fixed
+// density so the work per query does not depend on the count. Every entity looks
+// for neighbours within ENTITY_QUERY_RADIUS each step, in batches per thread.
+const float ENTITY_DENSITY = 0.25f;      // Per square meter
+const float ENTITY_QUERY_RADIUS = 1.5f;
+const int ENTITY_QUERY_BATCH = 256;
+const int ENTITY_MAX_NEIGHBOURS = 32;    // Per query, on average over a batch
+const glm::vec3 ENTITY_HALF_EXTENTS[3] = { glm::vec3(0.3f, 0.9f, 0.3f), glm::vec3(0.05f), glm::vec3(0.25f) };
+const float ENTITY_SPEEDS[3] = { 4.0f, 30.0f, 0.5f };
+
+struct Entity {
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 halfExtent;
+    uint32_t proxy;
+};
+
+// Rays fan out from each room's eye point, the way sight checks and spread
+// weapons cast them; batches keep neighbouring directions in the same packets
+const int RAY_BATCH = 1024;
+const float RAY_DISTANCE = 50.0f;
+
+// Nearest-rank percentile of an unsorted sample set
+double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    return samples[std::min(std::max(rank, size_t(1)), samples.size()) - 1];
+}
+
+void writeStats(std::ostringstream& out, const char* name, const std::vector<double>& samples) {
+    double sum = 0.0;
+    double maxValue = 0.0;
+    for (double s : samples) {
+        sum += s;
+        maxValue = std::max(maxValue, s);
+    }
+
+    out << "  \"" << name << "\": {"
+        << "\"samples\": " << samples.size()
+        << ", \"mean\": " << (samples.empty() ? 0.0 : sum / samples.size())
+        << ", \"p50\": " << percentile(samples, 50.0)
+        << ", \"p95\": " << percentile(samples, 95.0)
+        << ", \"p99\": " << percentile(samples, 99.0)
+        << ", \"max\": " << maxValue
+        << "}";
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+}
+
+// Shooters stand in the rooms and fire towards the next one
+class ShooterLoad {
+public:
+    ShooterLoad(Renderer& renderer, const std::vector<glm::vec3>& path, int shooters)
+        : m_path(path)
+        , m_particles(renderer.getParticles())
+        , m_decals(renderer.getDecals())
+    {
+        for (int i = 0; m_particles && i < shooters; i++) {
+            m_emitters.push_back(m_particles->createEmitter(ParticleSystem::EmitterSettings()));
+        }
+    }
+
+    void run(int frame, Level& level, ThreadPool& threadPool) {
+        for (size_t i = 0; i < m_emitters.size(); i++) {
+            // Staggered so shots spread over the interval
+            float time = frame * SIMULATION_STEP + SHOT_INTERVAL * i / m_emitters.size();
+            if (std::fmod(time, SHOT_INTERVAL) >= SIMULATION_STEP) continue;
+
+            const glm::vec3& from = m_path[i % m_path.size()];
+            const glm::vec3& to = m_path[(i + 1) % m_path.size()];
+            // Spray slightly around the line towards the next room
+            float sway = std::sin(time * 3.0f + i);
+            glm::vec3 direction = glm::normalize(to - from + glm::vec3(sway, 0.3f * sway - 0.4f, 0.0f));
+            glm::vec3 muzzle = from + glm::vec3(0.0f, -0.2f, 0.0f) + direction * 0.5f;
+            m_particles->emit(m_emitters[i], ParticleEffect::muzzleFlash(), muzzle, direction);
+            m_particles->emit(m_emitters[i], ParticleEffect::muzzleSparks(), muzzle, direction);
+
+            Level::RaycastHit hit;
+            if (level.raycast(muzzle, direction, MAX_SHOT_DISTANCE, hit)) {
+                m_particles->emit(m_emitters[i], ParticleEffect::impactSparks(), hit.point, hit.normal);
+                m_particles->emit(m_emitters[i], ParticleEffect::impactDust(), hit.point, hit.normal);
+                DecalType type = ++m_shots % BLOOD_INTERVAL == 0 ? DecalType::Blood : DecalType::BulletHole;
+                if (m_decals) m_decals->spawn(level, hit.surface, hit.point, hit.normal, type);
+            }
+        }
+        if (m_particles) {
+            m_particles->update(SIMULATION_STEP, &threadPool);
+        }
+    }
+
+private:
+    const std::vector<glm::vec3>& m_path;
+    ParticleSystem* m_particles;
+    DecalSystem* m_decals;
+    std::vector<int> m_emitters;
+    int m_shots = 0;
+};
+
+// Character i runs around room i % rooms, spread over the lap
+class CharacterLoad {
+public:
+    CharacterLoad(Renderer& renderer, const std::vector<glm::vec3>& path, int count)
+        : m_path(path)
+        , m_characters(renderer.getCharacters())
+        , m_count(m_characters ? count : 0)
+    {
+        if (m_characters) m_characters->clear();
+        for (int i = 0; i < m_count; i++) {
+            glm::vec3 color(0.4f + 0.6f * ((i * 37) % 11) / 10.0f, 0.4f + 0.6f * ((i * 53) % 7) / 6.0f, 0.6f);
+            m_characters->addCharacter(glm::vec3(0.0f), 0.0f, color);
+        }
+    }
+
+    // Returns the animation update time in milliseconds
+    double run(int frame, ThreadPool& threadPool) {
+        if (m_count == 0) return 0.0;
+
+        float time = frame * SIMULATION_STEP;
+        for (int i = 0; i < m_count; i++) {
+            const glm::vec3& center = m_path[i % m_path.size()];
+            float lapRadius = CHARACTER_LAP_RADIUS * (0.5f + 0.5f * ((i / m_path.size()) % 3) / 2.0f);
+            float angle = time * CHARACTER_SPEED / lapRadius + i * 0.9f;
+            glm::vec3 position(center.x + std::cos(angle) * lapRadius, 0.0f, center.z + std::sin(angle) * lapRadius);
+
+            // Every fifth character stands still to exercise the idle blend
+            float speed = i % 5 == 0 ? 0.0f : CHARACTER_SPEED;
+            m_characters->setCharacterState(i, position, -angle, speed);
+        }
+
+        auto animationStart = std::chrono::steady_clock::now();
+        m_characters->update(SIMULATION_STEP, &threadPool);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - animationStart).count();
+    }
+
+private:
+    const std::vector<glm::vec3>& m_path;
+    CharacterSystem* m_characters;
+    int m_count;
+};
+
+struct BroadphaseTiming {
+    double updateMs = 0.0;
+    double queryMs = 0.0;
+    uint64_t hits = 0;
+};
+
+// Entities start anywhere in a square around the rooms and bounce off its sides
+class EntityLoad {
+public:
+    EntityLoad(const std::vector<glm::vec3>& path, int count)
+        : m_entities(count)
+        , m_batches((count + ENTITY_QUERY_BATCH - 1) / ENTITY_QUERY_BATCH)
+        , m_queries(count)
+        , m_ranges(count)
+        , m_neighbours(static_cast<size_t>(count) * ENTITY_MAX_NEIGHBOURS)
+        , m_batchHits(m_batches)
+    {
+        glm::vec3 roomsMin = path[0];
+        glm::vec3 roomsMax = path[0];
+        for (const glm::vec3& point : path) {
+            roomsMin = glm::min(roomsMin, point);
+            roomsMax = glm::max(roomsMax, point);
+        }
+        m_areaCenter = (roomsMin + roomsMax) * 0.5f;
+        m_areaHalfSize = 0.5f * std::max(std::max(roomsMax.x - roomsMin.x, roomsMax.z - roomsMin.z),
+                                         std::sqrt(count / ENTITY_DENSITY));
+
+        unsigned int random = 0x9E3779B9u;
+        for (int i = 0; i < count; i++) {
+            Entity& entity = m_entities[i];
+            float x = (random01(random) * 2.0f - 1.0f) * m_areaHalfSize;
+            float z = (random01(random) * 2.0f - 1.0f) * m_areaHalfSize;
+            float heading = random01(random) * 6.2831853f;
+            entity.halfExtent = ENTITY_HALF_EXTENTS[i % 3];
+            entity.position = glm::vec3(m_areaCenter.x + x, entity.halfExtent.y, m_areaCenter.z + z);
+            entity.velocity = glm::vec3(std::cos(heading), 0.0f, std::sin(heading)) * ENTITY_SPEEDS[i % 3];
+            entity.proxy = m_grid.insert(static_cast<uint32_t>(i), entity.position - entity.halfExtent,
+                                         entity.position + entity.halfExtent);
+        }
+    }
+
+    BroadphaseTiming run(ThreadPool& threadPool) {
+        BroadphaseTiming timing;
+        if (m_entities.empty()) return timing;
+
+        auto updateStart = std::chrono::steady_clock::now();
+        for (Entity& entity : m_entities) {
+            entity.position += entity.velocity * SIMULATION_STEP;
+            glm::vec3 offset = entity.position - m_areaCenter;
+            if (std::fabs(offset.x) > m_areaHalfSize) entity.velocity.x = std::copysign(entity.velocity.x, -offset.x);
+            if (std::fabs(offset.z) > m_areaHalfSize) entity.velocity.z = std::copysign(entity.velocity.z, -offset.z);
+            m_grid.update(entity.proxy, entity.position - entity.halfExtent, entity.position + entity.halfExtent);
+        }
+        auto queryStart = std::chrono::steady_clock::now();
+
+        // Each batch writes into its own slice of the neighbour buffer
+        threadPool.parallelFor(m_batches, [&](int batch) {
+            size_t begin = static_cast<size_t>(batch) * ENTITY_QUERY_BATCH;
+            size_t count = std::min(m_entities.size() - begin, static_cast<size_t>(ENTITY_QUERY_BATCH));
+            for (size_t i = begin; i < begin + count; i++) {
+                m_queries[i].center = m_entities[i].position;
+                m_queries[i].radius = ENTITY_QUERY_RADIUS;
+            }
+            m_batchHits[batch] = m_grid.queryRadii(&m_queries[begin], count,
+                                                   &m_neighbours[begin * ENTITY_MAX_NEIGHBOURS],
+                                                   count * ENTITY_MAX_NEIGHBOURS, &m_ranges[begin]);
+        });
+        auto queryEnd = std::chrono::steady_clock::now();
+
+        for (uint64_t hits : m_batchHits) {
+            timing.hits += hits;
+        }
+        timing.updateMs = std::chrono::duration<double, std::milli>(queryStart - updateStart).count();
+        timing.queryMs = std::chrono::duration<double, std::milli>(queryEnd - queryStart).count();
+        return timing;
+    }
+
+private:
+    SpatialHashGrid m_grid;
+    std::vector<Entity> m_entities;
+    glm::vec3 m_areaCenter;
+    float m_areaHalfSize;
+    int m_batches;
+    std::vector<SpatialHashGrid::Sphere> m_queries;
+    std::vector<SpatialHashGrid::QueryRange> m_ranges;
+    std::vector<uint32_t> m_neighbours;
+    std::vector<uint64_t> m_batchHits;
+};
+
+// Summed over the batches, so the rates are per core however many threads ran
+struct RaycastTiming {
+    double closestSeconds = 0.0;
+    double anySeconds = 0.0;
+};
+
+class RaycastLoad {
+public:
+    RaycastLoad(const CollisionBvh& bvh, const std::vector<glm::vec3>& path, int count)
+        : m_raycaster(bvh)
+        , m_rays(count)
+        , m_hits(count)
+        , m_batches((count + RAY_BATCH - 1) / RAY_BATCH)
+        , m_closestSeconds(m_batches)
+        , m_anySeconds(m_batches)
+    {
+        int raysPerRoom = (count + static_cast<int>(path.size()) - 1) / static_cast<int>(path.size());
+        for (int i = 0; i < count; i++) {
+            int ray = i % raysPerRoom;
+            float yaw = 6.2831853f * ray / raysPerRoom;
+            float pitch = 0.4f * std::sin(ray * 0.37f);
+            glm::vec3 direction(std::cos(yaw) * std::cos(pitch), std::sin(pitch), std::sin(yaw) * std::cos(pitch));
+            m_rays[i] = BvhRaycaster::Ray{ path[i / raysPerRoom], direction, RAY_DISTANCE };
+        }
+    }
+
+    RaycastTiming run(ThreadPool& threadPool) {
+        RaycastTiming timing;
+        if (m_batches == 0) return timing;
+
+        // Each batch times itself
+        threadPool.parallelFor(m_batches, [&](int batch) {
+            size_t begin = static_cast<size_t>(batch) * RAY_BATCH;
+            size_t count = std::min(m_rays.size() - begin, static_cast<size_t>(RAY_BATCH));
+            auto closestStart = std::chrono::steady_clock::now();
+            m_raycaster.cast(&m_rays[begin], count, BvhRaycaster::Mode::ClosestHit, &m_hits[begin]);
+            auto anyStart = std::chrono::steady_clock::now();
+            m_raycaster.cast(&m_rays[begin], count, BvhRaycaster::Mode::AnyHit, &m_hits[begin]);
+            auto anyEnd = std::chrono::steady_clock::now();
+            m_closestSeconds[batch] = std::chrono::duration<double>(anyStart - closestStart).count();
+            m_anySeconds[batch] = std::chrono::duration<double>(anyEnd - anyStart).count();
+        });
+
+        for (int i = 0; i < m_batches; i++) {
+            timing.closestSeconds += m_closestSeconds[i];
+            timing.anySeconds += m_anySeconds[i];
+        }
+        return timing;
+    }
+
+private:
+    BvhRaycaster m_raycaster;
+    std::vector<BvhRaycaster::Ray> m_rays;
+    std::vector<BvhRaycaster::Hit> m_hits;
+    int m_batches;
+    std::vector<double> m_closestSeconds;
+    std::vector<double> m_anySeconds;
+};
+
+} // namespace
+
+Benchmark::Benchmark(const Settings& settings)
+    : m_settings(settings)
+{
+}
+
+bool Benchmark::run(Renderer& renderer, Level& level) {
+    // Closed loop through every room at eye height
+    m_path.clear();
+    for (const auto& center : level.getRoomCenters()) {
+        m_path.push_back(glm::vec3(center.x, EYE_HEIGHT, center.z));
+    }
+    if (m_path.size() < 2) {
+        std::cerr << "Benchmark: level has no camera path" << std::endl;
+        return false;
+    }
+
+    const GLubyte* rendererName = glGetString(GL_RENDERER);
+    m_rendererName = rendererName ? reinterpret_cast<const char*>(rendererName) : "unknown";
+
+    Framebuffer target(m_settings.width, m_settings.height);
+    if (!target.isComplete()) {
+        std::cerr << "Benchmark: failed to create offscreen target" << std::endl;
+        return false;
+    }
+
+    // Fixed resolution keeps runs comparable
+    GpuTimer gpuTimer;
+    renderer.resize(m_settings.width, m_settings.height);
+    renderer.setDynamicResolution(false);
+    renderer.setRenderScale(1.0f);
+    prepareLevel(renderer, level);
+
+    ThreadPool threadPool;
+    ShooterLoad shooters(renderer, m_path, m_settings.shooters);
+    CharacterLoad characters(renderer, m_path, m_settings.characters);
+    EntityLoad entities(m_path, m_settings.entities);
+    RaycastLoad raycasts(level.getCollisionBvh(), m_path, m_settings.rays);
+
+    resetSamples();
+
+    const int totalFrames = m_settings.warmupFrames + m_settings.frames;
+    AllocationCounter::Snapshot heapStart;
+    auto runStart = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < totalFrames; frame++) {
+        if (frame == m_settings.warmupFrames) heapStart = AllocationCounter::get();
+        FrameArena::beginFrame();
+        auto cpuStart = std::chrono::steady_clock::now();
+
+        Camera camera = cameraAt(static_cast<float>(frame) / totalFrames);
+        renderer.setCamera(&camera);
+
+        shooters.run(frame, level, threadPool);
+        double animationMs = characters.run(frame, threadPool);
+        BroadphaseTiming broadphase = entities.run(threadPool);
+        RaycastTiming raycast = raycasts.run(threadPool);
+
+        gpuTimer.begin();
+        renderer.beginFrame();
+        renderer.clear();
+        renderer.endFrame(&target);
+        gpuTimer.end();
+
+        auto cpuEnd = std::chrono::steady_clock::now();
+
+        // Drain the frame so every sample is independent of queueing
+        glFinish();
+        double gpuMs = 0.0;
+        bool hasGpuTime = gpuTimer.wait(gpuMs);
+
+        if (frame >= m_settings.warmupFrames) {
+            m_cpuTimes.push_back(std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count());
+            if (hasGpuTime) m_gpuTimes.push_back(gpuMs);
+            if (m_settings.characters > 0) m_animationTimes.push_back(animationMs);
+            if (m_settings.entities > 0) {
+                m_broadphaseUpdateTimes.push_back(broadphase.updateMs);
+                m_broadphaseQueryTimes.push_back(broadphase.queryMs);
+                m_broadphaseHits += broadphase.hits;
+            }
+            m_closestRaySeconds += raycast.closestSeconds;
+            m_anyRaySeconds += raycast.anySeconds;
+        }
+    }
+
+    // Steady state: heap traffic of the measured frames only
+    m_heapPerFrame = AllocationCounter::get() - heapStart;
+    m_arenaPeak = FrameArena::current().getPeak();
+
+    // Per-subsystem totals at the end of the run
+    MemoryTracker::update(std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count());
+    for (int i = 0; i < static_cast<int>(MemoryTag::Count); i++) {
+        m_memory[i] = MemoryTracker::getStats(static_cast<MemoryTag>(i));
+    }
+
+    target.unbind();
+    renderer.setCamera(nullptr);
+    return true;
+}
+
+void Benchmark::prepareLevel(Renderer& renderer, Level& level) {
+    if (renderer.wantsStaticBatch()) {
+        level.buildStaticBatch();
+    }
+    renderer.setStaticMeshes(level.getMeshes(), level.getStaticBatch());
+    m_gpuDriven = renderer.isGpuDriven();
+    level.setMeshResidency(m_settings.retainMeshData ? MeshResidency::Both : MeshResidency::GpuOnly);
+
+    // Measure rendering, not streaming
+    level.queueUploads(*renderer.getUploadQueue());
+    renderer.getUploadQueue()->flush();
+    m_meshMemory = level.getMemoryStats();
+    m_modelLoading = level.getModelLoadStats();
+}
+
+void Benchmark::resetSamples() {
+    m_cpuTimes.clear();
+    m_gpuTimes.clear();
+    m_animationTimes.clear();
+    m_broadphaseUpdateTimes.clear();
+    m_broadphaseQueryTimes.clear();
+    m_broadphaseHits = 0;
+    m_closestRaySeconds = 0.0;
+    m_anyRaySeconds = 0.0;
+    m_cpuTimes.reserve(m_settings.frames);
+    m_gpuTimes.reserve(m_settings.frames);
+    m_animationTimes.reserve(m_settings.frames);
+    m_broadphaseUpdateTimes.reserve(m_settings.frames);
+    m_broadphaseQueryTimes.reserve(m_settings.frames);
+}
+
+Camera Benchmark::cameraAt(float t) const {
+    // Uniform Catmull-Rom spline over the looped room path
+    const int count = static_cast<int>(m_path.size());
+    float segment = t * count;
+    int i = static_cast<int>(segment);
+    float u = segment - i;
+
+    const glm::vec3& p0 = m_path[(i + count - 1) % count];
+    const glm::vec3& p1 = m_path[i % count];
+    const glm::vec3& p2 = m_path[(i + 1) % count];
+    const glm::vec3& p3 = m_path[(i + 2) % count];
+
+    glm::vec3 position = 0.5f * ((2.0f * p1) +
+                                 (-p0 + p2) * u +
+                                 (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u * u +
+                                 (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * u * u * u);
+    glm::vec3 tangent = 0.5f * ((-p0 + p2) +
+                                2.0f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u +
+                                3.0f * (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * u * u);
+
+    float yaw = glm::degrees(std::atan2(tangent.z, tangent.x));
+    float pitch = 10.0f * std::sin(t * 6.2831853f * 4.0f);
+    return Camera(position, glm::vec3(0.0f, 1.0f, 0.0f), yaw, pitch);
+}
+
+std::string Benchmark::toJson() const {
+    auto perFrame = [this](uint64_t total) {
+        return m_settings.frames > 0 ? static_cast<double>(total) / m_settings.frames : 0.0;
+    };
+    auto megaRaysPerSecond = [this](double seconds) {
+        return seconds > 0.0 ? static_cast<double>(m_settings.rays) * m_settings.frames / seconds * 1e-6 : 0.0;
+    };
+
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"renderer\": \"" << escapeJson(m_rendererName) << "\",\n"
+        << "  \"gpu_driven\": " << (m_gpuDriven ? "true" : "false") << ",\n"
+        << "  \"width\": " << m_settings.width << ",\n"
+        << "  \"height\": " << m_settings.height << ",\n"
+        << "  \"warmup_frames\": " << m_settings.warmupFrames << ",\n"
+        << "  \"frames\": " << m_settings.frames << ",\n"
+        << "  \"shooters\": " << m_settings.shooters << ",\n"
+        << "  \"characters\": " << m_settings.characters << ",\n"
+        << "  \"entities\": " << m_settings.entities << ",\n"
+        << "  \"broadphase\": {\"hits_per_frame\": " << perFrame(m_broadphaseHits) << "},\n"
+        << "  \"raycast\": {\"rays_per_frame\": " << m_settings.rays
+        << ", \"packet_width\": " << BvhRaycaster::PACKET_WIDTH
+        << ", \"closest_hit_mrays_per_core\": " << megaRaysPerSecond(m_closestRaySeconds)
+        << ", \"any_hit_mrays_per_core\": " << megaRaysPerSecond(m_anyRaySeconds) << "},\n"
+        << "  \"mesh_memory\": {\"cpu_bytes\": " << m_meshMemory.cpuBytes
+        << ", \"gpu_bytes\": " << m_meshMemory.gpuBytes
+        << ", \"collision_bytes\": " << m_meshMemory.collisionBytes
+        << ", \"released_bytes\": " << m_meshMemory.releasedBytes << "},\n"
+        << "  \"model_loading\": {\"files\": " << m_modelLoading.files
+        << ", \"bytes\": " << m_modelLoading.bytes
+        << ", \"seconds\": " << m_modelLoading.seconds
+        << ", \"mb_per_s\": " << m_modelLoading.getMegabytesPerSecond() << "},\n"
+        << "  \"heap\": {\"allocations_per_frame\": " << perFrame(m_heapPerFrame.allocations)
+        << ", \"bytes_per_frame\": " << perFrame(m_heapPerFrame.bytes)
+        << ", \"frame_arena_peak_bytes\": " << m_arenaPeak << "},\n"
+        << "  \"memory\": {";
+    for (int i = 0; i < static_cast<int>(MemoryTag::Count); i++) {
+        const MemoryTracker::TagStats& stats = m_memory[i];
+        out << (i > 0 ? ", " : "") << "\"" << MemoryTracker::getTagName(static_cast<MemoryTag>(i)) << "\": "
+            << "{\"live_bytes\": " << stats.liveBytes
+            << ", \"peak_bytes\": " << stats.peakBytes
+            << ", \"allocations\": " << stats.allocations
+            << ", \"gpu_bytes\": " << stats.gpuBytes
+            << ", \"gpu_peak_bytes\": " << stats.gpuPeakBytes << "}";
+    }
+    out << "},\n";
+    writeStats(out, "cpu_ms", m_cpuTimes);
+    out << ",\n";
+    writeStats(out, "gpu_ms", m_gpuTimes);
+    out << ",\n";
+    writeStats(out, "animation_ms", m_animationTimes);
+    out << ",\n";
+    writeStats(out, "broadphase_update_ms", m_broadphaseUpdateTimes);
+    out << ",\n";
+    writeStats(out, "broadphase_query_ms", m_broadphaseQueryTimes);
+    out << "\n}\n";
+    return out.str();
+}
+
+bool Benchmark::writeResults() const {
+    std::string json = toJson();
+
+    if (m_settings.outputPath.empty()) {
+        std::cout << json;
+        return true;
+    }
+
+    std::ofstream file(m_settings.outputPath);
+    if (!file) {
+        std::cerr << "Failed to write benchmark results: " << m_settings.outputPath << std::endl;
+        return false;
+    }
+    file << json;
+    return true;
+}
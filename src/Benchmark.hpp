@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "AllocationCounter.hpp"
+#include "Camera.hpp"
+#include "GltfImporter.hpp"
+#include "MemoryTracker.hpp"
+#include "Mesh.hpp"
+
+class Renderer;
+class Level;
+
+// Reproducible frame-time benchmark: flies a scripted camera through the level,
+// renders offscreen and reports CPU/GPU frame-time percentiles as JSON.
+class Benchmark {
+public:
+    struct Settings {
+        int width = 1280;
+        int height = 720;
+        int warmupFrames = 60;
+        int frames = 600;
+        int shooters = 0;           // Simulated players firing SMGs (particle load)
+        int characters = 0;         // Animated players running around the rooms
+        int entities = 0;           // Dynamic objects moving through the broadphase grid
+        int rays = 0;               // Rays cast per frame in each raycast mode
+        bool retainMeshData = false; // Keep CPU copies of uploaded level meshes
+        std::string outputPath;     // Empty = stdout
+    };
+
+    explicit Benchmark(const Settings& settings);
+
+    // Run the benchmark. Requires a current GL context; returns false on setup failure.
+    bool run(Renderer& renderer, Level& level);
+
+    // Results
+    std::string toJson() const;
+    bool writeResults() const;
+
+private:
+    Settings m_settings;
+    std::vector<glm::vec3> m_path;
+    std::vector<double> m_cpuTimes;
+    std::vector<double> m_gpuTimes;
+    std::vector<double> m_animationTimes;
+    std::vector<double> m_broadphaseUpdateTimes;
+    std::vector<double> m_broadphaseQueryTimes;
+    uint64_t m_broadphaseHits = 0;                  // Over the measured frames
+    double m_closestRaySeconds = 0.0;               // Summed over threads and measured frames
+    double m_anyRaySeconds = 0.0;
+    std::string m_rendererName;
+    MeshMemoryStats m_meshMemory;
+    GltfImporter::Stats m_modelLoading;
+    AllocationCounter::Snapshot m_heapPerFrame;     // Totals over the measured frames
+    size_t m_arenaPeak = 0;
+    MemoryTracker::TagStats m_memory[static_cast<int>(MemoryTag::Count)];
+    bool m_gpuDriven = false;
+
+    // Static batch, residency and uploads, so the measured frames only render
+    void prepareLevel(Renderer& renderer, Level& level);
+    void resetSamples();
+
+    // Camera on the looped path, t in [0, 1)
+    Camera cameraAt(float t) const;
+};
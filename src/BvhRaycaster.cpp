@@ -0,0 +1,358 @@
+#include "BvhRaycaster.hpp"
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/intersect.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RAYCAST_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAYCAST_SSE
+#endif
+
+namespace {
+
+const float MIN_DIRECTION = 1e-20f;     // Keeps inverse directions finite
+const float MIN_DETERMINANT = 1e-12f;   // Rays closer to parallel miss the triangle
+const float INFINITE_DISTANCE = std::numeric_limits<float>::infinity();
+
+using Node = CollisionBvh::Node;
+using Triangle = CollisionBvh::Triangle;
+
+float inverseComponent(float direction) {
+    return 1.0f / (std::fabs(direction) < MIN_DIRECTION ? std::copysign(MIN_DIRECTION, direction) : direction);
+}
+
+// Slab test; tNear is where the ray enters the box
+bool hitBox(const Node& node, const glm::vec3& origin, const glm::vec3& inverse, float tMax, float& tNear) {
+    glm::vec3 t0 = (node.boundsMin - origin) * inverse;
+    glm::vec3 t1 = (node.boundsMax - origin) * inverse;
+    glm::vec3 tSmall = glm::min(t0, t1);
+    glm::vec3 tLarge = glm::max(t0, t1);
+    tNear = std::max(std::max(tSmall.x, tSmall.y), std::max(tSmall.z, 0.0f));
+    float tFar = std::min(std::min(tLarge.x, tLarge.y), std::min(tLarge.z, tMax));
+    return tNear <= tFar;
+}
+
+#if defined(RAYCAST_AVX)
+typedef __m256 Lanes;
+inline Lanes splat(float value) { return _mm256_set1_ps(value); }
+inline Lanes load(const float* values) { return _mm256_loadu_ps(values); }
+inline void store(float* values, Lanes lanes) { _mm256_storeu_ps(values, lanes); }
+inline Lanes add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+inline Lanes divide(Lanes a, Lanes b) { return _mm256_div_ps(a, b); }
+inline Lanes lanesMin(Lanes a, Lanes b) { return _mm256_min_ps(a, b); }
+inline Lanes lanesMax(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+inline Lanes less(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline Lanes lessEqual(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline Lanes both(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+inline Lanes select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b, a, mask); }
+inline Lanes absolute(Lanes a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+inline int bits(Lanes mask) { return _mm256_movemask_ps(mask); }
+#elif defined(RAYCAST_SSE)
+typedef __m128 Lanes;
+inline Lanes splat(float value) { return _mm_set1_ps(value); }
+inline Lanes load(const float* values) { return _mm_loadu_ps(values); }
+inline void store(float* values, Lanes lanes) { _mm_storeu_ps(values, lanes); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+inline Lanes divide(Lanes a, Lanes b) { return _mm_div_ps(a, b); }
+inline Lanes lanesMin(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+inline Lanes lanesMax(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+inline Lanes less(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+inline Lanes lessEqual(Lanes a, Lanes b) { return _mm_cmple_ps(a, b); }
+inline Lanes both(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+inline Lanes select(Lanes mask, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline Lanes absolute(Lanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline int bits(Lanes mask) { return _mm_movemask_ps(mask); }
+#endif
+
+#if defined(RAYCAST_AVX) || defined(RAYCAST_SSE)
+const int WIDTH = BvhRaycaster::PACKET_WIDTH;
+
+// A packet's rays in lanes; padding lanes have tMax -1 and never hit anything
+struct Packet {
+    Lanes originX, originY, originZ;
+    Lanes directionX, directionY, directionZ;
+    Lanes inverseX, inverseY, inverseZ;
+    Lanes tMax;
+};
+
+// Mask of the lanes hitting the box; tNear is where each enters it
+inline Lanes hitBox(const Node& node, const Packet& packet, Lanes& tNear) {
+    Lanes x0 = mul(sub(splat(node.boundsMin.x), packet.originX), packet.inverseX);
+    Lanes x1 = mul(sub(splat(node.boundsMax.x), packet.originX), packet.inverseX);
+    Lanes y0 = mul(sub(splat(node.boundsMin.y), packet.originY), packet.inverseY);
+    Lanes y1 = mul(sub(splat(node.boundsMax.y), packet.originY), packet.inverseY);
+    Lanes z0 = mul(sub(splat(node.boundsMin.z), packet.originZ), packet.inverseZ);
+    Lanes z1 = mul(sub(splat(node.boundsMax.z), packet.originZ), packet.inverseZ);
+    tNear = lanesMax(lanesMax(lanesMin(x0, x1), lanesMin(y0, y1)), lanesMax(lanesMin(z0, z1), splat(0.0f)));
+    Lanes tFar = lanesMin(lanesMin(lanesMax(x0, x1), lanesMax(y0, y1)), lanesMin(lanesMax(z0, z1), packet.tMax));
+    return lessEqual(tNear, tFar);
+}
+
+// Double-sided Moller-Trumbore of one triangle against every lane
+inline Lanes hitTriangle(const Triangle& triangle, const Packet& packet, Lanes& t) {
+    glm::vec3 edge1 = triangle.v1 - triangle.v0;
+    glm::vec3 edge2 = triangle.v2 - triangle.v0;
+    Lanes e1x = splat(edge1.x), e1y = splat(edge1.y), e1z = splat(edge1.z);
+    Lanes e2x = splat(edge2.x), e2y = splat(edge2.y), e2z = splat(edge2.z);
+
+    // p = direction x edge2
+    Lanes px = sub(mul(packet.directionY, e2z), mul(packet.directionZ, e2y));
+    Lanes py = sub(mul(packet.directionZ, e2x), mul(packet.directionX, e2z));
+    Lanes pz = sub(mul(packet.directionX, e2y), mul(packet.directionY, e2x));
+    Lanes determinant = add(add(mul(e1x, px), mul(e1y, py)), mul(e1z, pz));
+    Lanes inverse = divide(splat(1.0f), determinant);
+
+    // s = origin - v0, q = s x edge1
+    Lanes sx = sub(packet.originX, splat(triangle.v0.x));
+    Lanes sy = sub(packet.originY, splat(triangle.v0.y));
+    Lanes sz = sub(packet.originZ, splat(triangle.v0.z));
+    Lanes u = mul(add(add(mul(sx, px), mul(sy, py)), mul(sz, pz)), inverse);
+    Lanes qx = sub(mul(sy, e1z), mul(sz, e1y));
+    Lanes qy = sub(mul(sz, e1x), mul(sx, e1z));
+    Lanes qz = sub(mul(sx, e1y), mul(sy, e1x));
+    Lanes v = mul(add(add(mul(packet.directionX, qx), mul(packet.directionY, qy)), mul(packet.directionZ, qz)), inverse);
+    t = mul(add(add(mul(e2x, qx), mul(e2y, qy)), mul(e2z, qz)), inverse);
+
+    Lanes zero = splat(0.0f);
+    Lanes mask = less(splat(MIN_DETERMINANT), absolute(determinant));
+    mask = both(mask, both(lessEqual(zero, u), lessEqual(zero, v)));
+    mask = both(mask, lessEqual(add(u, v), splat(1.0f)));
+    return both(mask, both(lessEqual(zero, t), less(t, packet.tMax)));
+}
+
+// Smallest tNear over the lanes in mask
+inline float nearest(Lanes mask, Lanes tNear) {
+    float values[WIDTH];
+    store(values, select(mask, tNear, splat(INFINITE_DISTANCE)));
+    float result = values[0];
+    for (int i = 1; i < WIDTH; i++) {
+        result = std::min(result, values[i]);
+    }
+    return result;
+}
+#endif
+
+} // namespace
+
+BvhRaycaster::BvhRaycaster(const CollisionBvh& bvh)
+    : m_bvh(bvh)
+{
+}
+
+bool BvhRaycaster::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const {
+    Ray ray{ origin, direction, maxDistance };
+    return traceScalar(ray, Mode::ClosestHit, hit);
+}
+
+bool BvhRaycaster::hasLineOfSight(const glm::vec3& from, const glm::vec3& to) const {
+    Ray ray{ from, to - from, 1.0f };
+    Hit hit;
+    return !traceScalar(ray, Mode::AnyHit, hit);
+}
+
+void BvhRaycaster::cast(const Ray* rays, size_t count, Mode mode, Hit* hits) const {
+    if (PACKET_WIDTH == 1) {
+        for (size_t i = 0; i < count; i++) {
+            traceScalar(rays[i], mode, hits[i]);
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i += PACKET_WIDTH) {
+        int packetCount = static_cast<int>(std::min(count - i, static_cast<size_t>(PACKET_WIDTH)));
+        tracePacket(rays + i, packetCount, mode, hits + i);
+    }
+}
+
+bool BvhRaycaster::traceScalar(const Ray& ray, Mode mode, Hit& hit) const {
+    hit.triangle = -1;
+    hit.distance = ray.maxDistance;
+    if (m_bvh.empty() || ray.maxDistance < 0.0f) return false;
+
+    glm::vec3 inverse(inverseComponent(ray.direction.x), inverseComponent(ray.direction.y),
+                      inverseComponent(ray.direction.z));
+    float tNear;
+    if (!hitBox(m_bvh.getNode(0), ray.origin, inverse, hit.distance, tNear)) return false;
+
+    uint32_t stack[CollisionBvh::MAX_DEPTH];
+    int top = 0;
+    uint32_t nodeIndex = 0;
+    for (;;) {
+        const Node& node = m_bvh.getNode(nodeIndex);
+        if (node.triangleCount > 0) {
+            for (uint32_t i = node.offset; i < node.offset + node.triangleCount; i++) {
+                const Triangle& triangle = m_bvh.getTriangle(static_cast<int>(i));
+                glm::vec2 barycentric;
+                float distance;
+                if (glm::intersectRayTriangle(ray.origin, ray.direction, triangle.v0, triangle.v1, triangle.v2,
+                                              barycentric, distance) &&
+                    distance >= 0.0f && distance < hit.distance) {
+                    hit.distance = distance;
+                    hit.triangle = static_cast<int>(i);
+                    if (mode == Mode::AnyHit) {
+                        finishHit(ray, hit);
+                        return true;
+                    }
+                }
+            }
+        } else {
+            // Nearer child first; the other waits on the stack
+            uint32_t left = nodeIndex + 1;
+            uint32_t right = node.offset;
+            float nearLeft, nearRight;
+            bool hitLeft = hitBox(m_bvh.getNode(left), ray.origin, inverse, hit.distance, nearLeft);
+            bool hitRight = hitBox(m_bvh.getNode(right), ray.origin, inverse, hit.distance, nearRight);
+            if (hitLeft && hitRight) {
+                bool leftFirst = nearLeft <= nearRight;
+                stack[top++] = leftFirst ? right : left;
+                nodeIndex = leftFirst ? left : right;
+                continue;
+            }
+            if (hitLeft || hitRight) {
+                nodeIndex = hitLeft ? left : right;
+                continue;
+            }
+        }
+
+        // Boxes on the stack may be behind a hit found since they were pushed
+        bool resumed = false;
+        while (top > 0) {
+            nodeIndex = stack[--top];
+            if (hitBox(m_bvh.getNode(nodeIndex), ray.origin, inverse, hit.distance, tNear)) {
+                resumed = true;
+                break;
+            }
+        }
+        if (!resumed) break;
+    }
+
+    if (hit.triangle < 0) return false;
+    finishHit(ray, hit);
+    return true;
+}
+
+void BvhRaycaster::tracePacket(const Ray* rays, int count, Mode mode, Hit* hits) const {
+#if defined(RAYCAST_AVX) || defined(RAYCAST_SSE)
+    float originX[WIDTH], originY[WIDTH], originZ[WIDTH];
+    float directionX[WIDTH], directionY[WIDTH], directionZ[WIDTH];
+    float inverseX[WIDTH], inverseY[WIDTH], inverseZ[WIDTH];
+    float tMax[WIDTH];
+    for (int i = 0; i < WIDTH; i++) {
+        const Ray& ray = rays[std::min(i, count - 1)];
+        originX[i] = ray.origin.x;
+        originY[i] = ray.origin.y;
+        originZ[i] = ray.origin.z;
+        directionX[i] = ray.direction.x;
+        directionY[i] = ray.direction.y;
+        directionZ[i] = ray.direction.z;
+        inverseX[i] = inverseComponent(ray.direction.x);
+        inverseY[i] = inverseComponent(ray.direction.y);
+        inverseZ[i] = inverseComponent(ray.direction.z);
+        tMax[i] = i < count ? ray.maxDistance : -1.0f;
+    }
+    for (int i = 0; i < count; i++) {
+        hits[i].triangle = -1;
+        hits[i].distance = rays[i].maxDistance;
+    }
+    if (m_bvh.empty()) return;
+
+    Packet packet;
+    packet.originX = load(originX);
+    packet.originY = load(originY);
+    packet.originZ = load(originZ);
+    packet.directionX = load(directionX);
+    packet.directionY = load(directionY);
+    packet.directionZ = load(directionZ);
+    packet.inverseX = load(inverseX);
+    packet.inverseY = load(inverseY);
+    packet.inverseZ = load(inverseZ);
+    packet.tMax = load(tMax);
+
+    // Any-hit lanes retire on their first hit by dropping tMax below zero
+    const int allLanes = (1 << count) - 1;
+    int finished = 0;
+    float distances[WIDTH];
+
+    Lanes tNear;
+    if (bits(hitBox(m_bvh.getNode(0), packet, tNear)) == 0) return;
+
+    uint32_t stack[CollisionBvh::MAX_DEPTH];
+    int top = 0;
+    uint32_t nodeIndex = 0;
+    for (;;) {
+        const Node& node = m_bvh.getNode(nodeIndex);
+        if (node.triangleCount > 0) {
+            for (uint32_t i = node.offset; i < node.offset + node.triangleCount; i++) {
+                Lanes t;
+                Lanes mask = hitTriangle(m_bvh.getTriangle(static_cast<int>(i)), packet, t);
+                int hitLanes = bits(mask);
+                if (hitLanes == 0) continue;
+
+                store(distances, t);
+                for (int lane = 0; lane < count; lane++) {
+                    if (!(hitLanes & (1 << lane))) continue;
+                    hits[lane].distance = distances[lane];
+                    hits[lane].triangle = static_cast<int>(i);
+                }
+                packet.tMax = select(mask, mode == Mode::AnyHit ? splat(-1.0f) : t, packet.tMax);
+                finished |= hitLanes;
+            }
+            if (mode == Mode::AnyHit && finished == allLanes) break;
+        } else {
+            uint32_t left = nodeIndex + 1;
+            uint32_t right = node.offset;
+            Lanes nearLeft, nearRight;
+            Lanes maskLeft = hitBox(m_bvh.getNode(left), packet, nearLeft);
+            Lanes maskRight = hitBox(m_bvh.getNode(right), packet, nearRight);
+            bool hitLeft = bits(maskLeft) != 0;
+            bool hitRight = bits(maskRight) != 0;
+            if (hitLeft && hitRight) {
+                // The child some ray enters first leads
+                bool leftFirst = nearest(maskLeft, nearLeft) <= nearest(maskRight, nearRight);
+                stack[top++] = leftFirst ? right : left;
+                nodeIndex = leftFirst ? left : right;
+                continue;
+            }
+            if (hitLeft || hitRight) {
+                nodeIndex = hitLeft ? left : right;
+                continue;
+            }
+        }
+
+        bool resumed = false;
+        while (top > 0) {
+            nodeIndex = stack[--top];
+            if (bits(hitBox(m_bvh.getNode(nodeIndex), packet, tNear)) != 0) {
+                resumed = true;
+                break;
+            }
+        }
+        if (!resumed) break;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (hits[i].triangle >= 0) finishHit(rays[i], hits[i]);
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        traceScalar(rays[i], mode, hits[i]);
+    }
+#endif
+}
+
+void BvhRaycaster::finishHit(const Ray& ray, Hit& hit) const {
+    const Triangle& triangle = m_bvh.getTriangle(hit.triangle);
+    glm::vec3 face = glm::cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0);
+    float faceLength = glm::length(face);
+    hit.normal = faceLength > 0.0f ? face / faceLength : glm::vec3(0.0f, 1.0f, 0.0f);
+    if (glm::dot(hit.normal, ray.direction) > 0.0f) hit.normal = -hit.normal;
+    hit.point = ray.origin + ray.direction * hit.distance;
+}
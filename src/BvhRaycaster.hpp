@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "CollisionBvh.hpp"
+
+// Ray queries against a level's collision BVH. Batches are traced in packets of
+// PACKET_WIDTH rays (8 with AVX, 4 with SSE2) that walk the tree together: a
+// node is entered when any ray of the packet hits its box, nearer child first,
+// and leaf triangles are tested against the whole packet at once. Single rays
+// and builds without SIMD use a scalar walk with glm::intersectRayTriangle.
+// Traversal uses a fixed stack of CollisionBvh::MAX_DEPTH and allocates nothing;
+// queries only read the BVH, so any number of threads can run them at once.
+class BvhRaycaster {
+public:
+    enum class Mode {
+        AnyHit,         // Visibility: stop at the first hit found
+        ClosestHit      // Damage: nearest hit
+    };
+
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 direction;    // Distances are in units of its length
+        float maxDistance;
+    };
+
+    struct Hit {
+        glm::vec3 point;
+        glm::vec3 normal;       // Facing the ray
+        float distance;
+        int triangle;           // -1 for a miss
+    };
+
+#if defined(__AVX__)
+    static const int PACKET_WIDTH = 8;
+#elif defined(__SSE2__) || defined(_M_X64)
+    static const int PACKET_WIDTH = 4;
+#else
+    static const int PACKET_WIDTH = 1;
+#endif
+
+    explicit BvhRaycaster(const CollisionBvh& bvh);
+
+    // Closest hit of one ray
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const;
+
+    // True when nothing lies between the two points
+    bool hasLineOfSight(const glm::vec3& from, const glm::vec3& to) const;
+
+    // hits[i] receives the result for rays[i]. Any-hit results are some hit on
+    // the ray, not necessarily the nearest.
+    void cast(const Ray* rays, size_t count, Mode mode, Hit* hits) const;
+
+private:
+    const CollisionBvh& m_bvh;
+
+    bool traceScalar(const Ray& ray, Mode mode, Hit& hit) const;
+    void tracePacket(const Ray* rays, int count, Mode mode, Hit* hits) const;
+    void finishHit(const Ray& ray, Hit& hit) const;
+};
@@ -0,0 +1,148 @@
+#include "CharacterController.hpp"
+#include "Level.hpp"
+#include <cmath>
+
+namespace {
+const float MIN_MOVE = 1e-5f;
+const glm::vec3 UP(0.0f, 1.0f, 0.0f);
+}
+
+CharacterController::CharacterController()
+    : CharacterController(Settings())
+{
+}
+
+CharacterController::CharacterController(const Settings& settings)
+    : m_settings(settings)
+    , m_minGroundNormalY(std::cos(glm::radians(settings.maxSlopeDegrees)))
+    , m_grounded(false)
+    , m_groundNormal(UP)
+    , m_hitCeiling(false)
+    , m_hitWall(false)
+{
+}
+
+glm::vec3 CharacterController::move(const Level& level, const glm::vec3& position, const glm::vec3& displacement) {
+    bool wasGrounded = m_grounded;
+    m_hitCeiling = false;
+    m_hitWall = false;
+
+    // Horizontal first, so walking never fights gravity
+    glm::vec3 result = position;
+    glm::vec3 horizontal(displacement.x, 0.0f, displacement.z);
+    if (glm::dot(horizontal, horizontal) > MIN_MOVE * MIN_MOVE) {
+        bool blocked = false;
+        glm::vec3 slid = slide(level, result, horizontal, blocked);
+
+        // Stopped by something low: keep the stepped move if it got further
+        if (blocked && wasGrounded && m_settings.stepHeight > 0.0f) {
+            glm::vec3 stepped = stepUp(level, result, horizontal);
+            glm::vec2 slidMove(slid.x - result.x, slid.z - result.z);
+            glm::vec2 steppedMove(stepped.x - result.x, stepped.z - result.z);
+            if (glm::dot(steppedMove, steppedMove) > glm::dot(slidMove, slidMove) + MIN_MOVE) slid = stepped;
+        }
+        m_hitWall = blocked;
+        result = slid;
+    }
+
+    glm::vec3 vertical(0.0f, displacement.y, 0.0f);
+    if (std::fabs(displacement.y) > MIN_MOVE) {
+        bool blocked = false;
+        result = slide(level, result, vertical, blocked);
+    }
+
+    // Rising moves leave the ground; otherwise look for it below, far enough to
+    // follow steps down when already standing
+    m_grounded = false;
+    m_groundNormal = UP;
+    if (displacement.y <= 0.0f) {
+        float probe = wasGrounded ? m_settings.stepHeight + m_settings.skinWidth : m_settings.skinWidth * 2.0f;
+        glm::vec3 normal;
+        if (probeGround(level, result, probe, normal)) {
+            m_grounded = true;
+            m_groundNormal = normal;
+        }
+    }
+    return result;
+}
+
+glm::vec3 CharacterController::slide(const Level& level, glm::vec3 position, glm::vec3 movement, bool& blocked) {
+    glm::vec3 previousNormal(0.0f);
+    for (int iteration = 0; iteration < MAX_SLIDE_ITERATIONS; iteration++) {
+        if (glm::dot(movement, movement) <= MIN_MOVE * MIN_MOVE) break;
+
+        CollisionBvh::SweepHit hit;
+        if (!sweep(level, position, movement, hit)) {
+            position += movement;
+            break;
+        }
+        float fraction = hit.fraction;
+        const glm::vec3& normal = hit.normal;
+
+        // Up to the contact, then back out along the normal to keep the skin
+        position += movement * fraction + normal * m_settings.skinWidth;
+        if (normal.y < m_minGroundNormalY) blocked = true;
+        if (normal.y < -m_minGroundNormalY) m_hitCeiling = true;
+
+        // What is left runs along the contact plane, or along the crease with the
+        // previous plane when clipping to this one would push back into that one
+        glm::vec3 remaining = movement * (1.0f - fraction);
+        remaining -= normal * glm::dot(remaining, normal);
+        if (iteration > 0 && glm::dot(remaining, previousNormal) < 0.0f) {
+            glm::vec3 crease = glm::cross(previousNormal, normal);
+            float creaseLength = glm::length(crease);
+            remaining = creaseLength > MIN_MOVE ? crease * (glm::dot(remaining, crease) / (creaseLength * creaseLength))
+                                                : glm::vec3(0.0f);
+        }
+        previousNormal = normal;
+        movement = remaining;
+    }
+    return position;
+}
+
+glm::vec3 CharacterController::stepUp(const Level& level, const glm::vec3& position, const glm::vec3& horizontal) {
+    // Up, across, then back down onto walkable ground; anything else rejects the step
+    CollisionBvh::SweepHit hit;
+    glm::vec3 lift(0.0f, m_settings.stepHeight, 0.0f);
+    glm::vec3 raised = position;
+    if (sweep(level, raised, lift, hit)) {
+        raised += lift * hit.fraction - UP * m_settings.skinWidth;
+    } else {
+        raised += lift;
+    }
+    float rise = raised.y - position.y;
+    if (rise <= m_settings.skinWidth) return position;
+
+    bool blocked = false;
+    bool hitCeiling = m_hitCeiling;
+    glm::vec3 across = slide(level, raised, horizontal, blocked);
+    m_hitCeiling = hitCeiling;
+
+    glm::vec3 landing = across;
+    glm::vec3 normal;
+    if (!probeGround(level, landing, rise + m_settings.skinWidth, normal)) return position;
+    return landing;
+}
+
+bool CharacterController::probeGround(const Level& level, glm::vec3& position, float distance,
+                                      glm::vec3& normal) const {
+    CollisionBvh::SweepHit hit;
+    glm::vec3 down(0.0f, -distance, 0.0f);
+    if (!sweep(level, position, down, hit)) return false;
+
+    // Slopes are judged by the face: on an edge the contact normal tilts towards
+    // the capsule's axis even when standing on flat ground
+    if (hit.faceNormal.y < m_minGroundNormalY) return false;
+
+    // Snap onto it, one skin width above
+    position += down * hit.fraction + UP * m_settings.skinWidth;
+    normal = hit.faceNormal;
+    return true;
+}
+
+bool CharacterController::sweep(const Level& level, const glm::vec3& position, const glm::vec3& movement,
+                                CollisionBvh::SweepHit& hit) const {
+    glm::vec3 bottom = position + glm::vec3(0.0f, m_settings.radius, 0.0f);
+    glm::vec3 top = position + glm::vec3(0.0f, m_settings.height - m_settings.radius, 0.0f);
+    return level.sweepCapsule(bottom, top, m_settings.radius, movement, hit);
+}
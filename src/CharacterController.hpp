@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "CollisionBvh.hpp"
+
+class Level;
+
+// Kinematic capsule controller. Moves are swept against the level's collision
+// BVH and slide along what they hit: a few iterations of clipping the remaining
+// movement to the contact planes, following the crease between two of them.
+// Blocked horizontal moves on the ground retry stepped up by at most stepHeight,
+// and a downward probe after each move finds walkable ground. Positions are the
+// capsule's feet. Deterministic and allocation-free.
+class CharacterController {
+public:
+    struct Settings {
+        float radius = 0.3f;
+        float height = 1.8f;
+        float stepHeight = 0.35f;
+        float maxSlopeDegrees = 45.0f;  // Steeper surfaces are walls
+        float skinWidth = 0.01f;        // Gap kept to the geometry
+    };
+
+    static const int MAX_SLIDE_ITERATIONS = 4;
+
+    CharacterController();
+    explicit CharacterController(const Settings& settings);
+
+    // New feet position after moving by displacement from position
+    glm::vec3 move(const Level& level, const glm::vec3& position, const glm::vec3& displacement);
+
+    // Results of the last move
+    bool isGrounded() const { return m_grounded; }
+    const glm::vec3& getGroundNormal() const { return m_groundNormal; }
+    bool hitCeiling() const { return m_hitCeiling; }
+    bool hitWall() const { return m_hitWall; }
+
+    const Settings& getSettings() const { return m_settings; }
+
+private:
+    Settings m_settings;
+    float m_minGroundNormalY;
+
+    bool m_grounded;
+    glm::vec3 m_groundNormal;
+    bool m_hitCeiling;
+    bool m_hitWall;
+
+    // Sweeps and slides; blocked is set when a non-walkable surface stopped part of the move
+    glm::vec3 slide(const Level& level, glm::vec3 position, glm::vec3 movement, bool& blocked);
+    glm::vec3 stepUp(const Level& level, const glm::vec3& position, const glm::vec3& horizontal);
+    bool probeGround(const Level& level, glm::vec3& position, float distance, glm::vec3& normal) const;
+    bool sweep(const Level& level, const glm::vec3& position, const glm::vec3& movement,
+               CollisionBvh::SweepHit& hit) const;
+};
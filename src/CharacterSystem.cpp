@@ -0,0 +1,357 @@
+#include "CharacterSystem.hpp"
+#include "ThreadPool.hpp"
+#include <GL/glew.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+namespace {
+
+// Procedural humanoid
+enum Joint {
+    PELVIS, SPINE, CHEST, NECK, HEAD,
+    UPPER_ARM_L, FOREARM_L, UPPER_ARM_R, FOREARM_R,
+    THIGH_L, SHIN_L, THIGH_R, SHIN_R,
+    JOINT_COUNT
+};
+
+struct JointDesc {
+    int parent;
+    glm::vec3 offset;           // From the parent, bind pose
+};
+
+const JointDesc JOINTS[JOINT_COUNT] = {
+    { -1,          glm::vec3(0.0f, 0.95f, 0.0f) },
+    { PELVIS,      glm::vec3(0.0f, 0.1f, 0.0f) },
+    { SPINE,       glm::vec3(0.0f, 0.25f, 0.0f) },
+    { CHEST,       glm::vec3(0.0f, 0.25f, 0.0f) },
+    { NECK,        glm::vec3(0.0f, 0.08f, 0.0f) },
+    { CHEST,       glm::vec3(0.22f, 0.2f, 0.0f) },
+    { UPPER_ARM_L, glm::vec3(0.0f, -0.3f, 0.0f) },
+    { CHEST,       glm::vec3(-0.22f, 0.2f, 0.0f) },
+    { UPPER_ARM_R, glm::vec3(0.0f, -0.3f, 0.0f) },
+    { PELVIS,      glm::vec3(0.1f, -0.05f, 0.0f) },
+    { THIGH_L,     glm::vec3(0.0f, -0.45f, 0.0f) },
+    { PELVIS,      glm::vec3(-0.1f, -0.05f, 0.0f) },
+    { THIGH_R,     glm::vec3(0.0f, -0.45f, 0.0f) },
+};
+
+// Box skinned to a joint, relative to the joint's bind position. Vertices at
+// the bottom blend half-way into `bottomJoint` so elbows and knees bend smoothly.
+struct BoxDesc {
+    int joint;
+    int bottomJoint;            // -1 = rigid
+    glm::vec3 minimum;
+    glm::vec3 maximum;
+};
+
+const BoxDesc BOXES[] = {
+    { PELVIS,      -1,        glm::vec3(-0.16f, -0.1f, -0.1f),   glm::vec3(0.16f, 0.1f, 0.1f) },
+    { SPINE,       -1,        glm::vec3(-0.14f, 0.0f, -0.09f),   glm::vec3(0.14f, 0.25f, 0.09f) },
+    { CHEST,       -1,        glm::vec3(-0.19f, 0.0f, -0.11f),   glm::vec3(0.19f, 0.26f, 0.11f) },
+    { HEAD,        -1,        glm::vec3(-0.1f, 0.0f, -0.1f),     glm::vec3(0.1f, 0.24f, 0.12f) },
+    { UPPER_ARM_L, FOREARM_L, glm::vec3(-0.05f, -0.3f, -0.05f),  glm::vec3(0.05f, 0.0f, 0.05f) },
+    { FOREARM_L,   -1,        glm::vec3(-0.045f, -0.28f, -0.045f), glm::vec3(0.045f, 0.0f, 0.045f) },
+    { UPPER_ARM_R, FOREARM_R, glm::vec3(-0.05f, -0.3f, -0.05f),  glm::vec3(0.05f, 0.0f, 0.05f) },
+    { FOREARM_R,   -1,        glm::vec3(-0.045f, -0.28f, -0.045f), glm::vec3(0.045f, 0.0f, 0.045f) },
+    { THIGH_L,     SHIN_L,    glm::vec3(-0.07f, -0.45f, -0.07f), glm::vec3(0.07f, 0.0f, 0.07f) },
+    { SHIN_L,      -1,        glm::vec3(-0.06f, -0.45f, -0.06f), glm::vec3(0.06f, 0.0f, 0.1f) },
+    { THIGH_R,     SHIN_R,    glm::vec3(-0.07f, -0.45f, -0.07f), glm::vec3(0.07f, 0.0f, 0.07f) },
+    { SHIN_R,      -1,        glm::vec3(-0.06f, -0.45f, -0.06f), glm::vec3(0.06f, 0.0f, 0.1f) },
+};
+
+const float RUN_SPEED = 4.0f;           // Speed at which the run clip plays at full weight and rate
+const float BLEND_RATE = 6.0f;          // Run blend smoothing, per second
+const int CHUNK_SIZE = 8;               // Characters per update task
+const float SAMPLE_RATE = 30.0f;
+const float PI = 3.14159265f;
+
+glm::quat axisAngle(float angle, const glm::vec3& axis) {
+    return glm::angleAxis(angle, axis);
+}
+
+} // namespace
+
+CharacterSystem::CharacterSystem()
+    : m_shader(0)
+    , m_VAO(0)
+    , m_indexCount(0)
+    , m_paletteStride(MAX_JOINTS)
+{
+}
+
+CharacterSystem::~CharacterSystem() {
+    if (m_VAO) {
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    if (m_shader) {
+        glDeleteProgram(m_shader);
+    }
+}
+
+bool CharacterSystem::initialize(unsigned int shader) {
+    m_shader = shader;
+
+    buildSkeleton();
+    buildClips();
+
+    std::vector<SkinnedVertex> vertices;
+    std::vector<unsigned short> indices;
+    buildMesh(vertices, indices);
+    m_indexCount = static_cast<int>(indices.size());
+
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+
+    m_vertexBuffer.reset(new VertexBuffer(GL_ARRAY_BUFFER));
+    m_vertexBuffer->setData(vertices.data(), vertices.size() * sizeof(SkinnedVertex));
+    m_indexBuffer.reset(new VertexBuffer(GL_ELEMENT_ARRAY_BUFFER));
+    m_indexBuffer->setData(indices.data(), indices.size() * sizeof(unsigned short));
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, normal));
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, joints));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SkinnedVertex), (void*)offsetof(SkinnedVertex, weights));
+
+    glBindVertexArray(0);
+    m_vertexBuffer->unbind();
+
+    // Palette ranges must start on the uniform buffer offset alignment
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    int paletteBytes = MAX_JOINTS * static_cast<int>(sizeof(glm::mat4));
+    int strideBytes = (paletteBytes + alignment - 1) / alignment * alignment;
+    m_paletteStride = strideBytes / static_cast<int>(sizeof(glm::mat4));
+    m_paletteBuffer.reset(new VertexBuffer(GL_UNIFORM_BUFFER));
+
+    GLuint blockIndex = glGetUniformBlockIndex(m_shader, "JointPalette");
+    if (blockIndex == GL_INVALID_INDEX) {
+        std::cerr << "Skinning shader has no JointPalette block" << std::endl;
+        return false;
+    }
+    glUniformBlockBinding(m_shader, blockIndex, 0);
+    return true;
+}
+
+void CharacterSystem::buildSkeleton() {
+    m_skeleton.parents.resize(JOINT_COUNT);
+    m_skeleton.inverseBind.resize(JOINT_COUNT);
+
+    std::vector<glm::vec3> bindPositions(JOINT_COUNT);
+    for (int joint = 0; joint < JOINT_COUNT; joint++) {
+        int parent = JOINTS[joint].parent;
+        m_skeleton.parents[joint] = parent;
+        bindPositions[joint] = (parent >= 0 ? bindPositions[parent] : glm::vec3(0.0f)) + JOINTS[joint].offset;
+
+        // Bind pose has no rotation, so its inverse is a translation
+        m_skeleton.inverseBind[joint] = glm::translate(glm::mat4(1.0f), -bindPositions[joint]);
+    }
+}
+
+void CharacterSystem::buildClips() {
+    const glm::vec3 X(1.0f, 0.0f, 0.0f);
+    const glm::vec3 Y(0.0f, 1.0f, 0.0f);
+    const glm::vec3 Z(0.0f, 0.0f, 1.0f);
+
+    auto generate = [&](int frameCount, bool running, AnimationClip& clip) {
+        std::vector<glm::quat> rotations(static_cast<size_t>(frameCount) * JOINT_COUNT, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        std::vector<glm::vec3> translations(static_cast<size_t>(frameCount) * JOINT_COUNT);
+
+        for (int frame = 0; frame < frameCount; frame++) {
+            float phase = 2.0f * PI * frame / frameCount;
+            float s = std::sin(phase);
+            glm::quat* r = &rotations[static_cast<size_t>(frame) * JOINT_COUNT];
+            glm::vec3* t = &translations[static_cast<size_t>(frame) * JOINT_COUNT];
+            for (int joint = 0; joint < JOINT_COUNT; joint++) t[joint] = JOINTS[joint].offset;
+
+            if (running) {
+                // Legs swing opposite to each other, knees bend on the back swing, arms counter-swing
+                t[PELVIS].y -= 0.05f * std::fabs(std::cos(phase));
+                r[PELVIS] = axisAngle(0.08f * s, Y);
+                r[SPINE] = axisAngle(0.12f, X);
+                r[CHEST] = axisAngle(-0.15f * s, Y);
+                r[THIGH_L] = axisAngle(-0.7f * s, X);
+                r[THIGH_R] = axisAngle(0.7f * s, X);
+                r[SHIN_L] = axisAngle(0.2f + 0.9f * std::max(0.0f, std::cos(phase + 0.6f)), X);
+                r[SHIN_R] = axisAngle(0.2f + 0.9f * std::max(0.0f, -std::cos(phase + 0.6f)), X);
+                r[UPPER_ARM_L] = axisAngle(0.6f * s, X) * axisAngle(0.1f, Z);
+                r[UPPER_ARM_R] = axisAngle(-0.6f * s, X) * axisAngle(-0.1f, Z);
+                r[FOREARM_L] = axisAngle(-1.1f, X);
+                r[FOREARM_R] = axisAngle(-1.1f, X);
+            } else {
+                // Breathing and a slight sway
+                t[PELVIS].y -= 0.005f * (1.0f + s);
+                r[CHEST] = axisAngle(0.03f * s, X);
+                r[NECK] = axisAngle(0.04f * std::sin(phase * 0.5f), Y);
+                r[UPPER_ARM_L] = axisAngle(0.12f, Z);
+                r[UPPER_ARM_R] = axisAngle(-0.12f, Z);
+                r[FOREARM_L] = axisAngle(-0.15f - 0.03f * s, X);
+                r[FOREARM_R] = axisAngle(-0.15f - 0.03f * s, X);
+            }
+        }
+
+        clip.compress(rotations, translations, JOINT_COUNT, frameCount, SAMPLE_RATE, true);
+    };
+
+    generate(static_cast<int>(SAMPLE_RATE * 2.0f), false, m_idleClip);   // 2 s breathing cycle
+    generate(static_cast<int>(SAMPLE_RATE * 0.7f), true, m_runClip);     // 0.7 s stride
+}
+
+void CharacterSystem::buildMesh(std::vector<SkinnedVertex>& vertices, std::vector<unsigned short>& indices) const {
+    // Joint positions in the bind pose
+    glm::vec3 bindPositions[JOINT_COUNT];
+    for (int joint = 0; joint < JOINT_COUNT; joint++) {
+        bindPositions[joint] = -glm::vec3(m_skeleton.inverseBind[joint][3]);
+    }
+
+    // Face normals and their corners (unit cube, counter-clockwise from outside)
+    static const glm::vec3 normals[6] = {
+        glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0),
+        glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1)
+    };
+
+    for (const BoxDesc& box : BOXES) {
+        glm::vec3 center = bindPositions[box.joint];
+        for (const glm::vec3& n : normals) {
+            // Two in-face axes with u x v = n
+            glm::vec3 u = std::fabs(n.y) > 0.5f ? glm::vec3(n.y, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            glm::vec3 v = glm::cross(n, u);
+
+            unsigned short base = static_cast<unsigned short>(vertices.size());
+            const float corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+            for (const auto& corner : corners) {
+                glm::vec3 unit = n + u * corner[0] + v * corner[1];        // Corner of [-1, 1]^3
+                glm::vec3 local = glm::mix(box.minimum, box.maximum, unit * 0.5f + 0.5f);
+
+                SkinnedVertex vertex;
+                vertex.position = center + local;
+                vertex.normal = n;
+                vertex.joints[0] = static_cast<unsigned char>(box.joint);
+                vertex.joints[1] = static_cast<unsigned char>(box.bottomJoint >= 0 ? box.bottomJoint : box.joint);
+                vertex.joints[2] = vertex.joints[3] = 0;
+                bool blended = box.bottomJoint >= 0 && unit.y < 0.0f;
+                vertex.weights[0] = blended ? 128 : 255;
+                vertex.weights[1] = blended ? 127 : 0;
+                vertex.weights[2] = vertex.weights[3] = 0;
+                vertices.push_back(vertex);
+            }
+
+            // Winding follows u x v = n, so both triangles face outwards
+            indices.push_back(base); indices.push_back(base + 1); indices.push_back(base + 2);
+            indices.push_back(base); indices.push_back(base + 2); indices.push_back(base + 3);
+        }
+    }
+}
+
+int CharacterSystem::addCharacter(const glm::vec3& position, float yaw, const glm::vec3& color) {
+    Character character;
+    character.position = position;
+    character.yaw = yaw;
+    character.speed = 0.0f;
+    character.runBlend = 0.0f;
+
+    // Desynchronize the cycles
+    float offset = static_cast<float>(m_characters.size()) * 0.37f;
+    character.idleTime = offset;
+    character.runTime = offset;
+    character.color = color;
+    m_characters.push_back(character);
+
+    // Storage grows only here, never during update
+    size_t chunks = (m_characters.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    while (m_scratch.size() < chunks) {
+        Scratch scratch;
+        scratch.idle.resize(JOINT_COUNT);
+        scratch.run.resize(JOINT_COUNT);
+        scratch.blended.resize(JOINT_COUNT);
+        m_scratch.push_back(scratch);
+    }
+    m_palettes.resize(m_characters.size() * m_paletteStride, glm::mat4(1.0f));
+
+    return static_cast<int>(m_characters.size()) - 1;
+}
+
+void CharacterSystem::setCharacterState(int index, const glm::vec3& position, float yaw, float speed) {
+    if (index < 0 || index >= static_cast<int>(m_characters.size())) return;
+    Character& character = m_characters[index];
+    character.position = position;
+    character.yaw = yaw;
+    character.speed = speed;
+}
+
+void CharacterSystem::clear() {
+    m_characters.clear();
+}
+
+void CharacterSystem::updateChunk(int chunk, float deltaTime) {
+    Scratch& scratch = m_scratch[chunk];
+    int first = chunk * CHUNK_SIZE;
+    int last = std::min(first + CHUNK_SIZE, static_cast<int>(m_characters.size()));
+
+    for (int i = first; i < last; i++) {
+        Character& character = m_characters[i];
+
+        float target = std::min(character.speed / RUN_SPEED, 1.0f);
+        character.runBlend += (target - character.runBlend) * std::min(1.0f, BLEND_RATE * deltaTime);
+
+        // Run cadence follows the speed, with a floor so blending out does not freeze the legs
+        character.idleTime += deltaTime;
+        character.runTime += deltaTime * std::max(target, 0.5f);
+
+        glm::mat4* palette = &m_palettes[static_cast<size_t>(i) * m_paletteStride];
+        if (character.runBlend <= 0.001f) {
+            m_idleClip.sample(character.idleTime, scratch.blended);
+        } else if (character.runBlend >= 0.999f) {
+            m_runClip.sample(character.runTime, scratch.blended);
+        } else {
+            m_idleClip.sample(character.idleTime, scratch.idle);
+            m_runClip.sample(character.runTime, scratch.run);
+            Animation::blendPoses(scratch.idle, scratch.run, character.runBlend, scratch.blended);
+        }
+        Animation::computeSkinningMatrices(m_skeleton, scratch.blended, palette);
+    }
+}
+
+void CharacterSystem::update(float deltaTime, ThreadPool* pool) {
+    int chunks = (static_cast<int>(m_characters.size()) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (pool) {
+        pool->parallelFor(chunks, [this, deltaTime](int chunk) { updateChunk(chunk, deltaTime); });
+    } else {
+        for (int chunk = 0; chunk < chunks; chunk++) updateChunk(chunk, deltaTime);
+    }
+}
+
+void CharacterSystem::render(const glm::mat4& view, const glm::mat4& projection) {
+    if (m_characters.empty() || !m_VAO) return;
+
+    // All palettes in one upload
+    m_paletteBuffer->setData(m_palettes.data(), m_characters.size() * m_paletteStride * sizeof(glm::mat4), GL_STREAM_DRAW);
+
+    glUseProgram(m_shader);
+    glUniformMatrix4fv(glGetUniformLocation(m_shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(m_shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform1f(glGetUniformLocation(m_shader, "lodFade"), 0.0f);
+    GLint modelLocation = glGetUniformLocation(m_shader, "model");
+    GLint colorLocation = glGetUniformLocation(m_shader, "objectColor");
+
+    glBindVertexArray(m_VAO);
+    for (size_t i = 0; i < m_characters.size(); i++) {
+        const Character& character = m_characters[i];
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), character.position);
+        model = glm::rotate(model, character.yaw, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        glBindBufferRange(GL_UNIFORM_BUFFER, 0, m_paletteBuffer->getID(),
+                          i * m_paletteStride * sizeof(glm::mat4), MAX_JOINTS * sizeof(glm::mat4));
+        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
+        glUniform3fv(colorLocation, 1, glm::value_ptr(character.color));
+        glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_SHORT, 0);
+    }
+    glBindVertexArray(0);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Animation.hpp"
+#include "VertexBuffer.hpp"
+
+class ThreadPool;
+
+// Animated player characters.
+// Every character samples an idle and a run clip, blends them by speed and
+// writes its skinning matrices into one joint palette array; update() spreads
+// characters over the thread pool in fixed chunks, each with its own scratch
+// poses. render() uploads all palettes to one uniform buffer and draws each
+// character with its palette range bound to the skinned vertex shader.
+// The humanoid skeleton, mesh and clips are generated procedurally.
+class CharacterSystem {
+public:
+    static const int MAX_JOINTS = 32;
+
+    CharacterSystem();
+    ~CharacterSystem();
+
+    // Takes ownership of the skinning shader program
+    bool initialize(unsigned int shader);
+
+    int addCharacter(const glm::vec3& position, float yaw, const glm::vec3& color = glm::vec3(0.8f));
+    void setCharacterState(int character, const glm::vec3& position, float yaw, float speed);
+    void clear();
+
+    void update(float deltaTime, ThreadPool* pool = nullptr);
+    void render(const glm::mat4& view, const glm::mat4& projection);
+
+    int getCharacterCount() const { return static_cast<int>(m_characters.size()); }
+    size_t getClipMemoryUsage() const { return m_idleClip.getMemoryUsage() + m_runClip.getMemoryUsage(); }
+
+private:
+    struct SkinnedVertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+        unsigned char joints[4];
+        unsigned char weights[4];       // Normalized
+    };
+
+    struct Character {
+        glm::vec3 position;
+        float yaw;                      // Radians about +Y, 0 = facing +Z
+        float speed;                    // Meters per second
+        float runBlend;                 // Smoothed towards speed / RUN_SPEED
+        float idleTime;
+        float runTime;
+        glm::vec3 color;
+    };
+
+    struct Scratch {
+        Pose idle;
+        Pose run;
+        Pose blended;
+    };
+
+    Skeleton m_skeleton;
+    AnimationClip m_idleClip;
+    AnimationClip m_runClip;
+
+    std::vector<Character> m_characters;
+    std::vector<Scratch> m_scratch;     // One per update chunk
+    std::vector<glm::mat4> m_palettes;  // m_paletteStride matrices per character
+
+    unsigned int m_shader;
+    unsigned int m_VAO;
+    std::unique_ptr<VertexBuffer> m_vertexBuffer;
+    std::unique_ptr<VertexBuffer> m_indexBuffer;
+    std::unique_ptr<VertexBuffer> m_paletteBuffer;
+    int m_indexCount;
+    int m_paletteStride;
+
+    void buildSkeleton();
+    void buildClips();
+    void buildMesh(std::vector<SkinnedVertex>& vertices, std::vector<unsigned short>& indices) const;
+    void updateChunk(int chunk, float deltaTime);
+};
@@ -0,0 +1,437 @@
+#include "CollisionBvh.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int SAH_BINS = 16;
+const int MAX_SAH_LEAF = 16;            // Larger leaves are split even when SAH says not to
+const float TRAVERSAL_COST = 1.0f;      // Relative to one triangle test
+const float CONTACT_DISTANCE = 1e-4f;   // Sweeps stop this close to the geometry
+const int MAX_SWEEP_STEPS = 64;
+const float TIE_FRACTION = 1e-5f;       // Sweep hits this close count as simultaneous
+
+float surfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    glm::vec3 size = boundsMax - boundsMin;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool overlaps(const CollisionBvh::Node& node, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    return node.boundsMin.x <= boundsMax.x && node.boundsMax.x >= boundsMin.x &&
+           node.boundsMin.y <= boundsMax.y && node.boundsMax.y >= boundsMin.y &&
+           node.boundsMin.z <= boundsMax.z && node.boundsMax.z >= boundsMin.z;
+}
+
+float lengthSquared(const glm::vec3& v) {
+    return glm::dot(v, v);
+}
+
+// How squarely a triangle faces a movement, for either winding
+float facing(const CollisionBvh::Triangle& triangle, const glm::vec3& movement) {
+    glm::vec3 face = glm::cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0);
+    float faceLength = glm::length(face);
+    return faceLength > 0.0f ? std::fabs(glm::dot(face, movement)) / faceLength : 0.0f;
+}
+
+// Real-Time Collision Detection 5.1.5
+glm::vec3 closestPointOnTriangle(const glm::vec3& p, const CollisionBvh::Triangle& triangle) {
+    const glm::vec3& a = triangle.v0;
+    const glm::vec3& b = triangle.v1;
+    const glm::vec3& c = triangle.v2;
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+
+    glm::vec3 ap = p - a;
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp);
+    float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp);
+    float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Real-Time Collision Detection 5.1.9
+float closestPointsSegmentSegment(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2,
+                                  glm::vec3& c1, glm::vec3& c2) {
+    const float epsilon = 1e-12f;
+    glm::vec3 d1 = q1 - p1;
+    glm::vec3 d2 = q2 - p2;
+    glm::vec3 r = p1 - p2;
+    float a = glm::dot(d1, d1);
+    float e = glm::dot(d2, d2);
+    float f = glm::dot(d2, r);
+    float s = 0.0f;
+    float t = 0.0f;
+
+    if (a <= epsilon && e <= epsilon) {
+        // Both are points
+    } else if (a <= epsilon) {
+        t = glm::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        float c = glm::dot(d1, r);
+        if (e <= epsilon) {
+            s = glm::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            float b = glm::dot(d1, d2);
+            float denom = a * e - b * b;
+            s = denom != 0.0f ? glm::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = glm::clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+    return lengthSquared(c1 - c2);
+}
+
+// Squared distance between segment p-q and a triangle, with the closest points
+float segmentTriangleDistanceSquared(const glm::vec3& p, const glm::vec3& q, const CollisionBvh::Triangle& triangle,
+                                     glm::vec3& onSegment, glm::vec3& onTriangle) {
+    // Segment crossing the triangle's plane inside the triangle
+    glm::vec3 normal = glm::cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0);
+    float dp = glm::dot(normal, p - triangle.v0);
+    float dq = glm::dot(normal, q - triangle.v0);
+    if (dp * dq <= 0.0f && dp != dq) {
+        glm::vec3 crossing = p + (q - p) * (dp / (dp - dq));
+        glm::vec3 closest = closestPointOnTriangle(crossing, triangle);
+        if (lengthSquared(closest - crossing) <= 1e-12f) {
+            onSegment = crossing;
+            onTriangle = crossing;
+            return 0.0f;
+        }
+    }
+
+    // Otherwise the closest pair involves an endpoint or a triangle edge
+    onSegment = p;
+    onTriangle = closestPointOnTriangle(p, triangle);
+    float best = lengthSquared(onSegment - onTriangle);
+
+    glm::vec3 closest = closestPointOnTriangle(q, triangle);
+    float distance = lengthSquared(q - closest);
+    if (distance < best) {
+        best = distance;
+        onSegment = q;
+        onTriangle = closest;
+    }
+
+    const glm::vec3* corners[4] = { &triangle.v0, &triangle.v1, &triangle.v2, &triangle.v0 };
+    for (int edge = 0; edge < 3; edge++) {
+        glm::vec3 segmentPoint, edgePoint;
+        distance = closestPointsSegmentSegment(p, q, *corners[edge], *corners[edge + 1], segmentPoint, edgePoint);
+        if (distance < best) {
+            best = distance;
+            onSegment = segmentPoint;
+            onTriangle = edgePoint;
+        }
+    }
+    return best;
+}
+
+// Conservative advancement. The distance between a translating capsule and a
+// triangle is convex in the fraction, so a Newton step on it never passes the
+// first contact, and once the distance stops shrinking it never will.
+bool sweepTriangle(const glm::vec3& a, const glm::vec3& b, float radius, const glm::vec3& movement,
+                   float maxFraction, const CollisionBvh::Triangle& triangle,
+                   float& fraction, glm::vec3& onSegment, glm::vec3& onTriangle) {
+    float t = 0.0f;
+    for (int step = 0; step < MAX_SWEEP_STEPS; step++) {
+        glm::vec3 offset = movement * t;
+        float distance = std::sqrt(segmentTriangleDistanceSquared(a + offset, b + offset, triangle,
+                                                                  onSegment, onTriangle));
+        float gap = distance - radius;
+
+        // Rate of change of the distance along the movement
+        float approach = distance > 0.0f ? -glm::dot(movement, onSegment - onTriangle) / distance : 1.0f;
+        if (gap <= CONTACT_DISTANCE) {
+            // Touching but moving along or away from the surface is not blocked
+            if (approach <= 0.0f) return false;
+            fraction = t;
+            return true;
+        }
+        if (approach <= 0.0f) return false;
+        t += gap / approach;
+        if (t > maxFraction) return false;
+    }
+
+    // Grazing approach that did not converge: stop short rather than pass through
+    fraction = t;
+    return true;
+}
+
+} // namespace
+
+struct CollisionBvh::BuildItem {
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    glm::vec3 centroid;
+    uint32_t triangle;
+};
+
+CollisionBvh::CollisionBvh()
+    : m_depth(0)
+{
+}
+
+void CollisionBvh::clear() {
+    std::vector<Node>().swap(m_nodes);
+    std::vector<Triangle>().swap(m_triangles);
+    m_depth = 0;
+}
+
+void CollisionBvh::build(const CollisionMesh& mesh) {
+    clear();
+    size_t triangleCount = mesh.indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    std::vector<Triangle> source(triangleCount);
+    std::vector<BuildItem> items(triangleCount);
+    for (size_t i = 0; i < triangleCount; i++) {
+        Triangle& triangle = source[i];
+        triangle.v0 = mesh.positions[mesh.indices[i * 3]];
+        triangle.v1 = mesh.positions[mesh.indices[i * 3 + 1]];
+        triangle.v2 = mesh.positions[mesh.indices[i * 3 + 2]];
+
+        BuildItem& item = items[i];
+        item.boundsMin = glm::min(glm::min(triangle.v0, triangle.v1), triangle.v2);
+        item.boundsMax = glm::max(glm::max(triangle.v0, triangle.v1), triangle.v2);
+        item.centroid = (item.boundsMin + item.boundsMax) * 0.5f;
+        item.triangle = static_cast<uint32_t>(i);
+    }
+
+    m_nodes.reserve(triangleCount * 2);
+    buildNode(items, 0, static_cast<uint32_t>(triangleCount), 1);
+    m_nodes.shrink_to_fit();
+
+    // Leaves index a contiguous range of the partitioned items
+    m_triangles.resize(triangleCount);
+    for (size_t i = 0; i < triangleCount; i++) {
+        m_triangles[i] = source[items[i].triangle];
+    }
+}
+
+void CollisionBvh::buildNode(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, int depth) {
+    uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node());
+    m_depth = std::max(m_depth, depth);
+
+    glm::vec3 boundsMin(INFINITY), boundsMax(-INFINITY);
+    glm::vec3 centroidMin(INFINITY), centroidMax(-INFINITY);
+    for (uint32_t i = begin; i < end; i++) {
+        boundsMin = glm::min(boundsMin, items[i].boundsMin);
+        boundsMax = glm::max(boundsMax, items[i].boundsMax);
+        centroidMin = glm::min(centroidMin, items[i].centroid);
+        centroidMax = glm::max(centroidMax, items[i].centroid);
+    }
+    m_nodes[index].boundsMin = boundsMin;
+    m_nodes[index].boundsMax = boundsMax;
+
+    uint32_t count = end - begin;
+    if (count <= MAX_LEAF_TRIANGLES || depth >= MAX_DEPTH) {
+        m_nodes[index].offset = begin;
+        m_nodes[index].triangleCount = count;
+        return;
+    }
+
+    // Binned SAH over all three axes: cost of splitting after each bin
+    int bestAxis = -1;
+    int bestBin = 0;
+    float bestCost = INFINITY;
+    glm::vec3 extent = centroidMax - centroidMin;
+    for (int axis = 0; axis < 3; axis++) {
+        if (extent[axis] <= 0.0f) continue;
+        float scale = SAH_BINS / extent[axis];
+
+        glm::vec3 binMin[SAH_BINS], binMax[SAH_BINS];
+        int binCount[SAH_BINS] = {};
+        for (int bin = 0; bin < SAH_BINS; bin++) {
+            binMin[bin] = glm::vec3(INFINITY);
+            binMax[bin] = glm::vec3(-INFINITY);
+        }
+        for (uint32_t i = begin; i < end; i++) {
+            int bin = std::min(SAH_BINS - 1, static_cast<int>((items[i].centroid[axis] - centroidMin[axis]) * scale));
+            binCount[bin]++;
+            binMin[bin] = glm::min(binMin[bin], items[i].boundsMin);
+            binMax[bin] = glm::max(binMax[bin], items[i].boundsMax);
+        }
+
+        // Left sides from the front, then right sides from the back
+        float leftCost[SAH_BINS - 1];
+        glm::vec3 sideMin(INFINITY), sideMax(-INFINITY);
+        int sideCount = 0;
+        for (int bin = 0; bin < SAH_BINS - 1; bin++) {
+            sideCount += binCount[bin];
+            sideMin = glm::min(sideMin, binMin[bin]);
+            sideMax = glm::max(sideMax, binMax[bin]);
+            leftCost[bin] = sideCount > 0 ? surfaceArea(sideMin, sideMax) * sideCount : 0.0f;
+        }
+        sideMin = glm::vec3(INFINITY);
+        sideMax = glm::vec3(-INFINITY);
+        sideCount = 0;
+        for (int bin = SAH_BINS - 1; bin > 0; bin--) {
+            sideCount += binCount[bin];
+            sideMin = glm::min(sideMin, binMin[bin]);
+            sideMax = glm::max(sideMax, binMax[bin]);
+            float cost = leftCost[bin - 1] + (sideCount > 0 ? surfaceArea(sideMin, sideMax) * sideCount : 0.0f);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = bin - 1;
+            }
+        }
+    }
+
+    uint32_t middle = begin + count / 2;
+    if (bestAxis >= 0) {
+        float area = surfaceArea(boundsMin, boundsMax);
+        float splitCost = TRAVERSAL_COST + (area > 0.0f ? bestCost / area : 0.0f);
+        if (splitCost >= static_cast<float>(count) && count <= MAX_SAH_LEAF) {
+            m_nodes[index].offset = begin;
+            m_nodes[index].triangleCount = count;
+            return;
+        }
+
+        float scale = SAH_BINS / extent[bestAxis];
+        float origin = centroidMin[bestAxis];
+        auto split = std::partition(items.begin() + begin, items.begin() + end, [&](const BuildItem& item) {
+            return std::min(SAH_BINS - 1, static_cast<int>((item.centroid[bestAxis] - origin) * scale)) <= bestBin;
+        });
+        middle = static_cast<uint32_t>(split - items.begin());
+        if (middle == begin || middle == end) middle = begin + count / 2;
+    }
+    // else: every centroid coincides, so any halving is as good as another
+
+    buildNode(items, begin, middle, depth + 1);
+    m_nodes[index].offset = static_cast<uint32_t>(m_nodes.size());
+    m_nodes[index].triangleCount = 0;
+    buildNode(items, middle, end, depth + 1);
+}
+
+bool CollisionBvh::overlapCapsule(const glm::vec3& a, const glm::vec3& b, float radius) const {
+    if (m_nodes.empty()) return false;
+    glm::vec3 queryMin = glm::min(a, b) - glm::vec3(radius);
+    glm::vec3 queryMax = glm::max(a, b) + glm::vec3(radius);
+    float radiusSquared = radius * radius;
+
+    uint32_t stack[MAX_DEPTH];
+    int top = 0;
+    uint32_t nodeIndex = 0;
+    for (;;) {
+        const Node& node = m_nodes[nodeIndex];
+        if (overlaps(node, queryMin, queryMax)) {
+            if (node.triangleCount == 0) {
+                stack[top++] = node.offset;
+                nodeIndex++;
+                continue;
+            }
+            for (uint32_t i = node.offset; i < node.offset + node.triangleCount; i++) {
+                glm::vec3 onSegment, onTriangle;
+                if (segmentTriangleDistanceSquared(a, b, m_triangles[i], onSegment, onTriangle) < radiusSquared) {
+                    return true;
+                }
+            }
+        }
+        if (top == 0) break;
+        nodeIndex = stack[--top];
+    }
+    return false;
+}
+
+bool CollisionBvh::sweepCapsule(const glm::vec3& a, const glm::vec3& b, float radius, const glm::vec3& movement,
+                                SweepHit& hit) const {
+    hit.fraction = 1.0f;
+    hit.triangle = -1;
+    if (m_nodes.empty()) return false;
+
+    float length = glm::length(movement);
+    glm::vec3 capsuleMin = glm::min(a, b) - glm::vec3(radius + CONTACT_DISTANCE);
+    glm::vec3 capsuleMax = glm::max(a, b) + glm::vec3(radius + CONTACT_DISTANCE);
+    glm::vec3 queryMin = glm::min(capsuleMin, capsuleMin + movement);
+    glm::vec3 queryMax = glm::max(capsuleMax, capsuleMax + movement);
+    glm::vec3 onSegment(0.0f), onTriangle(0.0f);
+
+    uint32_t stack[MAX_DEPTH];
+    int top = 0;
+    uint32_t nodeIndex = 0;
+    for (;;) {
+        const Node& node = m_nodes[nodeIndex];
+        if (overlaps(node, queryMin, queryMax)) {
+            if (node.triangleCount == 0) {
+                stack[top++] = node.offset;
+                nodeIndex++;
+                continue;
+            }
+            for (uint32_t i = node.offset; i < node.offset + node.triangleCount; i++) {
+                float fraction;
+                glm::vec3 segmentPoint, trianglePoint;
+                float maxFraction = std::min(hit.fraction + TIE_FRACTION, 1.0f);
+                if (!sweepTriangle(a, b, radius, movement, maxFraction, m_triangles[i],
+                                   fraction, segmentPoint, trianglePoint)) {
+                    continue;
+                }
+                // Contacts on a shared edge tie: report the face most in the way
+                bool tied = hit.triangle >= 0 && fraction > hit.fraction - TIE_FRACTION;
+                if (hit.triangle < 0 || (tied ? facing(m_triangles[i], movement) >
+                                                    facing(m_triangles[hit.triangle], movement)
+                                              : fraction < hit.fraction)) {
+                    if (tied) fraction = std::min(fraction, hit.fraction);
+                    hit.fraction = fraction;
+                    hit.triangle = static_cast<int>(i);
+                    onSegment = segmentPoint;
+                    onTriangle = trianglePoint;
+
+                    // Only the rest of the path can hold an earlier hit
+                    queryMin = glm::min(capsuleMin, capsuleMin + movement * fraction);
+                    queryMax = glm::max(capsuleMax, capsuleMax + movement * fraction);
+                }
+            }
+        }
+        if (top == 0) break;
+        nodeIndex = stack[--top];
+    }
+
+    if (hit.triangle < 0) return false;
+
+    hit.point = onTriangle;
+    const Triangle& triangle = m_triangles[hit.triangle];
+    glm::vec3 face = glm::cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0);
+    face = lengthSquared(face) > 0.0f ? glm::normalize(face) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 separation = onSegment - onTriangle;
+    if (lengthSquared(separation) > 1e-12f) {
+        hit.normal = glm::normalize(separation);
+    } else {
+        // Segment touching the triangle: its face normal, against the movement
+        glm::vec3 toCapsule = (a + b) * 0.5f - onTriangle;
+        float side = length > 0.0f ? -glm::dot(face, movement) : glm::dot(face, toCapsule);
+        hit.normal = side < 0.0f ? -face : face;
+    }
+    hit.faceNormal = glm::dot(face, hit.normal) < 0.0f ? -face : face;
+    return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.hpp"
+
+// Static bounding volume hierarchy over a level's collision triangles for capsule
+// queries. Built top-down with binned SAH and stored depth-first in one array:
+// an interior node's left child follows it and its right child is at offset.
+// Queries walk it with a fixed-size stack and allocate nothing.
+class CollisionBvh {
+public:
+    struct Node {
+        glm::vec3 boundsMin;
+        uint32_t offset;            // Right child (interior) or first triangle (leaf)
+        glm::vec3 boundsMax;
+        uint32_t triangleCount;     // 0 for interior nodes
+    };
+
+    struct Triangle {
+        glm::vec3 v0;
+        glm::vec3 v1;
+        glm::vec3 v2;
+    };
+
+    struct SweepHit {
+        float fraction;             // Of the movement, in [0, 1]
+        glm::vec3 point;            // Contact point on the geometry
+        glm::vec3 normal;           // From the geometry towards the capsule
+        glm::vec3 faceNormal;       // Of the triangle hit, on the capsule's side
+        int triangle;
+    };
+
+    static const int MAX_DEPTH = 64;
+    static const int MAX_LEAF_TRIANGLES = 4;
+
+    CollisionBvh();
+
+    void build(const CollisionMesh& mesh);
+    void clear();
+
+    // Capsules are the segment a-b inflated by radius
+    bool overlapCapsule(const glm::vec3& a, const glm::vec3& b, float radius) const;
+
+    // First contact of the capsule moved by movement. A capsule that starts in
+    // contact hits at fraction 0 unless it moves along or away from the surface.
+    // Simultaneous hits on triangles sharing an edge report the one facing the
+    // movement most squarely.
+    bool sweepCapsule(const glm::vec3& a, const glm::vec3& b, float radius, const glm::vec3& movement,
+                      SweepHit& hit) const;
+
+    bool empty() const { return m_nodes.empty(); }
+    size_t getNodeCount() const { return m_nodes.size(); }
+    const Node& getNode(uint32_t index) const { return m_nodes[index]; }
+    size_t getTriangleCount() const { return m_triangles.size(); }
+    const Triangle& getTriangle(int index) const { return m_triangles[index]; }
+    int getDepth() const { return m_depth; }
+    size_t getMemoryUsage() const {
+        return m_nodes.capacity() * sizeof(Node) + m_triangles.capacity() * sizeof(Triangle);
+    }
+
+private:
+    std::vector<Node> m_nodes;
+    std::vector<Triangle> m_triangles;     // In leaf order
+    int m_depth;
+
+    struct BuildItem;
+    void buildNode(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, int depth);
+};
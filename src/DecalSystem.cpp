@@ -0,0 +1,146 @@
+#include "DecalSystem.hpp"
+#include <GL/glew.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstddef>
+
+// Default radius per type, meters
+static const float BULLET_HOLE_RADIUS = 0.05f;
+static const float BLOOD_RADIUS = 0.3f;
+
+// Lift off the surface against z-fighting, on top of the polygon offset
+static const float SURFACE_OFFSET = 0.002f;
+
+DecalSystem::DecalSystem()
+    : m_capacity(0)
+    , m_count(0)
+    , m_next(0)
+    , m_spawned(0)
+    , m_dirtyFirst(-1)
+    , m_dirtyLast(-1)
+    , m_shader(0)
+    , m_VAO(0)
+{
+}
+
+DecalSystem::~DecalSystem() {
+    if (m_VAO) {
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    if (m_shader) {
+        glDeleteProgram(m_shader);
+    }
+}
+
+bool DecalSystem::initialize(unsigned int shader, int capacity) {
+    m_shader = shader;
+    m_capacity = std::max(capacity, 1);
+    m_instances.assign(m_capacity, DecalInstance());
+
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+
+    // Allocated once at full capacity; only changed slots are uploaded afterwards
+    m_instanceBuffer.reset(new VertexBuffer(GL_ARRAY_BUFFER));
+    m_instanceBuffer->setData(nullptr, m_capacity * sizeof(DecalInstance), GL_DYNAMIC_DRAW);
+
+    for (int i = 0; i < 4; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribPointer(i, 4, GL_FLOAT, GL_FALSE, sizeof(DecalInstance), (void*)(i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(i, 1);
+    }
+
+    glBindVertexArray(0);
+    m_instanceBuffer->unbind();
+    return true;
+}
+
+bool DecalSystem::spawn(const Level& level, int surfaceIndex, const glm::vec3& point, const glm::vec3& normal,
+                        DecalType type, float radius) {
+    const std::vector<Level::Surface>& surfaces = level.getSurfaces();
+    if (m_capacity == 0 || surfaceIndex < 0 || surfaceIndex >= static_cast<int>(surfaces.size())) return false;
+    const Level::Surface& surface = surfaces[surfaceIndex];
+
+    if (radius <= 0.0f) {
+        radius = type == DecalType::Blood ? BLOOD_RADIUS : BULLET_HOLE_RADIUS;
+    }
+
+    // Decal axes follow the surface edges, so clipping to the surface is a rectangle intersection
+    float lengthU = glm::length(surface.edgeU);
+    float lengthV = glm::length(surface.edgeV);
+    glm::vec3 directionU = surface.edgeU / lengthU;
+    glm::vec3 directionV = surface.edgeV / lengthV;
+    glm::vec3 local = point - surface.origin;
+    float u = glm::dot(local, directionU);
+    float v = glm::dot(local, directionV);
+
+    glm::vec4 clipRect(std::max(-1.0f, -u / radius),
+                       std::max(-1.0f, -v / radius),
+                       std::min(1.0f, (lengthU - u) / radius),
+                       std::min(1.0f, (lengthV - v) / radius));
+    if (clipRect.x >= clipRect.z || clipRect.y >= clipRect.w) return false;
+
+    // Side of the surface the decal sits on
+    glm::vec3 facing = glm::dot(normal, surface.normal) >= 0.0f ? surface.normal : -surface.normal;
+    glm::vec3 center = surface.origin + directionU * u + directionV * v + facing * SURFACE_OFFSET;
+
+    // Hash of the spawn counter varies the procedural pattern
+    unsigned int hash = (m_spawned++ + 1) * 2654435761u;
+    float seed = (hash >> 8) * (1.0f / 16777216.0f);
+
+    int slot = m_next;
+    DecalInstance& instance = m_instances[slot];
+    instance.centerType = glm::vec4(center, static_cast<float>(type));
+    instance.axisUSeed = glm::vec4(directionU * radius, seed);
+    instance.axisV = glm::vec4(directionV * radius, 0.0f);
+    instance.clipRect = clipRect;
+
+    m_next = (m_next + 1) % m_capacity;
+    m_count = std::min(m_count + 1, m_capacity);
+
+    if (m_dirtyFirst < 0) {
+        m_dirtyFirst = m_dirtyLast = slot;
+    } else {
+        m_dirtyFirst = std::min(m_dirtyFirst, slot);
+        m_dirtyLast = std::max(m_dirtyLast, slot);
+    }
+    return true;
+}
+
+void DecalSystem::clear() {
+    m_count = 0;
+    m_next = 0;
+    m_dirtyFirst = m_dirtyLast = -1;
+}
+
+void DecalSystem::render(const glm::mat4& view, const glm::mat4& projection) {
+    if (m_count == 0 || !m_VAO) return;
+
+    if (m_dirtyFirst >= 0) {
+        m_instanceBuffer->bind();
+        glBufferSubData(GL_ARRAY_BUFFER, m_dirtyFirst * sizeof(DecalInstance),
+                        (m_dirtyLast - m_dirtyFirst + 1) * sizeof(DecalInstance), &m_instances[m_dirtyFirst]);
+        m_instanceBuffer->unbind();
+        m_dirtyFirst = m_dirtyLast = -1;
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(-1.0f, -1.0f);
+
+    glUseProgram(m_shader);
+    glUniformMatrix4fv(glGetUniformLocation(m_shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(m_shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+
+    glBindVertexArray(m_VAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_count);
+    glBindVertexArray(0);
+
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glEnable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
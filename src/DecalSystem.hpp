@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Level.hpp"
+#include "VertexBuffer.hpp"
+
+enum class DecalType {
+    BulletHole = 0,
+    Blood = 1
+};
+
+// Bullet holes and blood on level surfaces.
+// Decals live in a fixed-capacity ring: once full, each new decal overwrites
+// the oldest, so CPU and GPU memory stay constant for the whole match. Each
+// decal is a quad in the plane of a Level surface, clipped on creation to the
+// surface's rectangle so it never hangs over an edge; all of them are drawn
+// with one instanced draw.
+class DecalSystem {
+public:
+    static const int DEFAULT_CAPACITY = 512;
+
+    DecalSystem();
+    ~DecalSystem();
+
+    // Takes ownership of the decal shader program
+    bool initialize(unsigned int shader, int capacity = DEFAULT_CAPACITY);
+
+    // Place a decal on the given level surface, centered at `point` (on the surface)
+    // and facing `normal`. Returns false if nothing of it lies on the surface.
+    bool spawn(const Level& level, int surface, const glm::vec3& point, const glm::vec3& normal,
+               DecalType type, float radius = 0.0f);
+
+    // Remove every decal (new match)
+    void clear();
+
+    void render(const glm::mat4& view, const glm::mat4& projection);
+
+    int getCount() const { return m_count; }
+    int getCapacity() const { return m_capacity; }
+
+private:
+    struct DecalInstance {
+        glm::vec4 centerType;       // xyz + type
+        glm::vec4 axisUSeed;        // Half-extent along U + pattern seed
+        glm::vec4 axisV;            // Half-extent along V
+        glm::vec4 clipRect;         // Visible part in decal space [-1, 1]^2
+    };
+
+    std::vector<DecalInstance> m_instances;
+    int m_capacity;
+    int m_count;
+    int m_next;                     // Slot the next decal overwrites
+    unsigned int m_spawned;
+
+    // Slots changed since the last upload
+    int m_dirtyFirst;
+    int m_dirtyLast;
+
+    unsigned int m_shader;
+    unsigned int m_VAO;
+    std::unique_ptr<VertexBuffer> m_instanceBuffer;
+};
@@ -0,0 +1,61 @@
+#include "FrameArena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+// Frame number the arenas compare against to rewind themselves
+static std::atomic<uint64_t> s_frame(0);
+
+FrameArena::FrameArena(size_t capacity)
+    : m_buffer(new unsigned char[capacity])
+    , m_capacity(capacity)
+    , m_offset(0)
+    , m_peak(0)
+    , m_overflowBytes(0)
+    , m_frame(s_frame.load(std::memory_order_relaxed))
+{
+}
+
+FrameArena& FrameArena::current() {
+    thread_local FrameArena arena;
+    uint64_t frame = s_frame.load(std::memory_order_relaxed);
+    if (arena.m_frame != frame) {
+        arena.reset();
+        arena.m_frame = frame;
+    }
+    return arena;
+}
+
+void FrameArena::beginFrame() {
+    s_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameArena::reset() {
+    // Grow to the last frame's total so the next one fits in a single buffer
+    if (!m_overflow.empty()) {
+        m_capacity = std::max(m_capacity * 2, m_offset + m_overflowBytes);
+        m_buffer.reset(new unsigned char[m_capacity]);
+        m_overflow.clear();
+        m_overflowBytes = 0;
+    }
+    m_offset = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer.get());
+    size_t aligned = ((base + m_offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+    if (aligned + bytes <= m_capacity) {
+        m_offset = aligned + bytes;
+        m_peak = std::max(m_peak, getUsed());
+        return m_buffer.get() + aligned;
+    }
+
+    // Out of space: a heap block for this frame only
+    std::unique_ptr<unsigned char[]> block(new unsigned char[bytes + alignment]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(block.get());
+    address = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    m_overflow.push_back(std::move(block));
+    m_overflowBytes += bytes + alignment;
+    m_peak = std::max(m_peak, getUsed());
+    return reinterpret_cast<void*>(address);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for data that lives for one frame. Every thread has its own
+// arena (FrameArena::current()); beginFrame() starts a new frame for all of them
+// and each arena rewinds lazily on its thread's next use. Deallocation is a no-op.
+// If a frame outgrows the buffer the excess comes from the heap and the buffer is
+// enlarged at the next reset, so a steady-state frame does not touch the heap.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    static const size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // The calling thread's arena, rewound if a new frame has begun
+    static FrameArena& current();
+
+    // Once per frame on the main thread, before any frame work
+    static void beginFrame();
+
+    // Uninitialized storage for count trivially destructible elements
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destructed");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Invalidates everything allocated since the last reset
+    void reset();
+
+    size_t getUsed() const { return m_offset + m_overflowBytes; }
+    size_t getCapacity() const { return m_capacity; }
+    size_t getPeak() const { return m_peak; }
+    int getOverflowCount() const { return static_cast<int>(m_overflow.size()); }
+
+private:
+    std::unique_ptr<unsigned char[]> m_buffer;
+    size_t m_capacity;
+    size_t m_offset;
+    size_t m_peak;
+    std::vector<std::unique_ptr<unsigned char[]>> m_overflow;
+    size_t m_overflowBytes;
+    uint64_t m_frame;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// Read-only range in frame arena memory, valid until its thread's next frame
+template <typename T>
+class FrameView {
+public:
+    FrameView() : m_data(nullptr), m_size(0) {}
+    FrameView(const T* data, size_t size) : m_data(data), m_size(size) {}
+
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const T& operator[](size_t index) const { return m_data[index]; }
+
+private:
+    const T* m_data;
+    size_t m_size;
+};
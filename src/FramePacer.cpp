@@ -0,0 +1,167 @@
+#include "FramePacer.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// Below this, spinning is more accurate than the OS scheduler
+const std::chrono::microseconds SPIN_THRESHOLD(1500);
+
+// Recent latency samples kept for statistics
+const size_t LATENCY_WINDOW = 240;
+
+// Re-sync the GPU/CPU clock mapping every few seconds against drift
+const int CALIBRATION_INTERVAL = 600;
+
+long long toNanoseconds(FramePacer::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+FramePacer::FramePacer()
+    : m_targetFps(0.0)
+    , m_justInTime(false)
+    , m_frameDeadline(Clock::now())
+    , m_lastInputTime(Clock::now())
+    , m_inputTime(Clock::now())
+    , m_hasInputTime(false)
+    , m_frameFence(nullptr)
+    , m_gpuToCpuOffset(0)
+    , m_framesSinceCalibration(CALIBRATION_INTERVAL)
+    , m_latencyIndex(0)
+    , m_lastLatency(0.0)
+{
+    m_latencies.reserve(LATENCY_WINDOW);
+}
+
+FramePacer::~FramePacer() {
+    if (m_frameFence) {
+        glDeleteSync(static_cast<GLsync>(m_frameFence));
+    }
+    for (const auto& frame : m_pending) {
+        glDeleteQueries(1, &frame.timestampQuery);
+    }
+    if (!m_freeQueries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(m_freeQueries.size()), m_freeQueries.data());
+    }
+}
+
+void FramePacer::setTargetFps(double fps) {
+    m_targetFps = std::max(fps, 0.0);
+    m_frameDeadline = Clock::now();
+}
+
+void FramePacer::waitForNextFrame() {
+    // Keep the CPU at most one frame ahead: wait for the previous frame to retire
+    if (m_justInTime && m_frameFence) {
+        GLsync fence = static_cast<GLsync>(m_frameFence);
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+        }
+        glDeleteSync(fence);
+        m_frameFence = nullptr;
+    }
+
+    if (m_targetFps <= 0.0) return;
+
+    // Hybrid wait: sleep for the bulk, spin the last stretch
+    auto now = Clock::now();
+    if (m_frameDeadline > now) {
+        auto remaining = m_frameDeadline - now;
+        if (remaining > SPIN_THRESHOLD) {
+            std::this_thread::sleep_for(remaining - SPIN_THRESHOLD);
+        }
+        while (Clock::now() < m_frameDeadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Schedule the next deadline; resync if we fell more than a frame behind
+    auto framePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFps));
+    m_frameDeadline += framePeriod;
+    now = Clock::now();
+    if (m_frameDeadline < now - framePeriod) {
+        m_frameDeadline = now + framePeriod;
+    }
+}
+
+float FramePacer::markInputSampled() {
+    m_inputTime = Clock::now();
+    float deltaTime = m_hasInputTime ? std::chrono::duration<float>(m_inputTime - m_lastInputTime).count() : 0.0f;
+    m_lastInputTime = m_inputTime;
+    m_hasInputTime = true;
+    return deltaTime;
+}
+
+void FramePacer::endFrame() {
+    if (++m_framesSinceCalibration >= CALIBRATION_INTERVAL) {
+        calibrate();
+    }
+
+    // Timestamp written when the GPU reaches the end of this frame
+    unsigned int query = 0;
+    if (!m_freeQueries.empty()) {
+        query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+    } else {
+        glGenQueries(1, &query);
+    }
+    glQueryCounter(query, GL_TIMESTAMP);
+    m_pending.push_back({query, m_inputTime});
+
+    if (m_justInTime) {
+        if (m_frameFence) glDeleteSync(static_cast<GLsync>(m_frameFence));
+        m_frameFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    collectLatencies();
+}
+
+double FramePacer::getAverageLatency() const {
+    if (m_latencies.empty()) return 0.0;
+    double sum = 0.0;
+    for (double latency : m_latencies) sum += latency;
+    return sum / m_latencies.size();
+}
+
+double FramePacer::getMaxLatency() const {
+    double maxLatency = 0.0;
+    for (double latency : m_latencies) maxLatency = std::max(maxLatency, latency);
+    return maxLatency;
+}
+
+void FramePacer::calibrate() {
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    m_gpuToCpuOffset = toNanoseconds(Clock::now()) - gpuTime;
+    m_framesSinceCalibration = 0;
+}
+
+void FramePacer::collectLatencies() {
+    // Frames retire in order: stop at the first unfinished one
+    size_t finished = 0;
+    for (; finished < m_pending.size(); finished++) {
+        const PendingFrame& frame = m_pending[finished];
+
+        GLint available = 0;
+        glGetQueryObjectiv(frame.timestampQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 gpuTime = 0;
+        glGetQueryObjectui64v(frame.timestampQuery, GL_QUERY_RESULT, &gpuTime);
+        long long completion = static_cast<long long>(gpuTime) + m_gpuToCpuOffset;
+        m_lastLatency = std::max(0.0, (completion - toNanoseconds(frame.inputTime)) / 1.0e6);
+
+        if (m_latencies.size() < LATENCY_WINDOW) {
+            m_latencies.push_back(m_lastLatency);
+        } else {
+            m_latencies[m_latencyIndex] = m_lastLatency;
+            m_latencyIndex = (m_latencyIndex + 1) % LATENCY_WINDOW;
+        }
+
+        m_freeQueries.push_back(frame.timestampQuery);
+    }
+
+    m_pending.erase(m_pending.begin(), m_pending.begin() + finished);
+}
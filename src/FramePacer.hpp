@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+// Frame pacing for the main loop:
+//  - optional frame-rate cap with a hybrid sleep/spin wait
+//  - "just-in-time" mode that waits on a GL fence so the CPU never runs more
+//    than one frame ahead of the GPU
+//  - input-to-GPU-completion latency measured with GL timestamps
+class FramePacer {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    FramePacer();
+    ~FramePacer();
+
+    // 0 = unlimited
+    void setTargetFps(double fps);
+    void setJustInTime(bool enabled) { m_justInTime = enabled; }
+
+    double getTargetFps() const { return m_targetFps; }
+    bool isJustInTime() const { return m_justInTime; }
+
+    // Block until the next frame should start. Call right before sampling input.
+    void waitForNextFrame();
+
+    // Call right after input has been polled; returns the delta time in seconds
+    // between this and the previous input sample.
+    float markInputSampled();
+
+    // Call right after the buffer swap
+    void endFrame();
+
+    // Latency statistics over the recent window, in milliseconds
+    double getLastLatency() const { return m_lastLatency; }
+    double getAverageLatency() const;
+    double getMaxLatency() const;
+
+private:
+    struct PendingFrame {
+        unsigned int timestampQuery;
+        Clock::time_point inputTime;
+    };
+
+    double m_targetFps;
+    bool m_justInTime;
+
+    Clock::time_point m_frameDeadline;
+    Clock::time_point m_lastInputTime;
+    Clock::time_point m_inputTime;
+    bool m_hasInputTime;
+
+    // Fence of the last submitted frame (just-in-time mode)
+    void* m_frameFence;
+
+    // GPU timestamp -> CPU clock mapping
+    long long m_gpuToCpuOffset;
+    int m_framesSinceCalibration;
+
+    std::vector<PendingFrame> m_pending;
+    std::vector<unsigned int> m_freeQueries;
+    std::vector<double> m_latencies;
+    size_t m_latencyIndex;
+    double m_lastLatency;
+
+    void calibrate();
+    void collectLatencies();
+};
@@ -0,0 +1,84 @@
+#include "Framebuffer.hpp"
+#include "MemoryTracker.hpp"
+#include <iostream>
+
+Framebuffer::Framebuffer(int width, int height)
+    : m_framebufferID(0)
+    , m_colorTexture(0)
+    , m_depthRenderbuffer(0)
+    , m_width(width)
+    , m_height(height)
+{
+    create();
+}
+
+Framebuffer::~Framebuffer() {
+    destroy();
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void Framebuffer::unbind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::resize(int width, int height) {
+    if (width == m_width && height == m_height) return;
+
+    destroy();
+    m_width = width;
+    m_height = height;
+    create();
+}
+
+bool Framebuffer::isComplete() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return complete;
+}
+
+void Framebuffer::create() {
+    glGenFramebuffers(1, &m_framebufferID);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+
+    // Color attachment
+    glGenTextures(1, &m_colorTexture);
+    glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Depth/stencil attachment
+    glGenRenderbuffers(1, &m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_width, m_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // RGBA8 color plus 24/8 depth-stencil
+    MemoryTracker::addGpuBytes(MemoryTag::Renderer, int64_t(m_width) * m_height * 8);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Framebuffer " << m_width << "x" << m_height << " is incomplete" << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::destroy() {
+    if (m_colorTexture) MemoryTracker::addGpuBytes(MemoryTag::Renderer, -int64_t(m_width) * m_height * 8);
+    if (m_depthRenderbuffer) glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+    if (m_colorTexture) glDeleteTextures(1, &m_colorTexture);
+    if (m_framebufferID) glDeleteFramebuffers(1, &m_framebufferID);
+    m_depthRenderbuffer = 0;
+    m_colorTexture = 0;
+    m_framebufferID = 0;
+}
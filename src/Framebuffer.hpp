@@ -0,0 +1,34 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// Offscreen render target: RGBA8 color texture + 24-bit depth/stencil renderbuffer
+class Framebuffer {
+public:
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+
+    // Bind as draw target and set the viewport to its size
+    void bind() const;
+    void unbind() const;
+
+    // Reallocate attachments (no-op if the size is unchanged)
+    void resize(int width, int height);
+
+    bool isComplete() const;
+
+    unsigned int getID() const { return m_framebufferID; }
+    unsigned int getColorTexture() const { return m_colorTexture; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+private:
+    unsigned int m_framebufferID;
+    unsigned int m_colorTexture;
+    unsigned int m_depthRenderbuffer;
+    int m_width;
+    int m_height;
+
+    void create();
+    void destroy();
+};
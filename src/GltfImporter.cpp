@@ -0,0 +1,681 @@
+#include "GltfImporter.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+const uint32_t GLB_MAGIC = 0x46546C67;        // "glTF"
+const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+const int MAX_JSON_DEPTH = 64;
+const int MAX_NODE_DEPTH = 64;
+
+// Accessor component types
+const int COMPONENT_BYTE = 5120;
+const int COMPONENT_UNSIGNED_BYTE = 5121;
+const int COMPONENT_SHORT = 5122;
+const int COMPONENT_UNSIGNED_SHORT = 5123;
+const int COMPONENT_UNSIGNED_INT = 5125;
+const int COMPONENT_FLOAT = 5126;
+const int MODE_TRIANGLES = 4;
+
+// Just enough JSON for glTF: a document tree with objects kept as key/value arrays
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;       // Array elements or object values
+    std::vector<std::string> keys;      // Object keys, parallel to items
+
+    const JsonValue* find(const char* key) const {
+        if (type != Type::Object) return nullptr;
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == key) return &items[i];
+        }
+        return nullptr;
+    }
+
+    const JsonValue* at(int index) const {
+        if (type != Type::Array || index < 0 || static_cast<size_t>(index) >= items.size()) return nullptr;
+        return &items[index];
+    }
+
+    // Element of an array member, e.g. root.get("accessors", 3)
+    const JsonValue* get(const char* key, int index) const {
+        const JsonValue* array = find(key);
+        return array ? array->at(index) : nullptr;
+    }
+
+    double getNumber(const char* key, double fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Type::Number ? value->number : fallback;
+    }
+
+    int getInt(const char* key, int fallback) const {
+        return static_cast<int>(getNumber(key, fallback));
+    }
+
+    std::string getString(const char* key) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Type::String ? value->string : std::string();
+    }
+};
+
+class JsonParser {
+public:
+    JsonParser(const char* data, size_t size)
+        : m_pos(data)
+        , m_end(data + size)
+    {
+    }
+
+    bool parse(JsonValue& value) {
+        if (!parseValue(value, 0)) return false;
+        skipWhitespace();
+        return m_pos == m_end;
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+
+    void skipWhitespace() {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r')) m_pos++;
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == c) {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeLiteral(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (static_cast<size_t>(m_end - m_pos) < length || std::memcmp(m_pos, literal, length) != 0) return false;
+        m_pos += length;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        skipWhitespace();
+        if (m_pos >= m_end || depth > MAX_JSON_DEPTH) return false;
+
+        if (*m_pos == '{') {
+            m_pos++;
+            value.type = JsonValue::Type::Object;
+            if (consume('}')) return true;
+            do {
+                std::string key;
+                skipWhitespace();
+                if (!parseString(key) || !consume(':')) return false;
+                value.keys.push_back(std::move(key));
+                value.items.emplace_back();
+                if (!parseValue(value.items.back(), depth + 1)) return false;
+            } while (consume(','));
+            return consume('}');
+        }
+        if (*m_pos == '[') {
+            m_pos++;
+            value.type = JsonValue::Type::Array;
+            if (consume(']')) return true;
+            do {
+                value.items.emplace_back();
+                if (!parseValue(value.items.back(), depth + 1)) return false;
+            } while (consume(','));
+            return consume(']');
+        }
+        if (*m_pos == '"') {
+            value.type = JsonValue::Type::String;
+            return parseString(value.string);
+        }
+        if (consumeLiteral("true")) {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+            return true;
+        }
+        if (consumeLiteral("false")) {
+            value.type = JsonValue::Type::Bool;
+            return true;
+        }
+        if (consumeLiteral("null")) return true;
+        return parseNumber(value);
+    }
+
+    // The buffer is not null-terminated, so numbers are copied out before strtod
+    bool parseNumber(JsonValue& value) {
+        char digits[64];
+        size_t length = 0;
+        while (m_pos + length < m_end && length + 1 < sizeof(digits) &&
+               std::strchr("+-0123456789.eE", m_pos[length]) && m_pos[length] != '\0') {
+            digits[length] = m_pos[length];
+            length++;
+        }
+        if (length == 0) return false;
+        digits[length] = '\0';
+
+        char* end = nullptr;
+        value.type = JsonValue::Type::Number;
+        value.number = std::strtod(digits, &end);
+        m_pos += length;
+        return end == digits + length;
+    }
+
+    bool parseString(std::string& out) {
+        if (m_pos >= m_end || *m_pos != '"') return false;
+        m_pos++;
+        while (m_pos < m_end && *m_pos != '"') {
+            char c = *m_pos++;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_pos >= m_end) return false;
+            char escape = *m_pos++;
+            switch (escape) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (m_end - m_pos < 4) return false;
+                char hex[5] = { m_pos[0], m_pos[1], m_pos[2], m_pos[3], '\0' };
+                unsigned long code = std::strtoul(hex, nullptr, 16);
+                m_pos += 4;
+                // UTF-8; surrogate pairs are not combined (names and URIs only)
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: out += escape; break;
+            }
+        }
+        if (m_pos >= m_end) return false;
+        m_pos++;
+        return true;
+    }
+};
+
+uint32_t readU32(const unsigned char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+struct BufferData {
+    const unsigned char* data;
+    size_t size;
+};
+
+// Strided view of an accessor's elements inside a buffer
+struct Accessor {
+    const unsigned char* data = nullptr;
+    size_t stride = 0;
+    size_t count = 0;
+    int componentType = 0;
+    int components = 0;
+    bool normalized = false;
+};
+
+int componentSize(int componentType) {
+    switch (componentType) {
+    case COMPONENT_BYTE:
+    case COMPONENT_UNSIGNED_BYTE: return 1;
+    case COMPONENT_SHORT:
+    case COMPONENT_UNSIGNED_SHORT: return 2;
+    case COMPONENT_UNSIGNED_INT:
+    case COMPONENT_FLOAT: return 4;
+    }
+    return 0;
+}
+
+int componentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0;
+}
+
+bool resolveAccessor(const JsonValue& root, const std::vector<BufferData>& buffers, int index,
+                     Accessor& accessor, std::string& error) {
+    const JsonValue* source = root.get("accessors", index);
+    if (!source) {
+        error = "missing accessor " + std::to_string(index);
+        return false;
+    }
+    if (source->find("sparse")) {
+        error = "sparse accessors are not supported";
+        return false;
+    }
+    const JsonValue* view = root.get("bufferViews", source->getInt("bufferView", -1));
+    if (!view) {
+        error = "accessor " + std::to_string(index) + " has no buffer view";
+        return false;
+    }
+    int buffer = view->getInt("buffer", -1);
+    if (buffer < 0 || static_cast<size_t>(buffer) >= buffers.size()) {
+        error = "buffer view refers to a missing buffer";
+        return false;
+    }
+
+    accessor.componentType = source->getInt("componentType", 0);
+    accessor.components = componentCount(source->getString("type"));
+    accessor.normalized = source->find("normalized") && source->find("normalized")->boolean;
+    accessor.count = static_cast<size_t>(source->getNumber("count", 0));
+
+    const uint64_t elementSize = uint64_t(componentSize(accessor.componentType)) * accessor.components;
+    const uint64_t viewOffset = static_cast<uint64_t>(view->getNumber("byteOffset", 0));
+    const uint64_t viewLength = static_cast<uint64_t>(view->getNumber("byteLength", 0));
+    const uint64_t offset = viewOffset + static_cast<uint64_t>(source->getNumber("byteOffset", 0));
+    accessor.stride = static_cast<size_t>(view->getNumber("byteStride", 0));
+    if (accessor.stride == 0) accessor.stride = static_cast<size_t>(elementSize);
+
+    // Every element inside its view, every view inside its buffer
+    bool valid = elementSize > 0 && accessor.stride >= elementSize &&
+                 viewOffset + viewLength <= buffers[buffer].size;
+    if (valid && accessor.count > 0) {
+        valid = offset + uint64_t(accessor.stride) * (accessor.count - 1) + elementSize <= viewOffset + viewLength;
+    }
+    if (!valid) {
+        error = "accessor " + std::to_string(index) + " is out of bounds";
+        return false;
+    }
+    accessor.data = buffers[buffer].data + offset;
+    return true;
+}
+
+float readComponent(const unsigned char* data, int componentType, bool normalized) {
+    switch (componentType) {
+    case COMPONENT_FLOAT: {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    case COMPONENT_UNSIGNED_BYTE:
+        return normalized ? data[0] / 255.0f : data[0];
+    case COMPONENT_BYTE: {
+        float value = static_cast<int8_t>(data[0]);
+        return normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case COMPONENT_UNSIGNED_SHORT: {
+        uint16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return normalized ? value / 65535.0f : value;
+    }
+    case COMPONENT_SHORT: {
+        int16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    case COMPONENT_UNSIGNED_INT: {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return static_cast<float>(value);
+    }
+    }
+    return 0.0f;
+}
+
+template <int N>
+glm::vec<N, float> readVector(const Accessor& accessor, size_t index) {
+    glm::vec<N, float> value(0.0f);
+    const unsigned char* element = accessor.data + index * accessor.stride;
+    const int size = componentSize(accessor.componentType);
+    for (int i = 0; i < N && i < accessor.components; i++) {
+        value[i] = readComponent(element + i * size, accessor.componentType, accessor.normalized);
+    }
+    return value;
+}
+
+uint32_t readIndex(const Accessor& accessor, size_t index) {
+    const unsigned char* element = accessor.data + index * accessor.stride;
+    switch (accessor.componentType) {
+    case COMPONENT_UNSIGNED_BYTE:
+        return element[0];
+    case COMPONENT_UNSIGNED_SHORT: {
+        uint16_t value;
+        std::memcpy(&value, element, sizeof(value));
+        return value;
+    }
+    default:
+        return readU32(element);
+    }
+}
+
+glm::mat4 nodeTransform(const JsonValue& node) {
+    const JsonValue* matrix = node.find("matrix");
+    if (matrix && matrix->items.size() == 16) {
+        float values[16];
+        for (int i = 0; i < 16; i++) values[i] = static_cast<float>(matrix->items[i].number);
+        return glm::make_mat4(values);     // Column-major, like glTF
+    }
+
+    auto readFloats = [&node](const char* key, float* out, size_t count) {
+        const JsonValue* array = node.find(key);
+        if (!array || array->items.size() != count) return;
+        for (size_t i = 0; i < count; i++) out[i] = static_cast<float>(array->items[i].number);
+    };
+    float translation[3] = { 0.0f, 0.0f, 0.0f };
+    float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };   // x, y, z, w
+    float scale[3] = { 1.0f, 1.0f, 1.0f };
+    readFloats("translation", translation, 3);
+    readFloats("rotation", rotation, 4);
+    readFloats("scale", scale, 3);
+
+    glm::quat orientation(rotation[3], rotation[0], rotation[1], rotation[2]);
+    glm::mat4 transform = glm::mat4_cast(glm::normalize(orientation));
+    transform[3] = glm::vec4(translation[0], translation[1], translation[2], 1.0f);
+    transform[0] *= scale[0];
+    transform[1] *= scale[1];
+    transform[2] *= scale[2];
+    return transform;
+}
+
+// One primitive placed by one node
+struct Instance {
+    const JsonValue* primitive;
+    glm::mat4 transform;
+};
+
+void addMeshInstances(const JsonValue& root, int meshIndex, const glm::mat4& transform, std::vector<Instance>& instances) {
+    const JsonValue* mesh = root.get("meshes", meshIndex);
+    const JsonValue* primitives = mesh ? mesh->find("primitives") : nullptr;
+    if (!primitives) return;
+    for (const auto& primitive : primitives->items) {
+        instances.push_back({ &primitive, transform });
+    }
+}
+
+void collectInstances(const JsonValue& root, int nodeIndex, const glm::mat4& parent, int depth,
+                      std::vector<Instance>& instances) {
+    const JsonValue* node = root.get("nodes", nodeIndex);
+    if (!node || depth > MAX_NODE_DEPTH) return;
+
+    glm::mat4 transform = parent * nodeTransform(*node);
+    addMeshInstances(root, node->getInt("mesh", -1), transform, instances);
+
+    const JsonValue* children = node->find("children");
+    if (!children) return;
+    for (const auto& child : children->items) {
+        collectInstances(root, static_cast<int>(child.number), transform, depth + 1, instances);
+    }
+}
+
+struct Decoded {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    bool skipped = false;       // Points and lines
+    std::string error;
+};
+
+bool decodePrimitive(const JsonValue& root, const std::vector<BufferData>& buffers, const Instance& instance,
+                     Decoded& out) {
+    const JsonValue& primitive = *instance.primitive;
+    if (primitive.getInt("mode", MODE_TRIANGLES) != MODE_TRIANGLES) {
+        out.skipped = true;
+        return true;
+    }
+
+    const JsonValue* attributes = primitive.find("attributes");
+    int positionIndex = attributes ? attributes->getInt("POSITION", -1) : -1;
+    if (positionIndex < 0) {
+        out.error = "primitive without positions";
+        return false;
+    }
+
+    Accessor positions;
+    Accessor normals;
+    Accessor texCoords;
+    if (!resolveAccessor(root, buffers, positionIndex, positions, out.error)) return false;
+    if (positions.components != 3) {
+        out.error = "positions must be VEC3";
+        return false;
+    }
+
+    const size_t count = positions.count;
+    int normalIndex = attributes->getInt("NORMAL", -1);
+    int texCoordIndex = attributes->getInt("TEXCOORD_0", -1);
+    bool hasNormals = normalIndex >= 0;
+    bool hasTexCoords = texCoordIndex >= 0;
+    if (hasNormals && !resolveAccessor(root, buffers, normalIndex, normals, out.error)) return false;
+    if (hasTexCoords && !resolveAccessor(root, buffers, texCoordIndex, texCoords, out.error)) return false;
+    if ((hasNormals && normals.count != count) || (hasTexCoords && texCoords.count != count)) {
+        out.error = "attribute counts differ";
+        return false;
+    }
+
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(instance.transform)));
+    out.vertices.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        Vertex& vertex = out.vertices[i];
+        vertex.position = glm::vec3(instance.transform * glm::vec4(readVector<3>(positions, i), 1.0f));
+        vertex.normal = hasNormals ? normalMatrix * readVector<3>(normals, i) : glm::vec3(0.0f);
+        vertex.texCoords = hasTexCoords ? readVector<2>(texCoords, i) : glm::vec2(0.0f);
+    }
+
+    int indicesIndex = primitive.getInt("indices", -1);
+    if (indicesIndex >= 0) {
+        Accessor indices;
+        if (!resolveAccessor(root, buffers, indicesIndex, indices, out.error)) return false;
+        if (indices.components != 1 || indices.componentType == COMPONENT_FLOAT ||
+            indices.componentType == COMPONENT_BYTE || indices.componentType == COMPONENT_SHORT) {
+            out.error = "invalid index accessor";
+            return false;
+        }
+        out.indices.resize(indices.count);
+        for (size_t i = 0; i < indices.count; i++) {
+            out.indices[i] = readIndex(indices, i);
+            if (out.indices[i] >= count) {
+                out.error = "index out of range";
+                return false;
+            }
+        }
+    } else {
+        out.indices.resize(count);
+        for (size_t i = 0; i < count; i++) out.indices[i] = static_cast<unsigned int>(i);
+    }
+    out.indices.resize(out.indices.size() / 3 * 3);
+
+    // Mirroring transforms flip the winding
+    if (glm::determinant(glm::mat3(instance.transform)) < 0.0f) {
+        for (size_t i = 0; i < out.indices.size(); i += 3) std::swap(out.indices[i + 1], out.indices[i + 2]);
+    }
+
+    // Area-weighted vertex normals when the file has none
+    if (!hasNormals) {
+        for (size_t i = 0; i < out.indices.size(); i += 3) {
+            Vertex& a = out.vertices[out.indices[i]];
+            Vertex& b = out.vertices[out.indices[i + 1]];
+            Vertex& c = out.vertices[out.indices[i + 2]];
+            glm::vec3 faceNormal = glm::cross(b.position - a.position, c.position - a.position);
+            a.normal += faceNormal;
+            b.normal += faceNormal;
+            c.normal += faceNormal;
+        }
+    }
+    for (auto& vertex : out.vertices) {
+        float length = glm::length(vertex.normal);
+        vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+    return true;
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+} // namespace
+
+int GltfImporter::addTexture(const std::string& path) {
+    auto it = m_textureIndices.find(path);
+    if (it != m_textureIndices.end()) return it->second;
+
+    int index = static_cast<int>(m_textures.size());
+    m_textures.push_back({ GpuHandle(), "texture_diffuse", path });
+    m_textureIndices[path] = index;
+    return index;
+}
+
+bool GltfImporter::load(const std::string& path, std::vector<Mesh>& meshes, ThreadPool* pool) {
+    auto start = std::chrono::steady_clock::now();
+    auto fail = [&path](const std::string& message) {
+        std::cerr << "GltfImporter: " << path << ": " << message << std::endl;
+        return false;
+    };
+
+    MappedFile file;
+    if (!file.open(path)) return false;
+    const unsigned char* data = file.getData();
+    const size_t size = file.getSize();
+
+    // .glb: header, JSON chunk, optional BIN chunk. Anything else is .gltf text.
+    const char* json = reinterpret_cast<const char*>(data);
+    size_t jsonSize = size;
+    BufferData binary = { nullptr, 0 };
+    if (size >= 12 && readU32(data) == GLB_MAGIC) {
+        if (readU32(data + 4) != 2 || readU32(data + 8) > size) return fail("unsupported or truncated .glb");
+        const size_t length = readU32(data + 8);
+        json = nullptr;
+        for (size_t offset = 12; offset + 8 <= length;) {
+            const size_t chunkLength = readU32(data + offset);
+            const uint32_t chunkType = readU32(data + offset + 4);
+            if (chunkLength > length - offset - 8) return fail("corrupt chunk");
+            if (chunkType == GLB_CHUNK_JSON && !json) {
+                json = reinterpret_cast<const char*>(data + offset + 8);
+                jsonSize = chunkLength;
+            } else if (chunkType == GLB_CHUNK_BIN && !binary.data) {
+                binary = { data + offset + 8, chunkLength };
+            }
+            offset += 8 + chunkLength;
+        }
+        if (!json) return fail("no JSON chunk");
+    }
+
+    JsonValue root;
+    JsonParser parser(json, jsonSize);
+    if (!parser.parse(root) || root.type != JsonValue::Type::Object) return fail("invalid JSON");
+    const JsonValue* asset = root.find("asset");
+    if (!asset || asset->getString("version").compare(0, 1, "2") != 0) return fail("not a glTF 2.0 asset");
+
+    // Buffers: the GLB chunk or external files, all mapped
+    Stats stats;
+    stats.files = 1;
+    stats.bytes = size;
+    std::vector<BufferData> buffers;
+    std::vector<MappedFile> externalFiles;
+    const JsonValue* bufferList = root.find("buffers");
+    const size_t bufferCount = bufferList ? bufferList->items.size() : 0;
+    externalFiles.reserve(bufferCount);
+    for (size_t i = 0; i < bufferCount; i++) {
+        const JsonValue& buffer = bufferList->items[i];
+        const size_t byteLength = static_cast<size_t>(buffer.getNumber("byteLength", 0));
+        const std::string uri = buffer.getString("uri");
+        if (uri.empty()) {
+            if (i != 0 || !binary.data || binary.size < byteLength) return fail("missing binary chunk");
+            buffers.push_back({ binary.data, byteLength });
+            continue;
+        }
+        if (uri.compare(0, 5, "data:") == 0) return fail("embedded data URIs are not supported");
+
+        externalFiles.emplace_back();
+        if (!externalFiles.back().open(directoryOf(path) + uri)) return false;
+        if (externalFiles.back().getSize() < byteLength) return fail(uri + " is truncated");
+        buffers.push_back({ externalFiles.back().getData(), byteLength });
+        stats.bytes += externalFiles.back().getSize();
+    }
+
+    // Scene graph -> primitive instances with world transforms
+    std::vector<Instance> instances;
+    const JsonValue* scene = root.get("scenes", root.getInt("scene", 0));
+    const JsonValue* sceneNodes = scene ? scene->find("nodes") : nullptr;
+    if (sceneNodes) {
+        for (const auto& node : sceneNodes->items) {
+            collectInstances(root, static_cast<int>(node.number), glm::mat4(1.0f), 0, instances);
+        }
+    } else {
+        const JsonValue* meshList = root.find("meshes");
+        for (size_t i = 0; meshList && i < meshList->items.size(); i++) {
+            addMeshInstances(root, static_cast<int>(i), glm::mat4(1.0f), instances);
+        }
+    }
+
+    // Materials -> deduplicated base color texture records
+    std::vector<int> materialTextures;
+    const JsonValue* materials = root.find("materials");
+    for (size_t i = 0; materials && i < materials->items.size(); i++) {
+        const JsonValue* pbr = materials->items[i].find("pbrMetallicRoughness");
+        const JsonValue* baseColor = pbr ? pbr->find("baseColorTexture") : nullptr;
+        const JsonValue* texture = baseColor ? root.get("textures", baseColor->getInt("index", -1)) : nullptr;
+        const int imageIndex = texture ? texture->getInt("source", -1) : -1;
+        const JsonValue* image = root.get("images", imageIndex);
+        if (!image) {
+            materialTextures.push_back(-1);
+            continue;
+        }
+        // Images inside the file are named after it
+        const std::string uri = image->getString("uri");
+        const bool external = !uri.empty() && uri.compare(0, 5, "data:") != 0;
+        materialTextures.push_back(addTexture(external ? directoryOf(path) + uri
+                                                       : path + "#image" + std::to_string(imageIndex)));
+    }
+
+    std::vector<Decoded> decoded(instances.size());
+    auto decode = [&](int i) {
+        decodePrimitive(root, buffers, instances[i], decoded[i]);
+    };
+    if (pool) {
+        pool->parallelFor(static_cast<int>(instances.size()), decode);
+    } else {
+        for (int i = 0; i < static_cast<int>(instances.size()); i++) decode(i);
+    }
+
+    for (const auto& result : decoded) {
+        if (!result.error.empty()) return fail(result.error);
+    }
+
+    meshes.reserve(meshes.size() + decoded.size());
+    for (size_t i = 0; i < decoded.size(); i++) {
+        if (decoded[i].skipped || decoded[i].indices.empty()) continue;
+        stats.primitives++;
+        stats.vertices += decoded[i].vertices.size();
+        stats.indices += decoded[i].indices.size();
+
+        Mesh mesh;
+        mesh.setVertices(std::move(decoded[i].vertices));
+        mesh.setIndices(std::move(decoded[i].indices));
+        const int material = instances[i].primitive->getInt("material", -1);
+        if (material >= 0 && static_cast<size_t>(material) < materialTextures.size() && materialTextures[material] >= 0) {
+            mesh.setTextures({ m_textures[materialTextures[material]] });
+        }
+        meshes.push_back(std::move(mesh));
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_stats += stats;
+    return true;
+}
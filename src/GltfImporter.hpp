@@ -0,0 +1,56 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Mesh.hpp"
+
+class ThreadPool;
+
+// glTF 2.0 reader (binary .glb, or .gltf with external .bin buffers). Files are
+// memory-mapped; the node hierarchy of the default scene is flattened and every
+// triangle primitive becomes one mesh with its node transform baked in.
+// Accessors are decoded straight into presized Vertex/index arrays, one primitive
+// per thread-pool task. Base color textures are deduplicated into Texture records
+// (path only; GL textures are created by whoever draws them).
+class GltfImporter {
+public:
+    struct Stats {
+        int files = 0;
+        size_t bytes = 0;           // .glb/.gltf plus external buffers
+        int primitives = 0;
+        size_t vertices = 0;
+        size_t indices = 0;
+        double seconds = 0.0;
+
+        double getMegabytesPerSecond() const {
+            return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+        }
+
+        Stats& operator+=(const Stats& other) {
+            files += other.files;
+            bytes += other.bytes;
+            primitives += other.primitives;
+            vertices += other.vertices;
+            indices += other.indices;
+            seconds += other.seconds;
+            return *this;
+        }
+    };
+
+    // Appends the file's meshes. Decodes in parallel when a pool is given.
+    bool load(const std::string& path, std::vector<Mesh>& meshes, ThreadPool* pool = nullptr);
+
+    // Unique texture records over every file loaded by this importer
+    const std::vector<Texture>& getTextures() const { return m_textures; }
+
+    // Totals over every load
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    std::vector<Texture> m_textures;
+    std::map<std::string, int> m_textureIndices;    // By path
+    Stats m_stats;
+
+    int addTexture(const std::string& path);
+};
@@ -0,0 +1,180 @@
+#include "GlyphAtlas.hpp"
+#include "MemoryTracker.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 5x7 bitmap font, one byte per row, bit 4 = leftmost dot
+struct GlyphBitmap {
+    char character;
+    unsigned char rows[7];
+};
+
+const GlyphBitmap FONT[] = {
+    { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+    { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+    { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+    { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+    { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+    { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+    { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+    { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+    { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+    { 'A', { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+    { 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+    { 'D', { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+    { 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+    { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+    { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+    { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+    { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+    { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+    { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+    { 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+    { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+    { 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+    { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+    { 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+    { 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+    { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+    { 'Y', { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 } },
+    { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+    { '!', { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 } },
+    { '#', { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A } },
+    { '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } },
+    { '\'', { 0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 } },
+    { '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+    { ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+    { '+', { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 } },
+    { ',', { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 } },
+    { '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+    { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+    { '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+    { ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } },
+    { '<', { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 } },
+    { '=', { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 } },
+    { '>', { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 } },
+    { '?', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 } },
+    { '[', { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E } },
+    { ']', { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E } },
+    { '_', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F } },
+    { '|', { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+    { 127, { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F } },
+};
+
+bool dotSet(const unsigned char rows[7], int column, int row) {
+    if (column < 0 || column >= 5 || row < 0 || row >= 7) return false;
+    return (rows[row] >> (4 - column)) & 1;
+}
+
+// Distance from p to the unit square at (column, row), in dots
+float squareDistance(float px, float py, int column, int row) {
+    float dx = std::max(std::max(column - px, px - (column + 1)), 0.0f);
+    float dy = std::max(std::max(row - py, py - (row + 1)), 0.0f);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// Signed distance (positive inside) from p to the union of set dots
+float glyphDistance(const unsigned char rows[7], float px, float py) {
+    int column = static_cast<int>(std::floor(px));
+    int row = static_cast<int>(std::floor(py));
+    bool inside = dotSet(rows, column, row);
+
+    // Nearest dot of the opposite state; everything outside the 5x7 grid is empty
+    float nearest = 1e9f;
+    for (int r = -1; r <= 7; r++) {
+        for (int c = -1; c <= 5; c++) {
+            if (dotSet(rows, c, r) != inside) {
+                nearest = std::min(nearest, squareDistance(px, py, c, r));
+            }
+        }
+    }
+    return inside ? nearest : -nearest;
+}
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas()
+    : m_texture(0)
+    , m_width(COLUMNS * CELL_WIDTH)
+    , m_height(((LAST_CHAR - FIRST_CHAR) / COLUMNS + 1) * CELL_HEIGHT)
+{
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    if (m_texture) {
+        glDeleteTextures(1, &m_texture);
+        MemoryTracker::addGpuBytes(MemoryTag::Renderer, -int64_t(m_width) * m_height);
+    }
+}
+
+void GlyphAtlas::build() {
+    m_pixels.assign(static_cast<size_t>(m_width) * m_height, 0);
+
+    for (const GlyphBitmap& glyph : FONT) {
+        int index = glyph.character - FIRST_CHAR;
+        int cellX = (index % COLUMNS) * CELL_WIDTH;
+        int cellY = (index / COLUMNS) * CELL_HEIGHT;
+
+        for (int y = 0; y < CELL_HEIGHT; y++) {
+            for (int x = 0; x < CELL_WIDTH; x++) {
+                // Pixel center in dot units, relative to the glyph's top-left dot
+                float px = (x + 0.5f - PADDING) / PIXELS_PER_DOT;
+                float py = (y + 0.5f - PADDING) / PIXELS_PER_DOT;
+                float distance = glyphDistance(glyph.rows, px, py) * PIXELS_PER_DOT;
+
+                // 0.5 on the edge, 0/1 at the padding distance
+                float value = 0.5f + 0.5f * distance / PADDING;
+                value = std::min(std::max(value, 0.0f), 1.0f);
+                m_pixels[static_cast<size_t>(cellY + y) * m_width + cellX + x] =
+                    static_cast<unsigned char>(value * 255.0f + 0.5f);
+            }
+        }
+    }
+}
+
+bool GlyphAtlas::upload() {
+    if (m_pixels.empty()) return false;
+
+    if (!m_texture) {
+        glGenTextures(1, &m_texture);
+        MemoryTracker::addGpuBytes(MemoryTag::Renderer, int64_t(m_width) * m_height);
+    }
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_width, m_height, 0, GL_RED, GL_UNSIGNED_BYTE, m_pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+glm::vec4 GlyphAtlas::getGlyphRect(char c) const {
+    int code = static_cast<unsigned char>(c);
+    if (code >= 'a' && code <= 'z') code -= 'a' - 'A';
+    if (code < FIRST_CHAR || code > LAST_CHAR) code = '?';
+
+    int index = code - FIRST_CHAR;
+    float u0 = static_cast<float>((index % COLUMNS) * CELL_WIDTH) / m_width;
+    float v0 = static_cast<float>((index / COLUMNS) * CELL_HEIGHT) / m_height;
+    return glm::vec4(u0, v0, u0 + static_cast<float>(CELL_WIDTH) / m_width,
+                     v0 + static_cast<float>(CELL_HEIGHT) / m_height);
+}
+
+glm::vec2 GlyphAtlas::getSolidTexCoord() const {
+    glm::vec4 rect = getGlyphRect(127);
+    return glm::vec2((rect.x + rect.z) * 0.5f, (rect.y + rect.w) * 0.5f);
+}
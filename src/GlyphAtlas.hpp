@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Signed-distance-field atlas of the built-in 5x7 HUD font.
+// Printable ASCII (32-127) is laid out on a 16-column grid; lowercase letters
+// render with the uppercase glyphs and cell 127 is a solid block used for
+// untextured quads.
+class GlyphAtlas {
+public:
+    static const int FIRST_CHAR = 32;
+    static const int LAST_CHAR = 127;
+    static const int COLUMNS = 16;
+    static const int PIXELS_PER_DOT = 4;        // Atlas pixels per font dot
+    static const int PADDING = 4;               // Distance field spread around each glyph
+    static const int CELL_WIDTH = 5 * PIXELS_PER_DOT + 2 * PADDING;
+    static const int CELL_HEIGHT = 7 * PIXELS_PER_DOT + 2 * PADDING;
+    static const int ADVANCE = 6 * PIXELS_PER_DOT;
+    static const int CAP_HEIGHT = 7 * PIXELS_PER_DOT;
+
+    GlyphAtlas();
+    ~GlyphAtlas();
+
+    // Rasterize the distance field (CPU only)
+    void build();
+
+    // Upload the built atlas as an R8 texture
+    bool upload();
+
+    unsigned int getTexture() const { return m_texture; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    const std::vector<unsigned char>& getPixels() const { return m_pixels; }
+
+    // Atlas UV rectangle (u0, v0, u1, v1) of a character's cell
+    glm::vec4 getGlyphRect(char c) const;
+
+    // UV inside the solid block cell
+    glm::vec2 getSolidTexCoord() const;
+
+private:
+    unsigned int m_texture;
+    int m_width;
+    int m_height;
+    std::vector<unsigned char> m_pixels;
+};
@@ -0,0 +1,134 @@
+#include "GpuResourceRegistry.hpp"
+#include <utility>
+
+namespace {
+const uint32_t NONE = 0xFFFFFFFFu;
+}
+
+GpuResourceRegistry& GpuResourceRegistry::get() {
+    static GpuResourceRegistry registry;
+    return registry;
+}
+
+GpuResourceRegistry::GpuResourceRegistry()
+    : m_freeHead(NONE)
+    , m_liveCount(0)
+    , m_currentGroup(0)
+    , m_nextGroup(1)
+{
+}
+
+GpuResourceRegistry::GroupScope::GroupScope(uint32_t group)
+    : m_previous(GpuResourceRegistry::get().m_currentGroup)
+{
+    GpuResourceRegistry::get().m_currentGroup = group;
+}
+
+GpuResourceRegistry::GroupScope::~GroupScope() {
+    GpuResourceRegistry::get().m_currentGroup = m_previous;
+}
+
+uint32_t GpuResourceRegistry::createGroup() {
+    return m_nextGroup++;
+}
+
+GpuHandle GpuResourceRegistry::create(GpuResourceType type) {
+    unsigned int name = 0;
+    switch (type) {
+        case GpuResourceType::Buffer: glGenBuffers(1, &name); break;
+        case GpuResourceType::VertexArray: glGenVertexArrays(1, &name); break;
+        case GpuResourceType::Texture: glGenTextures(1, &name); break;
+    }
+    if (name == 0) return GpuHandle();
+
+    uint32_t index = m_freeHead;
+    if (index != NONE) {
+        m_freeHead = m_slots[index].nextFree;
+    } else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back(Slot{ 0, 1, 0, NONE, type });
+    }
+
+    Slot& slot = m_slots[index];
+    slot.name = name;
+    slot.group = m_currentGroup;
+    slot.type = type;
+    m_liveCount++;
+
+    GpuHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+void GpuResourceRegistry::release(GpuHandle handle) {
+    if (isAlive(handle)) releaseSlot(handle.index);
+}
+
+void GpuResourceRegistry::releaseGroup(uint32_t group) {
+    if (group == 0) return;
+    for (uint32_t i = 0; i < m_slots.size(); i++) {
+        if (m_slots[i].name != 0 && m_slots[i].group == group) releaseSlot(i);
+    }
+}
+
+void GpuResourceRegistry::releaseSlot(uint32_t index) {
+    Slot& slot = m_slots[index];
+    m_released.push_back(Released{ slot.name, slot.type });
+
+    // The GL name stays reserved until deleted, so the slot can be reused at once
+    slot.name = 0;
+    slot.generation = slot.generation == 0xFFFFFFFFu ? 1 : slot.generation + 1;
+    slot.nextFree = m_freeHead;
+    m_freeHead = index;
+    m_liveCount--;
+}
+
+void GpuResourceRegistry::endFrame() {
+    if (!m_released.empty()) {
+        Batch batch;
+        batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        batch.names.swap(m_released);
+        m_batches.push_back(std::move(batch));
+    }
+
+    // Fences signal in order: stop at the first frame still in flight
+    size_t done = 0;
+    while (done < m_batches.size()) {
+        GLenum status = glClientWaitSync(m_batches[done].fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) break;
+        deleteNames(m_batches[done].names);
+        glDeleteSync(m_batches[done].fence);
+        done++;
+    }
+    if (done > 0) m_batches.erase(m_batches.begin(), m_batches.begin() + done);
+}
+
+void GpuResourceRegistry::flush() {
+    glFinish();
+    for (Batch& batch : m_batches) {
+        deleteNames(batch.names);
+        glDeleteSync(batch.fence);
+    }
+    m_batches.clear();
+    deleteNames(m_released);
+    m_released.clear();
+}
+
+size_t GpuResourceRegistry::getPendingCount() const {
+    size_t count = m_released.size();
+    for (const Batch& batch : m_batches) {
+        count += batch.names.size();
+    }
+    return count;
+}
+
+void GpuResourceRegistry::deleteNames(const std::vector<Released>& names) {
+    for (const Released& released : names) {
+        switch (released.type) {
+            case GpuResourceType::Buffer: glDeleteBuffers(1, &released.name); break;
+            case GpuResourceType::VertexArray: glDeleteVertexArrays(1, &released.name); break;
+            case GpuResourceType::Texture: glDeleteTextures(1, &released.name); break;
+        }
+    }
+}
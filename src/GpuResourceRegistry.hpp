@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include "ObjectPool.hpp"
+
+enum class GpuResourceType : uint8_t {
+    Buffer,
+    VertexArray,
+    Texture
+};
+
+struct GpuResource;
+using GpuHandle = PoolHandle<GpuResource>;
+
+// Owner of GL object names. Code holds generational handles, so a handle to a
+// released object resolves to name 0 instead of to a recycled name. Released
+// names are deleted only once a fence shows the GPU has finished the frames that
+// could still use them. Resources are created in the current group (0 unless a
+// GroupScope is active), and releaseGroup() drops a whole level's objects without
+// walking the meshes that own them. GL thread only.
+class GpuResourceRegistry {
+public:
+    static GpuResourceRegistry& get();
+
+    // Creates resources in a group until destroyed; nests
+    class GroupScope {
+    public:
+        explicit GroupScope(uint32_t group);
+        ~GroupScope();
+
+        GroupScope(const GroupScope&) = delete;
+        GroupScope& operator=(const GroupScope&) = delete;
+
+    private:
+        uint32_t m_previous;
+    };
+
+    // A new group id for one level's resources; never 0
+    uint32_t createGroup();
+
+    GpuHandle create(GpuResourceType type);
+
+    // 0 for stale and null handles
+    unsigned int getName(GpuHandle handle) const {
+        return isAlive(handle) ? m_slots[handle.index].name : 0;
+    }
+    bool isAlive(GpuHandle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+               m_slots[handle.index].name != 0;
+    }
+
+    // Deferred: the name is deleted a few frames later. Stale handles are ignored.
+    void release(GpuHandle handle);
+    void releaseGroup(uint32_t group);
+
+    // Once per frame after the frame's GL commands: fences this frame's releases
+    // and deletes the ones the GPU is done with. Never waits.
+    void endFrame();
+
+    // Waits for the GPU and deletes every released name (shutdown)
+    void flush();
+
+    size_t getLiveCount() const { return m_liveCount; }
+    size_t getPendingCount() const;
+
+private:
+    struct Slot {
+        unsigned int name;      // 0 while free
+        uint32_t generation;
+        uint32_t group;
+        uint32_t nextFree;
+        GpuResourceType type;
+    };
+
+    struct Released {
+        unsigned int name;
+        GpuResourceType type;
+    };
+
+    struct Batch {
+        GLsync fence;
+        std::vector<Released> names;
+    };
+
+    std::vector<Slot> m_slots;
+    uint32_t m_freeHead;
+    size_t m_liveCount;
+    uint32_t m_currentGroup;
+    uint32_t m_nextGroup;
+
+    std::vector<Released> m_released;   // This frame's, not yet fenced
+    std::vector<Batch> m_batches;       // Oldest first
+
+    GpuResourceRegistry();
+
+    void releaseSlot(uint32_t index);
+    static void deleteNames(const std::vector<Released>& names);
+};
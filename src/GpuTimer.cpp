@@ -0,0 +1,68 @@
+#include "GpuTimer.hpp"
+#include <GL/glew.h>
+
+GpuTimer::GpuTimer(int latency)
+    : m_slotCount(latency > 0 ? latency : 1)
+    , m_writeIndex(0)
+    , m_readIndex(0)
+    , m_pending(0)
+    , m_active(false)
+{
+    m_queries.resize(m_slotCount * 2);
+    glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+void GpuTimer::begin() {
+    // Ring is full: drop the oldest result rather than stall
+    if (m_pending == m_slotCount) {
+        m_readIndex = (m_readIndex + 1) % m_slotCount;
+        m_pending--;
+    }
+
+    glQueryCounter(m_queries[m_writeIndex * 2], GL_TIMESTAMP);
+    m_active = true;
+}
+
+void GpuTimer::end() {
+    if (!m_active) return;
+
+    glQueryCounter(m_queries[m_writeIndex * 2 + 1], GL_TIMESTAMP);
+    m_active = false;
+    m_writeIndex = (m_writeIndex + 1) % m_slotCount;
+    m_pending++;
+}
+
+bool GpuTimer::poll(double& milliseconds) {
+    return read(false, milliseconds);
+}
+
+bool GpuTimer::wait(double& milliseconds) {
+    return read(true, milliseconds);
+}
+
+bool GpuTimer::read(bool block, double& milliseconds) {
+    if (m_pending == 0) return false;
+
+    unsigned int startQuery = m_queries[m_readIndex * 2];
+    unsigned int endQuery = m_queries[m_readIndex * 2 + 1];
+    if (!block) {
+        // The end timestamp lands last, so its availability covers both
+        GLint available = 0;
+        glGetQueryObjectiv(endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    GLuint64 startTime = 0;
+    GLuint64 endTime = 0;
+    glGetQueryObjectui64v(startQuery, GL_QUERY_RESULT, &startTime);
+    glGetQueryObjectui64v(endQuery, GL_QUERY_RESULT, &endTime);
+    milliseconds = endTime > startTime ? (endTime - startTime) / 1.0e6 : 0.0;
+
+    m_readIndex = (m_readIndex + 1) % m_slotCount;
+    m_pending--;
+    return true;
+}
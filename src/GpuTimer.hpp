@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+// GPU elapsed-time measurement with a small ring of GL_TIMESTAMP query pairs,
+// so results can be read a few frames later without stalling the pipeline.
+// Timestamps (unlike GL_TIME_ELAPSED) allow several timers to overlap.
+class GpuTimer {
+public:
+    GpuTimer(int latency = 4);
+    ~GpuTimer();
+
+    // Bracket the GPU work to be measured (one pair per frame)
+    void begin();
+    void end();
+
+    // Fetch the oldest finished measurement. Returns false if none is ready yet.
+    bool poll(double& milliseconds);
+
+    // Like poll, but waits for the oldest query to finish
+    bool wait(double& milliseconds);
+
+private:
+    std::vector<unsigned int> m_queries;    // Start/end pairs
+    int m_slotCount;
+    int m_writeIndex;
+    int m_readIndex;
+    int m_pending;
+    bool m_active;
+
+    bool read(bool block, double& milliseconds);
+};
@@ -0,0 +1,107 @@
+#include "Hud.hpp"
+#include "Player.hpp"
+#include <algorithm>
+#include <cstdio>
+
+// Layout, in pixels at 720p; scaled with the target height
+static const float MARGIN = 24.0f;
+static const float LABEL_SIZE = 14.0f;
+static const float VALUE_SIZE = 28.0f;
+static const float AMMO_SIZE = 42.0f;
+static const float BAR_WIDTH = 180.0f;
+static const float BAR_HEIGHT = 8.0f;
+
+static const glm::vec4 TEXT_COLOR(1.0f, 1.0f, 1.0f, 1.0f);
+static const glm::vec4 LABEL_COLOR(0.75f, 0.75f, 0.75f, 1.0f);
+static const glm::vec4 HEALTH_COLOR(0.35f, 0.9f, 0.4f, 1.0f);
+static const glm::vec4 LOW_HEALTH_COLOR(0.95f, 0.25f, 0.2f, 1.0f);
+static const glm::vec4 ARMOR_COLOR(0.35f, 0.6f, 1.0f, 1.0f);
+static const glm::vec4 BAR_BACKGROUND(0.0f, 0.0f, 0.0f, 0.5f);
+static const glm::vec4 WARNING_COLOR(1.0f, 0.8f, 0.2f, 1.0f);
+
+Hud::Hud(OverlayRenderer& overlay)
+    : m_overlay(overlay)
+{
+    m_healthLabel = m_overlay.cacheText("HEALTH", LABEL_SIZE);
+    m_armorLabel = m_overlay.cacheText("ARMOR", LABEL_SIZE);
+    m_reloadingLabel = m_overlay.cacheText("RELOADING", LABEL_SIZE);
+}
+
+OverlayRenderer::TextHandle Hud::getWeaponLabel(const std::string& name) {
+    for (const auto& label : m_weaponLabels) {
+        if (label.first == name) return label.second;
+    }
+    OverlayRenderer::TextHandle handle = m_overlay.cacheText(name.c_str(), VALUE_SIZE * 0.5f);
+    m_weaponLabels.push_back(std::make_pair(name, handle));
+    return handle;
+}
+
+void Hud::drawBar(float x, float y, float width, float height, float fraction, const glm::vec4& color) {
+    fraction = std::min(std::max(fraction, 0.0f), 1.0f);
+    m_overlay.drawRect(x, y, width, height, BAR_BACKGROUND);
+    if (fraction > 0.0f) {
+        m_overlay.drawRect(x, y, width * fraction, height, color);
+    }
+}
+
+void Hud::build(const Player& player, int width, int height) {
+    m_overlay.begin(width, height);
+
+    const float scale = height / 720.0f;
+    const float margin = MARGIN * scale;
+    char buffer[32];
+
+    // Crosshair
+    const float cx = width * 0.5f;
+    const float cy = height * 0.5f;
+    const float arm = 8.0f * scale;
+    const float thickness = std::max(1.0f, 2.0f * scale);
+    const float gap = 3.0f * scale;
+    m_overlay.drawRect(cx - gap - arm, cy - thickness * 0.5f, arm, thickness, TEXT_COLOR);
+    m_overlay.drawRect(cx + gap, cy - thickness * 0.5f, arm, thickness, TEXT_COLOR);
+    m_overlay.drawRect(cx - thickness * 0.5f, cy - gap - arm, thickness, arm, TEXT_COLOR);
+    m_overlay.drawRect(cx - thickness * 0.5f, cy + gap, thickness, arm, TEXT_COLOR);
+
+    // Health and armor, bottom left
+    const float blockHeight = (LABEL_SIZE + VALUE_SIZE + BAR_HEIGHT + 22.0f) * scale;
+    float y = height - margin - 2.0f * blockHeight;
+
+    float health = player.getHealth();
+    glm::vec4 healthColor = health <= 25.0f ? LOW_HEALTH_COLOR : HEALTH_COLOR;
+    m_overlay.drawText(m_healthLabel, margin, y, LABEL_COLOR, scale);
+    y += (LABEL_SIZE + 6.0f) * scale;
+    std::snprintf(buffer, sizeof(buffer), "%d", static_cast<int>(std::max(health, 0.0f) + 0.5f));
+    m_overlay.drawText(buffer, margin, y, VALUE_SIZE * scale, healthColor);
+    y += (VALUE_SIZE + 6.0f) * scale;
+    drawBar(margin, y, BAR_WIDTH * scale, BAR_HEIGHT * scale, health / 100.0f, healthColor);
+    y += (BAR_HEIGHT + 10.0f) * scale;
+
+    float armor = player.getArmor();
+    m_overlay.drawText(m_armorLabel, margin, y, LABEL_COLOR, scale);
+    y += (LABEL_SIZE + 6.0f) * scale;
+    std::snprintf(buffer, sizeof(buffer), "%d", static_cast<int>(std::max(armor, 0.0f) + 0.5f));
+    m_overlay.drawText(buffer, margin, y, VALUE_SIZE * scale, ARMOR_COLOR);
+    y += (VALUE_SIZE + 6.0f) * scale;
+    drawBar(margin, y, BAR_WIDTH * scale, BAR_HEIGHT * scale, armor / 100.0f, ARMOR_COLOR);
+
+    // Ammo, bottom right
+    if (const Weapon* weapon = player.getCurrentWeapon()) {
+        float right = width - margin;
+        float ammoY = height - margin - AMMO_SIZE * scale;
+
+        std::snprintf(buffer, sizeof(buffer), "%d/%d", weapon->getAmmoCount(), weapon->getMagazineSize());
+        float ammoSize = AMMO_SIZE * scale;
+        glm::vec4 ammoColor = weapon->needsReload() ? WARNING_COLOR : TEXT_COLOR;
+        m_overlay.drawText(buffer, right - m_overlay.measureText(buffer, ammoSize), ammoY, ammoSize, ammoColor);
+
+        OverlayRenderer::TextHandle name = getWeaponLabel(weapon->getName());
+        float nameY = ammoY - (VALUE_SIZE * 0.5f + 10.0f) * scale;
+        m_overlay.drawText(name, right - m_overlay.getTextWidth(name) * scale, nameY, LABEL_COLOR, scale);
+
+        if (weapon->isReloading()) {
+            float reloadY = nameY - (LABEL_SIZE + 8.0f) * scale;
+            m_overlay.drawText(m_reloadingLabel, right - m_overlay.getTextWidth(m_reloadingLabel) * scale,
+                               reloadY, WARNING_COLOR, scale);
+        }
+    }
+}
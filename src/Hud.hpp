@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "OverlayRenderer.hpp"
+
+class Player;
+
+// Game HUD: health, armor, ammo and crosshair, drawn through the overlay.
+// Labels are cached text; numbers are formatted into stack buffers each frame.
+class Hud {
+public:
+    explicit Hud(OverlayRenderer& overlay);
+
+    // Record this frame's HUD into the overlay batch
+    void build(const Player& player, int width, int height);
+
+private:
+    OverlayRenderer& m_overlay;
+
+    OverlayRenderer::TextHandle m_healthLabel;
+    OverlayRenderer::TextHandle m_armorLabel;
+    OverlayRenderer::TextHandle m_reloadingLabel;
+
+    // Weapon names are cached the first time each weapon is shown
+    std::vector<std::pair<std::string, OverlayRenderer::TextHandle>> m_weaponLabels;
+
+    OverlayRenderer::TextHandle getWeaponLabel(const std::string& name);
+    void drawBar(float x, float y, float width, float height, float fraction, const glm::vec4& color);
+};
@@ -0,0 +1,164 @@
+#include "IndirectRenderer.hpp"
+#include <GL/glew.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+IndirectRenderer::IndirectRenderer()
+    : m_batch(nullptr)
+    , m_VAO(0)
+    , m_vertexBufferID(0)
+    , m_indexBufferID(0)
+    , m_cullShader(0)
+    , m_drawShader(0)
+    , m_objectCount(0)
+{
+}
+
+IndirectRenderer::~IndirectRenderer() {
+    if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
+    if (m_cullShader) glDeleteProgram(m_cullShader);
+    if (m_drawShader) glDeleteProgram(m_drawShader);
+}
+
+bool IndirectRenderer::isSupported() {
+    return GLEW_VERSION_4_3 != 0;
+}
+
+void IndirectRenderer::setShaders(unsigned int cullShader, unsigned int drawShader) {
+    if (m_cullShader) glDeleteProgram(m_cullShader);
+    if (m_drawShader) glDeleteProgram(m_drawShader);
+    m_cullShader = cullShader;
+    m_drawShader = drawShader;
+}
+
+void IndirectRenderer::build(const MeshBatch& batch) {
+    static_assert(sizeof(ObjectData) == 128, "ObjectData must match the std430 layout");
+    static_assert(sizeof(DrawCommand) == 20, "DrawCommand must match DrawElementsIndirectCommand");
+
+    clear();
+    std::vector<ObjectData> objects;
+    objects.reserve(batch.entries.size());
+
+    // LOD ranges are relative to the batch's index buffer
+    for (const MeshBatch::Entry& entry : batch.entries) {
+        const Mesh& mesh = *entry.source;
+        if (mesh.getLodCount() == 0) continue;
+
+        ObjectData object = {};
+        object.model = glm::mat4(1.0f);
+        object.boundingSphere = glm::vec4(mesh.getBoundsCenter(), mesh.getBoundsRadius());
+        object.baseVertex = entry.baseVertex;
+        object.lodCount = static_cast<unsigned int>(std::min(mesh.getLodCount(), 4));
+
+        for (unsigned int lod = 0; lod < 4; lod++) {
+            const MeshLod& range = mesh.getLods()[std::min(lod, object.lodCount - 1)];
+            object.lodFirstIndex[lod] = entry.firstIndex + range.indexOffset;
+            object.lodIndexCount[lod] = range.indexCount;
+        }
+        objects.push_back(object);
+    }
+
+    m_objectCount = objects.size();
+    if (m_objectCount == 0) return;
+    m_batch = &batch;
+
+    std::vector<unsigned int> objectIndices(m_objectCount);
+    for (size_t i = 0; i < m_objectCount; i++) objectIndices[i] = static_cast<unsigned int>(i);
+
+    if (!m_VAO) glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+
+    // Object index per instance; baseInstance offsets into it
+    m_objectIndexBuffer.reset(new VertexBuffer(GL_ARRAY_BUFFER));
+    m_objectIndexBuffer->setData(objectIndices.data(), objectIndices.size() * sizeof(unsigned int));
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(unsigned int), (void*)0);
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+
+    m_objectBuffer.reset(new VertexBuffer(GL_SHADER_STORAGE_BUFFER));
+    m_objectBuffer->setData(objects.data(), objects.size() * sizeof(ObjectData));
+
+    m_commandBuffer.reset(new VertexBuffer(GL_DRAW_INDIRECT_BUFFER));
+    m_commandBuffer->setData(nullptr, m_objectCount * sizeof(DrawCommand), GL_DYNAMIC_COPY);
+    m_commandBuffer->unbind();
+}
+
+void IndirectRenderer::clear() {
+    m_batch = nullptr;
+    m_objectCount = 0;
+    m_vertexBufferID = 0;
+    m_indexBufferID = 0;
+}
+
+bool IndirectRenderer::attachGeometry() {
+    if (!m_batch->mesh.isReady()) return false;
+
+    // 0 once the level's group has been released
+    unsigned int vertexBuffer = m_batch->mesh.getVertexBufferID();
+    unsigned int indexBuffer = m_batch->mesh.getIndexBufferID();
+    if (!vertexBuffer || !indexBuffer) return false;
+    if (vertexBuffer == m_vertexBufferID && indexBuffer == m_indexBufferID) return true;
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_vertexBufferID = vertexBuffer;
+    m_indexBufferID = indexBuffer;
+    return true;
+}
+
+void IndirectRenderer::draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition,
+                            float lodScreenFactor, const float lodScreenSizes[3]) {
+    if (!isReady() || !attachGeometry()) return;
+
+    // Frustum planes from the view-projection rows (Gribb/Hartmann)
+    glm::mat4 viewProjection = projection * view;
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+    glm::vec4 planes[6] = {
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2]
+    };
+    for (auto& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    // Cull pass
+    glUseProgram(m_cullShader);
+    glUniform4fv(glGetUniformLocation(m_cullShader, "frustumPlanes"), 6, glm::value_ptr(planes[0]));
+    glUniform3fv(glGetUniformLocation(m_cullShader, "cameraPos"), 1, glm::value_ptr(cameraPosition));
+    glUniform1f(glGetUniformLocation(m_cullShader, "lodScreenFactor"), lodScreenFactor);
+    glUniform3fv(glGetUniformLocation(m_cullShader, "lodScreenSizes"), 1, lodScreenSizes);
+    glUniform1ui(glGetUniformLocation(m_cullShader, "objectCount"), static_cast<unsigned int>(m_objectCount));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_objectBuffer->getID());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_commandBuffer->getID());
+    glDispatchCompute(static_cast<GLuint>((m_objectCount + 63) / 64), 1, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+    // One draw call for the whole set
+    glUseProgram(m_drawShader);
+    glUniformMatrix4fv(glGetUniformLocation(m_drawShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(m_drawShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform1f(glGetUniformLocation(m_drawShader, "lodFade"), 0.0f);
+    glUniform1i(glGetUniformLocation(m_drawShader, "hasTexture"), 0);
+
+    glBindVertexArray(m_VAO);
+    m_commandBuffer->bind();
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(m_objectCount), 0);
+    m_commandBuffer->unbind();
+    glBindVertexArray(0);
+}
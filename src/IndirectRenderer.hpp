@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.hpp"
+#include "VertexBuffer.hpp"
+
+// GPU-driven path for static geometry (GL 4.3+).
+// Draws a MeshBatch straight from the batch mesh's uploaded buffers: a compute
+// shader culls each entry against the frustum, picks its LOD and writes a
+// DrawElementsIndirectCommand, and the whole set is drawn with a single
+// glMultiDrawElementsIndirect. The object index reaches the vertex shader as an
+// instanced attribute offset by each command's baseInstance. Batches hold
+// untextured geometry only; nothing is drawn until the batch mesh is ready.
+class IndirectRenderer {
+public:
+    IndirectRenderer();
+    ~IndirectRenderer();
+
+    // Requires compute shaders, SSBOs and base-instance draws
+    static bool isSupported();
+
+    // Takes ownership of the programs
+    void setShaders(unsigned int cullShader, unsigned int drawShader);
+
+    // Object data for the batch's entries (identity model matrices). The batch
+    // must outlive the renderer's use of it, or be replaced by clear().
+    void build(const MeshBatch& batch);
+    void clear();
+
+    // Cull + draw everything in two GL calls
+    void draw(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition,
+              float lodScreenFactor, const float lodScreenSizes[3]);
+
+    size_t getObjectCount() const { return m_objectCount; }
+    bool isReady() const { return m_objectCount > 0 && m_cullShader && m_drawShader; }
+
+private:
+    // std430 layout, mirrored in cull.comp and indirect.vert
+    struct ObjectData {
+        glm::mat4 model;
+        glm::vec4 boundingSphere;
+        unsigned int lodFirstIndex[4];
+        unsigned int lodIndexCount[4];
+        int baseVertex;
+        unsigned int lodCount;
+        unsigned int pad[2];
+    };
+
+    struct DrawCommand {
+        unsigned int count;
+        unsigned int instanceCount;
+        unsigned int firstIndex;
+        int baseVertex;
+        unsigned int baseInstance;
+    };
+
+    const MeshBatch* m_batch;
+    unsigned int m_VAO;
+    unsigned int m_vertexBufferID;      // The batch mesh's buffers m_VAO points at
+    unsigned int m_indexBufferID;
+    std::unique_ptr<VertexBuffer> m_objectIndexBuffer;
+    std::unique_ptr<VertexBuffer> m_objectBuffer;
+    std::unique_ptr<VertexBuffer> m_commandBuffer;
+
+    unsigned int m_cullShader;
+    unsigned int m_drawShader;
+    size_t m_objectCount;
+
+    // Points m_VAO at the batch mesh's buffers once they hold its data
+    bool attachGeometry();
+};
@@ -1,24 +1,90 @@
 #include "Level.hpp"
+#include "BvhRaycaster.hpp"
+#include "GpuResourceRegistry.hpp"
+#include "LevelFile.hpp"
+#include "MemoryTracker.hpp"
+#include "TextureLoader.hpp"
+#include "ThreadPool.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
 #include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// Models are optional; rooms without them stay empty
+const char* FURNITURE_MODEL_DIR = "res/models/";
+
+// Model origin goes to (u, v) of the room's floor, measured from its corner in
+// fractions of its size, turned by rotation degrees about +Y
+struct FurniturePlacement {
+    const char* roomType;
+    const char* model;
+    float u;
+    float v;
+    float rotation;
+};
+
+const FurniturePlacement FURNITURE[] = {
+    { "living_room", "sofa", 0.5f, 0.85f, 180.0f },
+    { "living_room", "coffee_table", 0.5f, 0.6f, 0.0f },
+    { "living_room", "tv_stand", 0.5f, 0.1f, 0.0f },
+    { "kitchen", "counter", 0.15f, 0.5f, 90.0f },
+    { "kitchen", "stove", 0.5f, 0.1f, 0.0f },
+    { "kitchen", "refrigerator", 0.85f, 0.1f, 0.0f },
+    { "bedroom", "bed", 0.5f, 0.65f, 0.0f },
+    { "bedroom", "wardrobe", 0.1f, 0.2f, 90.0f },
+    { "bedroom", "bedside_table", 0.15f, 0.9f, 0.0f },
+    { "bathroom", "toilet", 0.2f, 0.2f, 0.0f },
+    { "bathroom", "sink", 0.8f, 0.15f, 0.0f },
+    { "bathroom", "shower", 0.75f, 0.75f, 0.0f },
+};
+
+// The asset cooker's name for a texture source
+std::string cookedTexturePath(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + ".dds";
+    return path.substr(0, dot) + ".dds";
+}
+
+} // namespace
 
-Level::Level() {
-    generateApartment();
+Level::Level()
+    : m_resourceGroup(GpuResourceRegistry::get().createGroup())
+    , m_textureBytes(0)
+{
 }
 
 Level::~Level() {
-    for (auto mesh : m_meshes) {
-        delete mesh;
-    }
+    unloadMeshes();
+}
+
+void Level::unloadMeshes() {
+    // One pass over the registry instead of a release per mesh; the meshes'
+    // own releases then find stale handles
+    GpuResourceRegistry::get().releaseGroup(m_resourceGroup);
+    MemoryTracker::addGpuBytes(MemoryTag::Level, -static_cast<int64_t>(m_textureBytes));
+    m_textureBytes = 0;
+    m_staticBatch.entries.clear();
+    m_staticBatch.mesh = Mesh();
+    m_meshes.clear();
 }
 
 void Level::generateApartment() {
+    MemoryTracker::Scope memoryScope(MemoryTag::Level);
     // Clear existing geometry
-    for (auto mesh : m_meshes) {
-        delete mesh;
-    }
-    m_meshes.clear();
+    unloadMeshes();
+    m_file.reset();
+    m_collision = CollisionMesh();
+    m_collisionBvh.clear();
+    m_visibility.clear();
     m_rooms.clear();
     m_walls.clear();
+    m_surfaces.clear();
 
     // Create apartment layout - a typical 1-bedroom apartment
     float wallHeight = 2.8f;
@@ -66,12 +132,143 @@ void Level::generateApartment() {
     createWall(glm::vec3(1.5f, 0.0f, -4.0f), glm::vec3(-1.0f, 0.0f, -4.0f), wallHeight, true);
 
     // Generate furniture for each room
+    std::map<std::string, std::vector<Mesh>> models = loadFurnitureModels();
     for (const auto& room : m_rooms) {
-        addFurniture(room);
+        addFurniture(room, models);
     }
 
     // Generate cover positions
     generateCoverPositions();
+
+    // Build LOD chains for everything that was generated
+    for (auto& mesh : m_meshes) {
+        mesh.generateLods();
+    }
+
+    buildCollision();
+}
+
+bool Level::loadFromFile(const std::string& path) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Level);
+    std::unique_ptr<LevelFile> file(new LevelFile());
+    if (!file->open(path)) return false;
+
+    unloadMeshes();
+    m_rooms.clear();
+    m_walls.clear();
+    m_surfaces.clear();
+    m_collision = CollisionMesh();
+    m_collisionBvh.clear();
+    m_visibility.clear();
+    m_modelStats = GltfImporter::Stats();
+    m_file = std::move(file);
+
+    const LevelFormat::Header& header = m_file->getHeader();
+    const LevelFormat::Submesh* submeshes = m_file->getSubmeshes();
+    m_meshes.reserve(header.submeshes.count);
+    for (uint64_t i = 0; i < header.submeshes.count; i++) {
+        const LevelFormat::Submesh& submesh = submeshes[i];
+        std::vector<MeshLod> lods;
+        for (uint32_t lod = 0; lod < submesh.lodCount; lod++) {
+            lods.push_back({ submesh.lods[lod].indexOffset, submesh.lods[lod].indexCount, submesh.lods[lod].error });
+        }
+
+        Mesh mesh;
+        mesh.setMappedGeometry(m_file->getVertices() + submesh.firstVertex, submesh.vertexCount,
+                               m_file->getIndices() + submesh.firstIndex, submesh.indexCount, lods,
+                               glm::vec3(submesh.boundsCenter[0], submesh.boundsCenter[1], submesh.boundsCenter[2]),
+                               submesh.boundsRadius);
+        std::string texture = m_file->getTexturePath(i);
+        if (!texture.empty()) {
+            mesh.setTextures({ Texture{ GpuHandle(), "texture_diffuse", texture } });
+        }
+        m_meshes.push_back(std::move(mesh));
+    }
+
+    const LevelFormat::Room* rooms = m_file->getRooms();
+    const float* covers = m_file->getCovers();
+    for (uint64_t i = 0; i < header.rooms.count; i++) {
+        const LevelFormat::Room& source = rooms[i];
+        Room room;
+        room.position = glm::vec3(source.position[0], source.position[1], source.position[2]);
+        room.size = glm::vec3(source.size[0], source.size[1], source.size[2]);
+        room.type.assign(source.type, strnlen(source.type, LevelFormat::ROOM_TYPE_LENGTH));
+        for (uint32_t c = 0; c < source.coverCount; c++) {
+            const float* cover = covers + 3 * (source.firstCover + c);
+            room.coverPositions.push_back(glm::vec3(cover[0], cover[1], cover[2]));
+        }
+        m_rooms.push_back(room);
+    }
+
+    const LevelFormat::Wall* walls = m_file->getWalls();
+    for (uint64_t i = 0; i < header.walls.count; i++) {
+        const LevelFormat::Wall& source = walls[i];
+        Wall wall;
+        wall.start = glm::vec3(source.start[0], source.start[1], source.start[2]);
+        wall.end = glm::vec3(source.end[0], source.end[1], source.end[2]);
+        wall.height = source.height;
+        wall.hasDoor = source.hasDoor != 0;
+        wall.doorPosition = glm::vec3(source.doorPosition[0], source.doorPosition[1], source.doorPosition[2]);
+        wall.doorWidth = source.doorWidth;
+        m_walls.push_back(wall);
+    }
+
+    const LevelFormat::Surface* surfaces = m_file->getSurfaces();
+    for (uint64_t i = 0; i < header.surfaces.count; i++) {
+        const LevelFormat::Surface& source = surfaces[i];
+        addSurface(glm::vec3(source.origin[0], source.origin[1], source.origin[2]),
+                   glm::vec3(source.edgeU[0], source.edgeU[1], source.edgeU[2]),
+                   glm::vec3(source.edgeV[0], source.edgeV[1], source.edgeV[2]));
+    }
+
+    buildCollision();
+    return true;
+}
+
+bool Level::saveToFile(const std::string& path) const {
+    return LevelFile::write(*this, path);
+}
+
+void Level::buildCollision() {
+    // Compact copy for physics and ray queries
+    for (const auto& mesh : m_meshes) {
+        mesh.appendCollision(m_collision);
+    }
+
+    // Room floors leave gaps between rooms: a collision-only ground plane under the
+    // whole footprint keeps characters from falling through them
+    if (!m_walls.empty()) {
+        glm::vec3 boundsMin(m_walls[0].start), boundsMax(m_walls[0].start);
+        for (const auto& wall : m_walls) {
+            boundsMin = glm::min(boundsMin, glm::min(wall.start, wall.end));
+            boundsMax = glm::max(boundsMax, glm::max(wall.start, wall.end));
+        }
+        const float margin = 100.0f;
+        unsigned int first = static_cast<unsigned int>(m_collision.positions.size());
+        m_collision.positions.push_back(glm::vec3(boundsMin.x - margin, boundsMin.y, boundsMin.z - margin));
+        m_collision.positions.push_back(glm::vec3(boundsMax.x + margin, boundsMin.y, boundsMin.z - margin));
+        m_collision.positions.push_back(glm::vec3(boundsMax.x + margin, boundsMin.y, boundsMax.z + margin));
+        m_collision.positions.push_back(glm::vec3(boundsMin.x - margin, boundsMin.y, boundsMax.z + margin));
+        const unsigned int quad[6] = { 0, 2, 1, 0, 3, 2 };
+        for (unsigned int index : quad) {
+            m_collision.indices.push_back(first + index);
+        }
+    }
+    m_collision.positions.shrink_to_fit();
+    m_collision.indices.shrink_to_fit();
+    m_collisionBvh.build(m_collision);
+}
+
+void Level::bakeVisibility(ThreadPool* pool) {
+    // Visibility between the rooms' floors and cover positions
+    std::vector<glm::vec3> floorMin, floorMax, covers;
+    for (const auto& room : m_rooms) {
+        floorMin.push_back(room.position);
+        floorMax.push_back(room.position + room.size);
+        covers.insert(covers.end(), room.coverPositions.begin(), room.coverPositions.end());
+    }
+    MemoryTracker::Scope memoryScope(MemoryTag::Level);
+    m_visibility.bake(m_collisionBvh, floorMin, floorMax, covers, pool);
 }
 
 void Level::createRoom(const glm::vec3& position, const glm::vec3& size, const std::string& type) {
@@ -81,7 +278,7 @@ void Level::createRoom(const glm::vec3& position, const glm::vec3& size, const s
     room.type = type;
 
     // Create floor mesh
-    Mesh* floor = new Mesh();
+    Mesh floor;
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 
@@ -112,9 +309,10 @@ void Level::createRoom(const glm::vec3& position, const glm::vec3& size, const s
     indices.push_back(2);
     indices.push_back(3);
 
-    floor->setVertices(vertices);
-    floor->setIndices(indices);
-    m_meshes.push_back(floor);
+    floor.setVertices(vertices);
+    floor.setIndices(indices);
+    m_meshes.push_back(std::move(floor));
+    addSurface(position, glm::vec3(size.x, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, size.z));
 
     // Create ceiling mesh (similar to floor but flipped)
     // ... (similar code for ceiling)
@@ -136,7 +334,7 @@ void Level::createWall(const glm::vec3& start, const glm::vec3& end, float heigh
     }
 
     // Create wall mesh
-    Mesh* wallMesh = new Mesh();
+    Mesh wallMesh;
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 
@@ -166,39 +364,98 @@ void Level::createWall(const glm::vec3& start, const glm::vec3& end, float heigh
         indices.push_back(0);
         indices.push_back(2);
         indices.push_back(3);
+
+        addSurface(start, end - start, glm::vec3(0.0f, height, 0.0f));
     } else {
         // Wall with door - create segments around door
         createDoor(wall.doorPosition, wall.doorWidth, 2.1f, false);
     }
 
-    wallMesh->setVertices(vertices);
-    wallMesh->setIndices(indices);
-    m_meshes.push_back(wallMesh);
+    wallMesh.setVertices(vertices);
+    wallMesh.setIndices(indices);
+    m_meshes.push_back(std::move(wallMesh));
 
     m_walls.push_back(wall);
 }
 
-void Level::addFurniture(const Room& room) {
-    // Add furniture based on room type
-    if (room.type == "living_room") {
-        // Add sofa, coffee table, TV stand
-        // Create simple box meshes for furniture
-        // ... implementation for furniture creation
-    } else if (room.type == "kitchen") {
-        // Add counters, stove, refrigerator
-        // ... implementation for kitchen furniture
-    } else if (room.type == "bedroom") {
-        // Add bed, wardrobe, bedside tables
-        // ... implementation for bedroom furniture
-    } else if (room.type == "bathroom") {
-        // Add toilet, sink, shower
-        // ... implementation for bathroom fixtures
+std::map<std::string, std::vector<Mesh>> Level::loadFurnitureModels() {
+    std::map<std::string, std::vector<Mesh>> models;
+    m_modelStats = GltfImporter::Stats();
+
+    // Cooked models (asset-cooker output) are read in place of their sources
+    std::map<std::string, bool> found;
+    for (const auto& placement : FURNITURE) {
+        const std::string base = std::string(FURNITURE_MODEL_DIR) + placement.model;
+        if (std::ifstream(base + ".agl").good()) {
+            found[placement.model] = true;
+        } else if (std::ifstream(base + ".glb").good()) {
+            found[placement.model] = false;
+        }
+    }
+    if (found.empty()) return models;
+
+    ThreadPool pool;
+    GltfImporter importer;
+    GltfImporter::Stats cooked;
+    for (const auto& model : found) {
+        const std::string base = std::string(FURNITURE_MODEL_DIR) + model.first;
+        std::vector<Mesh> meshes;
+        if (!model.second) {
+            if (importer.load(base + ".glb", meshes, &pool)) models[model.first] = std::move(meshes);
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (!LevelFile::readMeshes(base + ".agl", meshes)) continue;
+        cooked.files++;
+        for (const auto& mesh : meshes) {
+            cooked.bytes += mesh.getVertexCount() * sizeof(Vertex) + mesh.getIndexCount() * sizeof(unsigned int);
+            cooked.primitives++;
+            cooked.vertices += mesh.getVertexCount();
+            cooked.indices += mesh.getIndexCount();
+        }
+        cooked.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        models[model.first] = std::move(meshes);
+    }
+
+    m_modelStats = importer.getStats();
+    m_modelStats += cooked;
+    std::cout << "Level: loaded " << m_modelStats.files << " furniture models (" << cooked.files << " cooked), "
+              << m_modelStats.bytes / (1024.0 * 1024.0) << " MB at "
+              << m_modelStats.getMegabytesPerSecond() << " MB/s" << std::endl;
+    return models;
+}
+
+void Level::addFurniture(const Room& room, const std::map<std::string, std::vector<Mesh>>& models) {
+    for (const auto& placement : FURNITURE) {
+        auto model = models.find(placement.model);
+        if (room.type != placement.roomType || model == models.end()) continue;
+
+        glm::vec3 origin = room.position + glm::vec3(room.size.x * placement.u, 0.0f, room.size.z * placement.v);
+        glm::mat4 transform = glm::rotate(glm::translate(glm::mat4(1.0f), origin),
+                                          glm::radians(placement.rotation), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat3 rotation(transform);
+
+        // One level mesh per model mesh, baked into place
+        for (const Mesh& source : model->second) {
+            std::vector<Vertex> vertices = source.getVertices();
+            for (auto& vertex : vertices) {
+                vertex.position = glm::vec3(transform * glm::vec4(vertex.position, 1.0f));
+                vertex.normal = rotation * vertex.normal;
+            }
+
+            Mesh mesh;
+            mesh.setVertices(std::move(vertices));
+            mesh.setIndices(source.getIndices());
+            mesh.setTextures(source.getTextures());
+            m_meshes.push_back(std::move(mesh));
+        }
     }
 }
 
 void Level::createDoor(const glm::vec3& position, float width, float height, bool isVertical) {
     // Create a door frame mesh
-    Mesh* doorFrameMesh = new Mesh();
+    Mesh doorFrameMesh;
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 
@@ -268,9 +525,13 @@ void Level::createDoor(const glm::vec3& position, float width, float height, boo
     indices.push_back(8); indices.push_back(9); indices.push_back(10);
     indices.push_back(10); indices.push_back(9); indices.push_back(11);
 
-    doorFrameMesh->setVertices(vertices);
-    doorFrameMesh->setIndices(indices);
-    m_meshes.push_back(doorFrameMesh);
+    doorFrameMesh.setVertices(vertices);
+    doorFrameMesh.setIndices(indices);
+    m_meshes.push_back(std::move(doorFrameMesh));
+
+    addSurface(v1.position, v3.position - v1.position, v2.position - v1.position);
+    addSurface(v5.position, v7.position - v5.position, v6.position - v5.position);
+    addSurface(v9.position, v10.position - v9.position, v11.position - v9.position);
 }
 
 void Level::generateCoverPositions() {
@@ -291,18 +552,192 @@ void Level::generateCoverPositions() {
     }
 }
 
-bool Level::checkCollision(const glm::vec3& position, float radius) const {
-    // Check collision with walls
-    for (const auto& wall : m_walls) {
-        // Basic wall collision detection
-        // Would implement proper collision detection algorithm here
-        float dist = glm::distance(position, wall.start);
-        if (dist < radius) {
-            return true;
+void Level::setMeshResidency(MeshResidency residency) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Level);
+    for (auto& mesh : m_meshes) {
+        mesh.setResidency(residency);
+    }
+    if (!m_staticBatch.entries.empty()) {
+        m_staticBatch.mesh.setResidency(residency);
+        if (residency == MeshResidency::GpuOnly) {
+            for (const auto& entry : m_staticBatch.entries) {
+                m_meshes[entry.source - m_meshes.data()].discardCpuData();
+            }
         }
     }
+}
 
-    return false;
+void Level::queueUploads(UploadQueue& uploads) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Level);
+    loadTextures();
+    std::vector<bool> batched(m_meshes.size(), false);
+    for (const auto& entry : m_staticBatch.entries) {
+        batched[entry.source - m_meshes.data()] = true;
+    }
+    for (size_t i = 0; i < m_meshes.size(); i++) {
+        if (batched[i]) continue;
+        m_meshes[i].setResourceGroup(m_resourceGroup);
+        uploads.enqueue(m_meshes[i]);
+    }
+    if (!m_staticBatch.entries.empty()) {
+        m_staticBatch.mesh.setResourceGroup(m_resourceGroup);
+        uploads.enqueue(m_staticBatch.mesh);
+    }
+}
+
+bool Level::buildStaticBatch() {
+    MemoryTracker::Scope memoryScope(MemoryTag::Level);
+    m_staticBatch.entries.clear();
+    m_staticBatch.mesh = Mesh();
+
+    // Textured meshes are drawn one by one with their texture bound; so are meshes
+    // that already have their own GPU copy
+    loadTextures();
+    const GpuResourceRegistry& registry = GpuResourceRegistry::get();
+    std::vector<const Mesh*> members;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const auto& mesh : m_meshes) {
+        const std::vector<Texture>& textures = mesh.getTextures();
+        if (mesh.getLodCount() == 0 || mesh.getLods()[0].indexCount == 0 ||
+            mesh.isReady() || mesh.isUploadPending() ||
+            (!textures.empty() && registry.isAlive(textures[0].handle))) {
+            continue;
+        }
+        if (!mesh.hasCpuData()) {
+            std::cerr << "Level: mesh geometry was already released, drawing meshes one by one" << std::endl;
+            return false;
+        }
+        members.push_back(&mesh);
+        vertexCount += mesh.getVertexCount();
+        indexCount += mesh.getIndexCount();
+    }
+    if (members.empty()) return true;
+
+    // Each member's indices stay relative to its own vertices (baseVertex)
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    vertices.reserve(vertexCount);
+    indices.reserve(indexCount);
+    for (const Mesh* mesh : members) {
+        MeshBatch::Entry entry;
+        entry.source = mesh;
+        entry.baseVertex = static_cast<int>(vertices.size());
+        entry.firstIndex = static_cast<unsigned int>(indices.size());
+        m_staticBatch.entries.push_back(entry);
+        vertices.insert(vertices.end(), mesh->getVertexData(), mesh->getVertexData() + mesh->getVertexCount());
+        indices.insert(indices.end(), mesh->getIndexData(), mesh->getIndexData() + mesh->getIndexCount());
+    }
+    m_staticBatch.mesh.setVertices(std::move(vertices));
+    m_staticBatch.mesh.setIndices(std::move(indices));
+    m_staticBatch.mesh.setResidency(members[0]->getResidency());
+    if (members[0]->getResidency() == MeshResidency::GpuOnly) {
+        for (const Mesh* mesh : members) {
+            m_meshes[mesh - m_meshes.data()].discardCpuData();
+        }
+    }
+    return true;
+}
+
+void Level::loadTextures() {
+    // Textures are the asset cooker's DDS files, named after their sources; each
+    // file is loaded once and shared, and a missing one leaves its meshes untextured
+    GpuResourceRegistry& registry = GpuResourceRegistry::get();
+    GpuResourceRegistry::GroupScope group(m_resourceGroup);
+    std::map<std::string, GpuHandle> loaded;
+    for (auto& mesh : m_meshes) {
+        std::vector<Texture> textures = mesh.getTextures();
+        bool changed = false;
+        for (auto& texture : textures) {
+            if (registry.isAlive(texture.handle) || texture.path.find('#') != std::string::npos) continue;
+
+            std::string path = cookedTexturePath(texture.path);
+            auto it = loaded.find(path);
+            if (it == loaded.end()) {
+                size_t bytes = 0;
+                GpuHandle handle = std::ifstream(path).good() ? TextureLoader::loadDds(path, bytes) : GpuHandle();
+                MemoryTracker::addGpuBytes(MemoryTag::Level, static_cast<int64_t>(bytes));
+                m_textureBytes += bytes;
+                it = loaded.emplace(path, handle).first;
+            }
+            texture.handle = it->second;
+            changed = changed || !it->second.isNull();
+        }
+        if (changed) mesh.setTextures(textures);
+    }
+}
+
+MeshMemoryStats Level::getMemoryStats() const {
+    MeshMemoryStats stats;
+    for (const auto& mesh : m_meshes) {
+        stats += mesh.getMemoryStats();
+    }
+    stats += m_staticBatch.mesh.getMemoryStats();
+    stats.collisionBytes += m_collision.getMemoryUsage() + m_collisionBvh.getMemoryUsage() +
+                            m_visibility.getMemoryUsage();
+    return stats;
+}
+
+bool Level::checkCollision(const glm::vec3& position, float radius) const {
+    return m_collisionBvh.overlapCapsule(position, position, radius);
+}
+
+bool Level::checkCapsule(const glm::vec3& a, const glm::vec3& b, float radius) const {
+    return m_collisionBvh.overlapCapsule(a, b, radius);
+}
+
+bool Level::sweepCapsule(const glm::vec3& a, const glm::vec3& b, float radius, const glm::vec3& movement,
+                         CollisionBvh::SweepHit& hit) const {
+    return m_collisionBvh.sweepCapsule(a, b, radius, movement, hit);
+}
+
+void Level::addSurface(const glm::vec3& origin, const glm::vec3& edgeU, const glm::vec3& edgeV) {
+    Surface surface;
+    surface.origin = origin;
+    surface.edgeU = edgeU;
+    surface.edgeV = edgeV;
+    surface.normal = glm::normalize(glm::cross(edgeU, edgeV));
+    m_surfaces.push_back(surface);
+}
+
+bool Level::hasLineOfSight(const glm::vec3& from, const glm::vec3& to) const {
+    return BvhRaycaster(m_collisionBvh).hasLineOfSight(from, to);
+}
+
+bool Level::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const {
+    hit.distance = maxDistance;
+    hit.surface = -1;
+
+    for (size_t i = 0; i < m_surfaces.size(); i++) {
+        const Surface& surface = m_surfaces[i];
+        float denom = glm::dot(surface.normal, direction);
+        if (std::fabs(denom) < 1e-6f) continue;
+
+        float t = glm::dot(surface.origin - origin, surface.normal) / denom;
+        if (t < 0.0f || t >= hit.distance) continue;
+
+        // Inside the rectangle
+        glm::vec3 local = origin + direction * t - surface.origin;
+        float u = glm::dot(local, surface.edgeU) / glm::dot(surface.edgeU, surface.edgeU);
+        float v = glm::dot(local, surface.edgeV) / glm::dot(surface.edgeV, surface.edgeV);
+        if (u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f) continue;
+
+        hit.distance = t;
+        hit.surface = static_cast<int>(i);
+        hit.point = origin + direction * t;
+        hit.normal = denom < 0.0f ? surface.normal : -surface.normal;
+    }
+
+    return hit.surface >= 0;
+}
+
+std::vector<glm::vec3> Level::getRoomCenters() const {
+    std::vector<glm::vec3> centers;
+    centers.reserve(m_rooms.size());
+    for (const auto& room : m_rooms) {
+        centers.push_back(room.position + glm::vec3(room.size.x * 0.5f, 0.0f, room.size.z * 0.5f));
+    }
+    return centers;
 }
 
 bool Level::checkCoverPosition(const glm::vec3& position) const {
@@ -317,16 +752,22 @@ bool Level::checkCoverPosition(const glm::vec3& position) const {
     return false;
 }
 
-std::vector<glm::vec3> Level::getNearestCoverPositions(const glm::vec3& position, float radius) const {
-    std::vector<glm::vec3> nearCover;
+FrameView<glm::vec3> Level::getNearestCoverPositions(const glm::vec3& position, float radius) const {
+    // Count, then fill an exactly sized arena array
+    size_t count = 0;
+    for (const auto& room : m_rooms) {
+        for (const auto& coverPos : room.coverPositions) {
+            if (glm::distance(position, coverPos) < radius) count++;
+        }
+    }
 
+    glm::vec3* nearCover = FrameArena::current().allocateArray<glm::vec3>(count);
+    size_t written = 0;
     for (const auto& room : m_rooms) {
         for (const auto& coverPos : room.coverPositions) {
-            if (glm::distance(position, coverPos) < radius) {
-                nearCover.push_back(coverPos);
-            }
+            if (glm::distance(position, coverPos) < radius) nearCover[written++] = coverPos;
         }
     }
 
-    return nearCover;
+    return FrameView<glm::vec3>(nearCover, count);
 }
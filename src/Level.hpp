@@ -1,26 +1,96 @@
 #pragma once
 
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include <glm/glm.hpp>
+#include "CollisionBvh.hpp"
+#include "FrameArena.hpp"
+#include "GltfImporter.hpp"
 #include "Mesh.hpp"
+#include "UploadQueue.hpp"
+#include "VisibilitySet.hpp"
+
+class LevelFile;
+class ThreadPool;
 
 class Level {
 public:
+    // Flat rectangle of level geometry: origin corner plus its two edges
+    struct Surface {
+        glm::vec3 origin;
+        glm::vec3 edgeU;
+        glm::vec3 edgeV;
+        glm::vec3 normal;
+    };
+
+    struct RaycastHit {
+        glm::vec3 point;
+        glm::vec3 normal;       // Facing the ray
+        float distance;
+        int surface;
+    };
+
+    // Empty until generateApartment() or loadFromFile()
     Level();
     ~Level();
 
     // Level generation
     void generateApartment();
 
-    // Collision detection
+    // Binary level files (LevelFile). Loaded meshes use the mapped vertex and index
+    // tables in place; the file stays mapped while the level uses it.
+    bool loadFromFile(const std::string& path);
+    bool saveToFile(const std::string& path) const;
+
+    // Collision detection against the collision mesh's BVH. Capsules are the
+    // segment a-b inflated by radius.
     bool checkCollision(const glm::vec3& position, float radius) const;
+    bool checkCapsule(const glm::vec3& a, const glm::vec3& b, float radius) const;
+    bool sweepCapsule(const glm::vec3& a, const glm::vec3& b, float radius, const glm::vec3& movement,
+                      CollisionBvh::SweepHit& hit) const;
+    // Nothing of the collision mesh between the points (any-hit ray, for AI sight checks)
+    bool hasLineOfSight(const glm::vec3& from, const glm::vec3& to) const;
+    const CollisionBvh& getCollisionBvh() const { return m_collisionBvh; }
+
+    // Rendering (stored contiguously; pointers are invalidated by generateApartment)
+    const std::vector<Mesh>& getMeshes() const { return m_meshes; }
 
-    // Rendering
-    const std::vector<Mesh*>& getMeshes() const { return m_meshes; }
+    // Applies a residency policy to every mesh. Call after the renderer has built
+    // anything it needs from the CPU arrays (see Renderer::setStaticMeshes).
+    void setMeshResidency(MeshResidency residency);
+    void queueUploads(UploadQueue& uploads);
+
+    // Merges the untextured meshes that are not uploaded yet into one batch for the
+    // GPU-driven path (IndirectRenderer); queueUploads then uploads the batch instead
+    // of its members, and GpuOnly frees the members' copies. False, with no batch,
+    // when a mesh's CPU data is already gone.
+    bool buildStaticBatch();
+    const MeshBatch* getStaticBatch() const { return m_staticBatch.entries.empty() ? nullptr : &m_staticBatch; }
+    MeshMemoryStats getMemoryStats() const;
+
+    // LOD 0 triangles of all meshes, kept regardless of mesh residency
+    const CollisionMesh& getCollisionMesh() const { return m_collision; }
+
+    // Surfaces (floors, walls, door frames) for decals and ray queries
+    const std::vector<Surface>& getSurfaces() const { return m_surfaces; }
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& hit) const;
+
+    // Furniture models read by the last generateApartment (res/models/*.glb)
+    const GltfImporter::Stats& getModelLoadStats() const { return m_modelStats; }
+
+    // Room centers on the floor plane (used for scripted camera paths)
+    std::vector<glm::vec3> getRoomCenters() const;
 
     // Cover system
     bool checkCoverPosition(const glm::vec3& position) const;
-    std::vector<glm::vec3> getNearestCoverPositions(const glm::vec3& position, float radius) const;
+    // Result lives in the calling thread's frame arena (valid for this frame)
+    FrameView<glm::vec3> getNearestCoverPositions(const glm::vec3& position, float radius) const;
+    // Standing/crouching visibility between floor grid points and covers. Empty until
+    // bakeVisibility(), which needs the collision BVH and is not needed by the tools.
+    void bakeVisibility(ThreadPool* pool = nullptr);
+    const VisibilitySet& getVisibility() const { return m_visibility; }
 
 private:
     struct Room {
@@ -39,14 +109,31 @@ private:
         float doorWidth;
     };
 
-    std::vector<Mesh*> m_meshes;
+    // Declared before the meshes, which may point into it
+    std::unique_ptr<LevelFile> m_file;
+    std::vector<Mesh> m_meshes;
+    MeshBatch m_staticBatch;
+    CollisionMesh m_collision;
+    CollisionBvh m_collisionBvh;
+    VisibilitySet m_visibility;
     std::vector<Room> m_rooms;
     std::vector<Wall> m_walls;
+    std::vector<Surface> m_surfaces;
+    GltfImporter::Stats m_modelStats;
+    uint32_t m_resourceGroup;       // GpuResourceRegistry group of the meshes' GL objects
+    size_t m_textureBytes;          // GPU memory of the loaded textures
 
     // Helper methods
+    void unloadMeshes();
     void createRoom(const glm::vec3& position, const glm::vec3& size, const std::string& type);
     void createWall(const glm::vec3& start, const glm::vec3& end, float height, bool hasDoor = false);
-    void addFurniture(const Room& room);
+    std::map<std::string, std::vector<Mesh>> loadFurnitureModels();
+    void addFurniture(const Room& room, const std::map<std::string, std::vector<Mesh>>& models);
     void createDoor(const glm::vec3& position, float width, float height, bool isVertical);
     void generateCoverPositions();
+    void addSurface(const glm::vec3& origin, const glm::vec3& edgeU, const glm::vec3& edgeV);
+    void buildCollision();
+    void loadTextures();
+
+    friend class LevelFile;
 };
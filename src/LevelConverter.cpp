@@ -0,0 +1,38 @@
+#include "Level.hpp"
+#include "LevelFile.hpp"
+#include <iostream>
+#include <string>
+
+// Serializes a level to the binary level format:
+//   level-converter <output>          the built-in apartment
+//   level-converter <input> <output>  re-save an existing level file (format upgrades)
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " [input.agl] output.agl" << std::endl;
+        return 1;
+    }
+
+    Level level;
+    if (argc == 2) {
+        level.generateApartment();
+    } else if (!level.loadFromFile(argv[1])) {
+        return 1;
+    }
+
+    const std::string outputPath = argv[argc - 1];
+    if (!level.saveToFile(outputPath)) {
+        return 1;
+    }
+
+    LevelFile file;
+    if (!file.open(outputPath)) {
+        return 1;
+    }
+    const LevelFormat::Header& header = file.getHeader();
+    std::cout << outputPath << ": " << file.getFileSize() << " bytes, "
+              << header.submeshes.count << " meshes, "
+              << header.vertices.count << " vertices, "
+              << header.indices.count << " indices, "
+              << header.rooms.count << " rooms" << std::endl;
+    return 0;
+}
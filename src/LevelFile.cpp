@@ -0,0 +1,312 @@
+#include "LevelFile.hpp"
+#include "Level.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace LevelFormat;
+
+static_assert(sizeof(Vertex) == 32, "Vertex layout is part of the level format");
+static_assert(sizeof(Header) == 152, "Header layout changed; bump LevelFormat::VERSION");
+static_assert(sizeof(Submesh) == 148, "Submesh layout changed; bump LevelFormat::VERSION");
+static_assert(sizeof(Room) == 56, "Room layout changed; bump LevelFormat::VERSION");
+static_assert(sizeof(Wall) == 48, "Wall layout changed; bump LevelFormat::VERSION");
+static_assert(sizeof(Surface) == 36, "Surface layout changed; bump LevelFormat::VERSION");
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void storeVec3(float out[3], const glm::vec3& v) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+// A mesh's diffuse texture as seen from the file being written. Images embedded
+// in a model ("model.glb#image0") have no file of their own and are not stored.
+void storeTexture(char out[TEXTURE_PATH_LENGTH], const Mesh& mesh, const std::string& path) {
+    if (mesh.getTextures().empty()) return;
+    const std::string& texture = mesh.getTextures()[0].path;
+    if (texture.empty() || texture.find('#') != std::string::npos) return;
+
+    fs::path directory = fs::absolute(path).parent_path().lexically_normal();
+    std::string relative = fs::absolute(texture).lexically_normal().lexically_relative(directory).generic_string();
+    if (relative.empty() || relative.size() >= size_t(TEXTURE_PATH_LENGTH)) {
+        std::cerr << "LevelFile: texture path too long for " << path << ": " << texture << std::endl;
+        return;
+    }
+    std::strncpy(out, relative.c_str(), TEXTURE_PATH_LENGTH - 1);
+}
+
+// Appends a table at the next aligned offset
+template <typename T>
+Table appendTable(std::vector<unsigned char>& file, const T* data, size_t count) {
+    size_t offset = (file.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    file.resize(offset + count * sizeof(T), 0);
+    if (count > 0) std::memcpy(file.data() + offset, data, count * sizeof(T));
+    return { offset, count };
+}
+
+// Tables of a file being written
+struct Contents {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Submesh> submeshes;
+    std::vector<Aabb> bounds;
+    std::vector<Room> rooms;
+    std::vector<float> covers;
+    std::vector<Wall> walls;
+    std::vector<Surface> surfaces;
+};
+
+bool appendMeshes(const std::vector<Mesh>& meshes, Contents& contents, const std::string& path) {
+    for (const Mesh& mesh : meshes) {
+        if (mesh.getLodCount() > 0 && mesh.getLods()[0].indexCount > 0 && !mesh.hasCpuData()) {
+            std::cerr << "LevelFile: mesh geometry was released, cannot write " << path << std::endl;
+            return false;
+        }
+
+        // Loading only checks ranges, so indices are checked here, once
+        const unsigned int* meshIndices = mesh.getIndexData();
+        for (size_t i = 0; i < mesh.getIndexCount(); i++) {
+            if (meshIndices[i] >= mesh.getVertexCount()) {
+                std::cerr << "LevelFile: submesh " << contents.submeshes.size()
+                          << " has an index past its vertices, cannot write " << path << std::endl;
+                return false;
+            }
+        }
+
+        Submesh submesh = {};
+        submesh.firstVertex = static_cast<uint32_t>(contents.vertices.size());
+        submesh.vertexCount = static_cast<uint32_t>(mesh.getVertexCount());
+        submesh.firstIndex = static_cast<uint32_t>(contents.indices.size());
+        submesh.indexCount = static_cast<uint32_t>(mesh.getIndexCount());
+        submesh.lodCount = static_cast<uint32_t>(std::min(mesh.getLodCount(), MAX_LODS));
+        for (uint32_t i = 0; i < submesh.lodCount; i++) {
+            const MeshLod& lod = mesh.getLods()[i];
+            submesh.lods[i] = { lod.indexOffset, lod.indexCount, lod.error };
+        }
+        storeVec3(submesh.boundsCenter, mesh.getBoundsCenter());
+        submesh.boundsRadius = mesh.getBoundsRadius();
+        storeTexture(submesh.texture, mesh, path);
+
+        Aabb box = {};
+        const Vertex* meshVertices = mesh.getVertexData();
+        glm::vec3 minPos(0.0f);
+        glm::vec3 maxPos(0.0f);
+        for (size_t i = 0; i < mesh.getVertexCount(); i++) {
+            minPos = i == 0 ? meshVertices[i].position : glm::min(minPos, meshVertices[i].position);
+            maxPos = i == 0 ? meshVertices[i].position : glm::max(maxPos, meshVertices[i].position);
+        }
+        storeVec3(box.min, minPos);
+        storeVec3(box.max, maxPos);
+
+        contents.vertices.insert(contents.vertices.end(), meshVertices, meshVertices + mesh.getVertexCount());
+        contents.indices.insert(contents.indices.end(), mesh.getIndexData(), mesh.getIndexData() + mesh.getIndexCount());
+        contents.submeshes.push_back(submesh);
+        contents.bounds.push_back(box);
+    }
+    return true;
+}
+
+bool writeContents(const Contents& contents, const std::string& path) {
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.vertexSize = sizeof(Vertex);
+
+    std::vector<unsigned char> file(sizeof(Header));
+    header.vertices = appendTable(file, contents.vertices.data(), contents.vertices.size());
+    header.indices = appendTable(file, contents.indices.data(), contents.indices.size());
+    header.submeshes = appendTable(file, contents.submeshes.data(), contents.submeshes.size());
+    header.bounds = appendTable(file, contents.bounds.data(), contents.bounds.size());
+    header.rooms = appendTable(file, contents.rooms.data(), contents.rooms.size());
+    header.covers = appendTable(file, contents.covers.data(), contents.covers.size());
+    header.covers.count /= 3;
+    header.walls = appendTable(file, contents.walls.data(), contents.walls.size());
+    header.surfaces = appendTable(file, contents.surfaces.data(), contents.surfaces.size());
+    header.fileSize = file.size();
+    std::memcpy(file.data(), &header, sizeof(Header));
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.write(reinterpret_cast<const char*>(file.data()), file.size())) {
+        std::cerr << "LevelFile: failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+LevelFile::LevelFile()
+    : m_header(nullptr)
+{
+}
+
+bool LevelFile::write(const Level& level, const std::string& path) {
+    Contents contents;
+    if (!appendMeshes(level.getMeshes(), contents, path)) return false;
+
+    for (const auto& source : level.m_rooms) {
+        Room room = {};
+        storeVec3(room.position, source.position);
+        storeVec3(room.size, source.size);
+        std::strncpy(room.type, source.type.c_str(), ROOM_TYPE_LENGTH - 1);
+        room.firstCover = static_cast<uint32_t>(contents.covers.size() / 3);
+        room.coverCount = static_cast<uint32_t>(source.coverPositions.size());
+        for (const auto& cover : source.coverPositions) {
+            contents.covers.insert(contents.covers.end(), { cover.x, cover.y, cover.z });
+        }
+        contents.rooms.push_back(room);
+    }
+
+    for (const auto& source : level.m_walls) {
+        Wall wall = {};
+        storeVec3(wall.start, source.start);
+        storeVec3(wall.end, source.end);
+        wall.height = source.height;
+        wall.hasDoor = source.hasDoor ? 1 : 0;
+        if (source.hasDoor) {
+            storeVec3(wall.doorPosition, source.doorPosition);
+            wall.doorWidth = source.doorWidth;
+        }
+        contents.walls.push_back(wall);
+    }
+
+    for (const auto& source : level.getSurfaces()) {
+        Surface surface;
+        storeVec3(surface.origin, source.origin);
+        storeVec3(surface.edgeU, source.edgeU);
+        storeVec3(surface.edgeV, source.edgeV);
+        contents.surfaces.push_back(surface);
+    }
+
+    return writeContents(contents, path);
+}
+
+bool LevelFile::writeMeshes(const std::vector<Mesh>& meshes, const std::string& path) {
+    Contents contents;
+    return appendMeshes(meshes, contents, path) && writeContents(contents, path);
+}
+
+bool LevelFile::readMeshes(const std::string& path, std::vector<Mesh>& meshes) {
+    LevelFile file;
+    if (!file.open(path)) return false;
+
+    const Submesh* submeshes = file.getSubmeshes();
+    for (uint64_t i = 0; i < file.getHeader().submeshes.count; i++) {
+        const Submesh& submesh = submeshes[i];
+        const Vertex* vertices = file.getVertices() + submesh.firstVertex;
+        const uint32_t* indices = file.getIndices() + submesh.firstIndex;
+
+        Mesh mesh;
+        mesh.setVertices(std::vector<Vertex>(vertices, vertices + submesh.vertexCount));
+        mesh.setIndices(std::vector<unsigned int>(indices, indices + submesh.indexCount));
+        std::string texture = file.getTexturePath(i);
+        if (!texture.empty()) {
+            mesh.setTextures({ Texture{ GpuHandle(), "texture_diffuse", texture } });
+        }
+        meshes.push_back(std::move(mesh));
+    }
+    return true;
+}
+
+bool LevelFile::open(const std::string& path) {
+    m_header = nullptr;
+    if (!m_file.open(path)) return false;
+
+    if (!validate(path)) {
+        m_file.close();
+        return false;
+    }
+    m_header = reinterpret_cast<const Header*>(m_file.getData());
+    size_t slash = path.find_last_of("/\\");
+    m_directory = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    return true;
+}
+
+std::string LevelFile::getTexturePath(uint64_t submesh) const {
+    const char* texture = getSubmeshes()[submesh].texture;
+    return texture[0] ? m_directory + texture : std::string();
+}
+
+bool LevelFile::validate(const std::string& path) const {
+    const size_t size = m_file.getSize();
+    if (size < sizeof(Header)) {
+        std::cerr << "LevelFile: " << path << " is too small" << std::endl;
+        return false;
+    }
+
+    const Header& header = *reinterpret_cast<const Header*>(m_file.getData());
+    if (header.magic != MAGIC || header.version != VERSION || header.vertexSize != sizeof(Vertex)) {
+        std::cerr << "LevelFile: " << path << " is not a version " << VERSION << " level" << std::endl;
+        return false;
+    }
+    if (header.fileSize != size) {
+        std::cerr << "LevelFile: " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    // Every table aligned and inside the file
+    struct Extent { const Table* table; size_t elementSize; };
+    const Extent extents[] = {
+        { &header.vertices, sizeof(Vertex) },
+        { &header.indices, sizeof(uint32_t) },
+        { &header.submeshes, sizeof(Submesh) },
+        { &header.bounds, sizeof(Aabb) },
+        { &header.rooms, sizeof(Room) },
+        { &header.covers, 3 * sizeof(float) },
+        { &header.walls, sizeof(Wall) },
+        { &header.surfaces, sizeof(Surface) },
+    };
+    for (const auto& extent : extents) {
+        const Table& entry = *extent.table;
+        if (entry.offset % ALIGNMENT != 0 || entry.offset > size ||
+            entry.count > (size - entry.offset) / extent.elementSize) {
+            std::cerr << "LevelFile: " << path << " has a corrupt table" << std::endl;
+            return false;
+        }
+    }
+    if (header.bounds.count != header.submeshes.count) {
+        std::cerr << "LevelFile: " << path << " has mismatched bounds" << std::endl;
+        return false;
+    }
+
+    // Ranges that are used as pointers later: submesh geometry, LODs, cover lists
+    const Submesh* submeshes = table<Submesh>(header.submeshes);
+#ifndef NDEBUG
+    const uint32_t* indices = table<uint32_t>(header.indices);
+#endif
+    for (uint64_t i = 0; i < header.submeshes.count; i++) {
+        const Submesh& submesh = submeshes[i];
+        bool valid = uint64_t(submesh.firstVertex) + submesh.vertexCount <= header.vertices.count &&
+                     uint64_t(submesh.firstIndex) + submesh.indexCount <= header.indices.count &&
+                     submesh.lodCount <= uint32_t(MAX_LODS) && submesh.texture[TEXTURE_PATH_LENGTH - 1] == 0;
+        for (uint32_t lod = 0; valid && lod < submesh.lodCount; lod++) {
+            valid = uint64_t(submesh.lods[lod].indexOffset) + submesh.lods[lod].indexCount <= submesh.indexCount;
+        }
+#ifndef NDEBUG
+        // Reads every index page; release builds trust the writer's check
+        for (uint32_t index = 0; valid && index < submesh.indexCount; index++) {
+            valid = indices[submesh.firstIndex + index] < submesh.vertexCount;
+        }
+#endif
+        if (!valid) {
+            std::cerr << "LevelFile: " << path << " has an invalid submesh " << i << std::endl;
+            return false;
+        }
+    }
+
+    const Room* rooms = table<Room>(header.rooms);
+    for (uint64_t i = 0; i < header.rooms.count; i++) {
+        if (uint64_t(rooms[i].firstCover) + rooms[i].coverCount > header.covers.count) {
+            std::cerr << "LevelFile: " << path << " has an invalid room " << i << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
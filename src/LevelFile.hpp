@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.hpp"
+#include "Mesh.hpp"
+
+class Level;
+
+// Binary level format. A fixed header is followed by tables, each starting on a
+// 16-byte boundary, so a mapped file can be used in place: vertex and index tables
+// go straight to the upload queue and nothing is parsed. Little-endian only.
+namespace LevelFormat {
+
+const uint32_t MAGIC = 0x4C4E4741;     // "AGNL"
+const uint32_t VERSION = 2;
+const uint64_t ALIGNMENT = 16;
+const int MAX_LODS = 4;
+const int ROOM_TYPE_LENGTH = 24;
+const int TEXTURE_PATH_LENGTH = 64;
+
+struct Table {
+    uint64_t offset;    // From the start of the file
+    uint64_t count;     // Elements, not bytes
+};
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexSize;
+    uint32_t reserved;
+    uint64_t fileSize;
+    Table vertices;     // Vertex
+    Table indices;      // uint32, relative to the submesh's first vertex
+    Table submeshes;    // Submesh
+    Table bounds;       // Aabb, one per submesh
+    Table rooms;        // Room
+    Table covers;       // float[3], referenced by rooms
+    Table walls;        // Wall
+    Table surfaces;     // Surface
+};
+
+struct Lod {
+    uint32_t indexOffset;   // Relative to the submesh's first index
+    uint32_t indexCount;
+    float error;
+};
+
+struct Submesh {
+    uint32_t firstVertex;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t lodCount;
+    Lod lods[MAX_LODS];
+    float boundsCenter[3];
+    float boundsRadius;
+    char texture[TEXTURE_PATH_LENGTH];     // Diffuse texture relative to the file, empty for none
+};
+
+struct Aabb {
+    float min[3];
+    float max[3];
+};
+
+struct Room {
+    float position[3];
+    float size[3];
+    char type[ROOM_TYPE_LENGTH];
+    uint32_t firstCover;
+    uint32_t coverCount;
+};
+
+struct Wall {
+    float start[3];
+    float end[3];
+    float height;
+    uint32_t hasDoor;
+    float doorPosition[3];
+    float doorWidth;
+};
+
+struct Surface {
+    float origin[3];
+    float edgeU[3];
+    float edgeV[3];
+};
+
+} // namespace LevelFormat
+
+// Reader (memory-mapped) and writer for the binary level format
+class LevelFile {
+public:
+    LevelFile();
+
+    // Serialize a level; meshes must still have CPU or mapped geometry
+    static bool write(const Level& level, const std::string& path);
+
+    // Meshes only, no rooms or surfaces (cooked models)
+    static bool writeMeshes(const std::vector<Mesh>& meshes, const std::string& path);
+    // Appends copies of a file's meshes with their textures (not yet loaded)
+    static bool readMeshes(const std::string& path, std::vector<Mesh>& meshes);
+
+    // Map and validate a file. Tables stay valid while this object is alive.
+    bool open(const std::string& path);
+
+    const LevelFormat::Header& getHeader() const { return *m_header; }
+    size_t getFileSize() const { return m_file.getSize(); }
+
+    const Vertex* getVertices() const { return table<Vertex>(m_header->vertices); }
+    const uint32_t* getIndices() const { return table<uint32_t>(m_header->indices); }
+    const LevelFormat::Submesh* getSubmeshes() const { return table<LevelFormat::Submesh>(m_header->submeshes); }
+    const LevelFormat::Aabb* getBounds() const { return table<LevelFormat::Aabb>(m_header->bounds); }
+    const LevelFormat::Room* getRooms() const { return table<LevelFormat::Room>(m_header->rooms); }
+    const float* getCovers() const { return table<float>(m_header->covers); }
+    const LevelFormat::Wall* getWalls() const { return table<LevelFormat::Wall>(m_header->walls); }
+    const LevelFormat::Surface* getSurfaces() const { return table<LevelFormat::Surface>(m_header->surfaces); }
+
+    // Texture path of a submesh as the game opens it, empty for none
+    std::string getTexturePath(uint64_t submesh) const;
+
+private:
+    MappedFile m_file;
+    const LevelFormat::Header* m_header;
+    std::string m_directory;        // Of the open file, with a trailing separator
+
+    template <typename T>
+    const T* table(const LevelFormat::Table& entry) const {
+        return reinterpret_cast<const T*>(m_file.getData() + entry.offset);
+    }
+
+    bool validate(const std::string& path) const;
+};
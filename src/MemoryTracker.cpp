@@ -0,0 +1,157 @@
+#include "MemoryTracker.hpp"
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+const int TAG_COUNT = static_cast<int>(MemoryTag::Count);
+const size_t MB = 1024 * 1024;
+
+// Counters are updated from operator new, so they are plain constant-initialized
+// atomics: usable before static constructors run and free of allocations
+struct TagCounters {
+    std::atomic<int64_t> liveBytes;
+    std::atomic<int64_t> peakBytes;
+    std::atomic<uint64_t> allocations;
+    std::atomic<int64_t> gpuBytes;
+    std::atomic<int64_t> gpuPeakBytes;
+};
+
+TagCounters s_counters[TAG_COUNT];
+
+// Written by setBudget/update on the main thread
+struct TagBudget {
+    size_t cpuBytes;
+    size_t gpuBytes;
+    uint64_t lastAllocations;
+    double allocationsPerSecond;
+    bool overCpu;
+    bool overGpu;
+};
+
+TagBudget s_budgets[TAG_COUNT] = {
+    { 0, 0, 0, 0.0, false, false },                 // Untagged
+    { 64 * MB, 256 * MB, 0, 0.0, false, false },    // Renderer
+    { 32 * MB, 0, 0, 0.0, false, false },           // Level
+    { 128 * MB, 256 * MB, 0, 0.0, false, false },   // Mesh
+    { 1 * MB, 0, 0, 0.0, false, false },            // Player
+    { 1 * MB, 0, 0, 0.0, false, false },            // Weapon
+    { 16 * MB, 0, 0, 0.0, false, false },           // Net
+    { 16 * MB, 0, 0, 0.0, false, false },           // AI
+};
+
+const char* TAG_NAMES[TAG_COUNT] = {
+    "Untagged", "Renderer", "Level", "Mesh", "Player", "Weapon", "Net", "AI"
+};
+
+thread_local MemoryTag t_currentTag = MemoryTag::Untagged;
+
+void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+int indexOf(MemoryTag tag) {
+    int index = static_cast<int>(tag);
+    return index >= 0 && index < TAG_COUNT ? index : 0;
+}
+
+} // namespace
+
+MemoryTracker::Scope::Scope(MemoryTag tag)
+    : m_previous(t_currentTag)
+{
+    t_currentTag = tag;
+}
+
+MemoryTracker::Scope::~Scope() {
+    t_currentTag = m_previous;
+}
+
+const char* MemoryTracker::getTagName(MemoryTag tag) {
+    return TAG_NAMES[indexOf(tag)];
+}
+
+MemoryTag MemoryTracker::getCurrentTag() {
+    return t_currentTag;
+}
+
+void MemoryTracker::setBudget(MemoryTag tag, size_t cpuBytes, size_t gpuBytes) {
+    TagBudget& budget = s_budgets[indexOf(tag)];
+    budget.cpuBytes = cpuBytes;
+    budget.gpuBytes = gpuBytes;
+}
+
+MemoryTracker::TagStats MemoryTracker::getStats(MemoryTag tag) {
+    const TagCounters& counters = s_counters[indexOf(tag)];
+    const TagBudget& budget = s_budgets[indexOf(tag)];
+    TagStats stats;
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.allocationsPerSecond = budget.allocationsPerSecond;
+    stats.gpuBytes = counters.gpuBytes.load(std::memory_order_relaxed);
+    stats.gpuPeakBytes = counters.gpuPeakBytes.load(std::memory_order_relaxed);
+    stats.budgetBytes = budget.cpuBytes;
+    stats.gpuBudgetBytes = budget.gpuBytes;
+    return stats;
+}
+
+void MemoryTracker::recordAllocation(MemoryTag tag, size_t bytes) {
+    TagCounters& counters = s_counters[indexOf(tag)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    int64_t live = counters.liveBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + bytes;
+    raisePeak(counters.peakBytes, live);
+}
+
+void MemoryTracker::recordFree(MemoryTag tag, size_t bytes) {
+    s_counters[indexOf(tag)].liveBytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+void MemoryTracker::addGpuBytes(MemoryTag tag, int64_t bytes) {
+    TagCounters& counters = s_counters[indexOf(tag)];
+    int64_t live = counters.gpuBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    raisePeak(counters.gpuPeakBytes, live);
+}
+
+void MemoryTracker::update(double elapsedSeconds) {
+    for (int i = 0; i < TAG_COUNT; i++) {
+        TagBudget& budget = s_budgets[i];
+        const TagStats stats = getStats(static_cast<MemoryTag>(i));
+        if (elapsedSeconds > 0.0) {
+            budget.allocationsPerSecond = (stats.allocations - budget.lastAllocations) / elapsedSeconds;
+        }
+        budget.lastAllocations = stats.allocations;
+
+        // Warn on the way over, re-arm once back under
+        bool overCpu = budget.cpuBytes > 0 && stats.liveBytes > static_cast<int64_t>(budget.cpuBytes);
+        bool overGpu = budget.gpuBytes > 0 && stats.gpuBytes > static_cast<int64_t>(budget.gpuBytes);
+        if (overCpu && !budget.overCpu) {
+            std::cerr << "MemoryTracker: " << TAG_NAMES[i] << " over budget, " << stats.liveBytes / 1024
+                      << " KB live of " << budget.cpuBytes / 1024 << " KB" << std::endl;
+        }
+        if (overGpu && !budget.overGpu) {
+            std::cerr << "MemoryTracker: " << TAG_NAMES[i] << " over GPU budget, " << stats.gpuBytes / 1024
+                      << " KB of " << budget.gpuBytes / 1024 << " KB" << std::endl;
+        }
+        budget.overCpu = overCpu;
+        budget.overGpu = overGpu;
+    }
+}
+
+void MemoryTracker::dump(std::ostream& out) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-10s %12s %12s %12s %10s %12s %12s\n",
+                  "tag", "live KB", "peak KB", "allocs", "allocs/s", "gpu KB", "gpu peak KB");
+    out << line;
+    for (int i = 0; i < TAG_COUNT; i++) {
+        const TagStats stats = getStats(static_cast<MemoryTag>(i));
+        std::snprintf(line, sizeof(line), "%-10s %12.1f %12.1f %12llu %10.1f %12.1f %12.1f\n", TAG_NAMES[i],
+                      stats.liveBytes / 1024.0, stats.peakBytes / 1024.0,
+                      static_cast<unsigned long long>(stats.allocations), stats.allocationsPerSecond,
+                      stats.gpuBytes / 1024.0, stats.gpuPeakBytes / 1024.0);
+        out << line;
+    }
+}
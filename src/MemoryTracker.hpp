@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Subsystems that memory is charged to
+enum class MemoryTag : uint8_t {
+    Untagged,
+    Renderer,
+    Level,
+    Mesh,
+    Player,
+    Weapon,
+    Net,
+    AI,
+    Count
+};
+
+// Per-subsystem memory accounting. Heap allocations are charged to the calling
+// thread's current tag (set with MemoryTracker::Scope) by the counted global
+// operator new in AllocationCounter.cpp; GPU buffers and textures are charged by
+// the code that creates them. Budgets are checked in update(), which warns once
+// each time a tag goes over.
+class MemoryTracker {
+public:
+    struct TagStats {
+        int64_t liveBytes = 0;
+        int64_t peakBytes = 0;
+        uint64_t allocations = 0;       // Total since startup
+        double allocationsPerSecond = 0.0;  // Over the last update() interval
+        int64_t gpuBytes = 0;
+        int64_t gpuPeakBytes = 0;
+        size_t budgetBytes = 0;         // 0 = unlimited
+        size_t gpuBudgetBytes = 0;
+    };
+
+    // Charges this thread's heap allocations to a tag until destroyed; nests
+    class Scope {
+    public:
+        explicit Scope(MemoryTag tag);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        MemoryTag m_previous;
+    };
+
+    static const char* getTagName(MemoryTag tag);
+    static MemoryTag getCurrentTag();
+
+    static void setBudget(MemoryTag tag, size_t cpuBytes, size_t gpuBytes);
+    static TagStats getStats(MemoryTag tag);
+
+    // Called by the allocator and GPU resource owners
+    static void recordAllocation(MemoryTag tag, size_t bytes);
+    static void recordFree(MemoryTag tag, size_t bytes);
+    static void addGpuBytes(MemoryTag tag, int64_t bytes);
+
+    // Refreshes allocation rates and checks budgets; call periodically
+    static void update(double elapsedSeconds);
+
+    // Table of every tag (end of a match or session)
+    static void dump(std::ostream& out);
+};
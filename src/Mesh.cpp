@@ -1,50 +1,282 @@
 #include "Mesh.hpp"
+#include "GpuResourceRegistry.hpp"
+#include "MemoryTracker.hpp"
+#include "MeshSimplifier.hpp"
+#include "UploadQueue.hpp"
 #include <GL/glew.h>
+#include <algorithm>
+#include <iostream>
+#include <utility>
 
 Mesh::Mesh()
-    : m_VAO(0)
-    , m_VBO(nullptr)
-    , m_EBO(nullptr)
-    , m_isSetup(false)
+    : m_mappedVertices(nullptr)
+    , m_mappedVertexCount(0)
+    , m_mappedIndices(nullptr)
+    , m_mappedIndexCount(0)
+    , m_boundsCenter(0.0f)
+    , m_boundsRadius(0.0f)
+    , m_isReady(false)
+    , m_gpuBytes(0)
+    , m_uploadQueue(nullptr)
+    , m_resourceGroup(0)
+    , m_residency(MeshResidency::Both)
+    , m_releasedBytes(0)
 {
 }
 
 Mesh::~Mesh() {
-    if (m_VBO) delete m_VBO;
-    if (m_EBO) delete m_EBO;
-    if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
+    releaseGpu();
+}
+
+Mesh::Mesh(Mesh&& other) noexcept
+    : m_vertices(std::move(other.m_vertices))
+    , m_indices(std::move(other.m_indices))
+    , m_textures(std::move(other.m_textures))
+    , m_lods(std::move(other.m_lods))
+    , m_mappedVertices(other.m_mappedVertices)
+    , m_mappedVertexCount(other.m_mappedVertexCount)
+    , m_mappedIndices(other.m_mappedIndices)
+    , m_mappedIndexCount(other.m_mappedIndexCount)
+    , m_boundsCenter(other.m_boundsCenter)
+    , m_boundsRadius(other.m_boundsRadius)
+    , m_VAO(other.m_VAO)
+    , m_VBO(std::move(other.m_VBO))
+    , m_EBO(std::move(other.m_EBO))
+    , m_isReady(other.m_isReady)
+    , m_gpuBytes(other.m_gpuBytes)
+    , m_uploadQueue(other.m_uploadQueue)
+    , m_resourceGroup(other.m_resourceGroup)
+    , m_residency(other.m_residency)
+    , m_releasedBytes(other.m_releasedBytes)
+{
+    if (m_uploadQueue) m_uploadQueue->retarget(other, *this);
+    other.m_VAO = GpuHandle();
+    other.m_isReady = false;
+    other.m_gpuBytes = 0;
+    other.m_uploadQueue = nullptr;
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this != &other) {
+        releaseGpu();
+        m_vertices = std::move(other.m_vertices);
+        m_indices = std::move(other.m_indices);
+        m_textures = std::move(other.m_textures);
+        m_lods = std::move(other.m_lods);
+        m_mappedVertices = other.m_mappedVertices;
+        m_mappedVertexCount = other.m_mappedVertexCount;
+        m_mappedIndices = other.m_mappedIndices;
+        m_mappedIndexCount = other.m_mappedIndexCount;
+        m_boundsCenter = other.m_boundsCenter;
+        m_boundsRadius = other.m_boundsRadius;
+        m_VAO = other.m_VAO;
+        m_VBO = std::move(other.m_VBO);
+        m_EBO = std::move(other.m_EBO);
+        m_isReady = other.m_isReady;
+        m_gpuBytes = other.m_gpuBytes;
+        m_uploadQueue = other.m_uploadQueue;
+        m_resourceGroup = other.m_resourceGroup;
+        m_residency = other.m_residency;
+        m_releasedBytes = other.m_releasedBytes;
+        if (m_uploadQueue) m_uploadQueue->retarget(other, *this);
+        other.m_VAO = GpuHandle();
+        other.m_isReady = false;
+        other.m_gpuBytes = 0;
+        other.m_uploadQueue = nullptr;
+    }
+    return *this;
+}
+
+void Mesh::invalidateGpu() {
+    // GL objects are kept and resized by the next upload
+    if (m_uploadQueue) m_uploadQueue->cancel(*this);
+    m_isReady = false;
+}
+
+void Mesh::releaseGpu() {
+    if (m_uploadQueue) m_uploadQueue->cancel(*this);
+    GpuResourceRegistry::get().release(m_VAO);
+    m_VAO = GpuHandle();
+    m_VBO = VertexBuffer();
+    m_EBO = VertexBuffer();
+    m_isReady = false;
+    m_gpuBytes = 0;
+}
+
+void Mesh::releaseCpu() {
+    size_t bytes = m_vertices.capacity() * sizeof(Vertex) + m_indices.capacity() * sizeof(unsigned int);
+    std::vector<Vertex>().swap(m_vertices);
+    std::vector<unsigned int>().swap(m_indices);
+    m_releasedBytes += bytes;
+
+    // Mapped memory belongs to its file; just stop referencing it
+    m_mappedVertices = nullptr;
+    m_mappedVertexCount = 0;
+    m_mappedIndices = nullptr;
+    m_mappedIndexCount = 0;
+}
+
+void Mesh::discardCpuData() {
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    releaseCpu();
+}
+
+void Mesh::setResidency(MeshResidency residency) {
+    if (residency == MeshResidency::GpuOnly) {
+        if (m_isReady) releaseCpu();
+    } else if (residency == MeshResidency::CpuOnly) {
+        releaseGpu();
+    }
+    if (residency != MeshResidency::GpuOnly && !m_lods.empty() && m_lods[0].indexCount > 0 && !hasCpuData()) {
+        std::cerr << "Mesh: CPU data was already released, geometry cannot be restored" << std::endl;
+    }
+    m_residency = residency;
+}
+
+void Mesh::appendCollision(CollisionMesh& collision) const {
+    if (m_lods.empty() || !hasCpuData()) return;
+
+    unsigned int base = static_cast<unsigned int>(collision.positions.size());
+    const Vertex* vertices = getVertexData();
+    for (size_t i = 0; i < getVertexCount(); i++) {
+        collision.positions.push_back(vertices[i].position);
+    }
+    const unsigned int* indices = getIndexData();
+    const MeshLod& lod = m_lods[0];
+    for (unsigned int i = 0; i < lod.indexCount; i++) {
+        collision.indices.push_back(base + indices[lod.indexOffset + i]);
+    }
+}
+
+MeshMemoryStats Mesh::getMemoryStats() const {
+    MeshMemoryStats stats;
+    stats.cpuBytes = m_vertices.capacity() * sizeof(Vertex) + m_indices.capacity() * sizeof(unsigned int);
+    stats.gpuBytes = m_gpuBytes;
+    stats.releasedBytes = m_releasedBytes;
+    return stats;
 }
 
 void Mesh::setVertices(const std::vector<Vertex>& vertices) {
-    m_vertices = vertices;
-    m_isSetup = false;
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    setVertices(std::vector<Vertex>(vertices));
+}
+
+void Mesh::setVertices(std::vector<Vertex>&& vertices) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    m_vertices = std::move(vertices);
+    m_mappedVertices = nullptr;
+    m_mappedIndices = nullptr;
+    invalidateGpu();
+
+    // Bounding sphere around the AABB center
+    glm::vec3 minPos(0.0f);
+    glm::vec3 maxPos(0.0f);
+    if (!m_vertices.empty()) {
+        minPos = maxPos = m_vertices[0].position;
+    }
+    for (const auto& vertex : m_vertices) {
+        minPos = glm::min(minPos, vertex.position);
+        maxPos = glm::max(maxPos, vertex.position);
+    }
+
+    m_boundsCenter = (minPos + maxPos) * 0.5f;
+    m_boundsRadius = 0.0f;
+    for (const auto& vertex : m_vertices) {
+        m_boundsRadius = std::max(m_boundsRadius, glm::distance(m_boundsCenter, vertex.position));
+    }
 }
 
 void Mesh::setIndices(const std::vector<unsigned int>& indices) {
-    m_indices = indices;
-    m_isSetup = false;
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    setIndices(std::vector<unsigned int>(indices));
+}
+
+void Mesh::setIndices(std::vector<unsigned int>&& indices) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    m_indices = std::move(indices);
+    m_mappedVertices = nullptr;
+    m_mappedIndices = nullptr;
+    m_lods.clear();
+    m_lods.push_back({0, static_cast<unsigned int>(m_indices.size()), 0.0f});
+    invalidateGpu();
+}
+
+void Mesh::setMappedGeometry(const Vertex* vertices, size_t vertexCount,
+                             const unsigned int* indices, size_t indexCount,
+                             const std::vector<MeshLod>& lods,
+                             const glm::vec3& boundsCenter, float boundsRadius) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    std::vector<Vertex>().swap(m_vertices);
+    std::vector<unsigned int>().swap(m_indices);
+    m_mappedVertices = vertices;
+    m_mappedVertexCount = vertexCount;
+    m_mappedIndices = indices;
+    m_mappedIndexCount = indexCount;
+    m_lods = lods;
+    m_boundsCenter = boundsCenter;
+    m_boundsRadius = boundsRadius;
+    invalidateGpu();
 }
 
 void Mesh::setTextures(const std::vector<Texture>& textures) {
     m_textures = textures;
 }
 
-void Mesh::setupMesh() const {
-    if (m_isSetup) return;
+void Mesh::generateLods(int maxLods) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    if (m_lods.empty() || m_vertices.empty()) return;
+
+    // Drop previously generated levels, keep LOD 0
+    m_indices.resize(m_lods[0].indexCount);
+    m_lods.resize(1);
+
+    // Allowed deviation per level, relative to the bounding radius
+    const float errorScale[] = { 0.0f, 0.01f, 0.04f, 0.12f };
+    const int levelCount = std::min(maxLods, static_cast<int>(sizeof(errorScale) / sizeof(errorScale[0])));
+
+    for (int level = 1; level < levelCount; level++) {
+        const MeshLod& previous = m_lods.back();
+
+        float error = 0.0f;
+        std::vector<unsigned int> lodIndices = MeshSimplifier::simplify(
+            m_vertices,
+            m_indices.data() + previous.indexOffset,
+            previous.indexCount,
+            previous.indexCount / 2,
+            m_boundsRadius * errorScale[level],
+            &error);
+
+        // Not worth a level if it barely saves anything
+        if (lodIndices.empty() || lodIndices.size() > previous.indexCount * 3 / 4) break;
+
+        MeshLod lod;
+        lod.indexOffset = static_cast<unsigned int>(m_indices.size());
+        lod.indexCount = static_cast<unsigned int>(lodIndices.size());
+        lod.error = std::max(error, previous.error);
+        m_indices.insert(m_indices.end(), lodIndices.begin(), lodIndices.end());
+        m_lods.push_back(lod);
+    }
+
+    invalidateGpu();
+}
+
+bool Mesh::createGpuBuffers() {
+    MemoryTracker::Scope memoryScope(MemoryTag::Mesh);
+    if (getVertexCount() == 0 || getIndexCount() == 0) return false;
 
-    // Create VAO
-    glGenVertexArrays(1, &m_VAO);
-    glBindVertexArray(m_VAO);
+    GpuResourceRegistry& registry = GpuResourceRegistry::get();
+    GpuResourceRegistry::GroupScope groupScope(m_resourceGroup);
 
-    // Create VBO
-    m_VBO = new VertexBuffer();
-    m_VBO->bind();
-    m_VBO->setData(m_vertices.data(), m_vertices.size() * sizeof(Vertex));
+    // Create VAO (reused when the data changed after a previous upload)
+    if (!registry.isAlive(m_VAO)) m_VAO = registry.create(GpuResourceType::VertexArray);
+    glBindVertexArray(registry.getName(m_VAO));
 
-    // Create EBO
-    m_EBO = new VertexBuffer(GL_ELEMENT_ARRAY_BUFFER);
-    m_EBO->bind();
-    m_EBO->setData(m_indices.data(), m_indices.size() * sizeof(unsigned int));
+    // Storage only; the contents arrive through the upload queue's staging ring
+    if (!m_VBO.isValid()) m_VBO = VertexBuffer(GL_ARRAY_BUFFER);
+    m_VBO.setData(nullptr, getVertexCount() * sizeof(Vertex));
+
+    if (!m_EBO.isValid()) m_EBO = VertexBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    m_EBO.setData(nullptr, getIndexCount() * sizeof(unsigned int));
 
     // Set vertex attribute pointers
     // Position attribute
@@ -61,35 +293,33 @@ void Mesh::setupMesh() const {
 
     glBindVertexArray(0);
 
-    m_isSetup = true;
+    m_gpuBytes = getVertexCount() * sizeof(Vertex) + getIndexCount() * sizeof(unsigned int);
+    return true;
 }
 
-void Mesh::draw() const {
-    if (!m_isSetup) {
-        setupMesh();
-    }
+void Mesh::finishUpload() {
+    m_uploadQueue = nullptr;
+    m_isReady = true;
+    if (m_residency == MeshResidency::GpuOnly) releaseCpu();
+}
 
-    // Bind appropriate textures
-    unsigned int diffuseNr = 1;
-    unsigned int specularNr = 1;
+void Mesh::draw(int lod) const {
+    if (!m_isReady || m_lods.empty()) return;
+    const GpuResourceRegistry& registry = GpuResourceRegistry::get();
+    unsigned int vao = registry.getName(m_VAO);
+    if (!vao) return;
+    lod = std::min(std::max(lod, 0), static_cast<int>(m_lods.size()) - 1);
 
+    // Textures go to consecutive units in order; no per-draw strings or lookups
     for (unsigned int i = 0; i < m_textures.size(); i++) {
         glActiveTexture(GL_TEXTURE0 + i);
-
-        std::string number;
-        std::string name = m_textures[i].type;
-
-        if (name == "texture_diffuse")
-            number = std::to_string(diffuseNr++);
-        else if (name == "texture_specular")
-            number = std::to_string(specularNr++);
-
-        glBindTexture(GL_TEXTURE_2D, m_textures[i].id);
+        glBindTexture(GL_TEXTURE_2D, registry.getName(m_textures[i].handle));
     }
 
     // Draw mesh
-    glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, m_lods[lod].indexCount, GL_UNSIGNED_INT,
+                   (void*)(m_lods[lod].indexOffset * sizeof(unsigned int)));
     glBindVertexArray(0);
 
     // Reset to default texture
@@ -3,8 +3,11 @@
 #include <vector>
 #include <string>
 #include <glm/glm.hpp>
+#include "GpuResourceRegistry.hpp"
 #include "VertexBuffer.hpp"
 
+class UploadQueue;
+
 struct Vertex {
     glm::vec3 position;
     glm::vec3 normal;
@@ -12,42 +15,169 @@ struct Vertex {
 };
 
 struct Texture {
-    unsigned int id;
+    GpuHandle handle;       // Null until the image is loaded
     std::string type;
     std::string path;
 };
 
+// One level of detail: a range inside the mesh's shared index buffer
+struct MeshLod {
+    unsigned int indexOffset;
+    unsigned int indexCount;
+    float error;        // Max surface deviation from LOD 0, in model units
+};
+
+// Where a mesh's geometry lives once it has been set up
+enum class MeshResidency {
+    Both,       // CPU arrays kept after upload (tools, rebuilding GPU data)
+    GpuOnly,    // CPU arrays released once uploaded
+    CpuOnly     // Never uploaded; geometry for queries only
+};
+
+// Positions and triangle indices only, for physics and ray queries
+struct CollisionMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> indices;
+
+    size_t getMemoryUsage() const {
+        return positions.capacity() * sizeof(glm::vec3) + indices.capacity() * sizeof(unsigned int);
+    }
+};
+
+struct MeshMemoryStats {
+    size_t cpuBytes = 0;        // Vertex/index arrays in system memory
+    size_t gpuBytes = 0;        // Uploaded vertex/index buffers
+    size_t collisionBytes = 0;  // Collision-only copies
+    size_t releasedBytes = 0;   // CPU bytes freed by the residency policy
+
+    MeshMemoryStats& operator+=(const MeshMemoryStats& other) {
+        cpuBytes += other.cpuBytes;
+        gpuBytes += other.gpuBytes;
+        collisionBytes += other.collisionBytes;
+        releasedBytes += other.releasedBytes;
+        return *this;
+    }
+};
+
+// Move-only: GL objects are owned by value and released with the mesh
 class Mesh {
 public:
     Mesh();
     ~Mesh();
 
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
+
     // Set mesh data
     void setVertices(const std::vector<Vertex>& vertices);
     void setIndices(const std::vector<unsigned int>& indices);
+    void setVertices(std::vector<Vertex>&& vertices);      // Takes the array without copying
+    void setIndices(std::vector<unsigned int>&& indices);
     void setTextures(const std::vector<Texture>& textures);
 
-    // Get mesh data
+    // Geometry in memory the mesh does not own (a mapped level file), used in place
+    // of the vertex/index arrays until it is released. Replaced by setVertices/setIndices.
+    void setMappedGeometry(const Vertex* vertices, size_t vertexCount,
+                           const unsigned int* indices, size_t indexCount,
+                           const std::vector<MeshLod>& lods,
+                           const glm::vec3& boundsCenter, float boundsRadius);
+
+    // Get mesh data (owned arrays; empty for mapped geometry)
     const std::vector<Vertex>& getVertices() const { return m_vertices; }
     const std::vector<unsigned int>& getIndices() const { return m_indices; }
     const std::vector<Texture>& getTextures() const { return m_textures; }
 
-    // Rendering
-    void draw() const;
+    // Geometry source, owned or mapped
+    const Vertex* getVertexData() const { return m_mappedVertices ? m_mappedVertices : m_vertices.data(); }
+    const unsigned int* getIndexData() const { return m_mappedIndices ? m_mappedIndices : m_indices.data(); }
+    size_t getVertexCount() const { return m_mappedVertices ? m_mappedVertexCount : m_vertices.size(); }
+    size_t getIndexCount() const { return m_mappedIndices ? m_mappedIndexCount : m_indices.size(); }
 
-    // Setup the mesh for rendering
-    void setupMesh() const;
+    // Level of detail
+    // Builds up to maxLods index ranges (LOD 0 included) with quadric error simplification
+    void generateLods(int maxLods = 4);
+    const std::vector<MeshLod>& getLods() const { return m_lods; }
+    int getLodCount() const { return static_cast<int>(m_lods.size()); }
+
+    // Bounding sphere in model space
+    const glm::vec3& getBoundsCenter() const { return m_boundsCenter; }
+    float getBoundsRadius() const { return m_boundsRadius; }
+
+    // GL objects are created in this GpuResourceRegistry group (a level's), so they
+    // can be released in bulk; 0 keeps them until the mesh releases them
+    void setResourceGroup(uint32_t group) { m_resourceGroup = group; }
+
+    // Rendering; draws nothing until an UploadQueue has made the mesh ready, or
+    // once its group has been released
+    void draw(int lod = 0) const;
+    bool isReady() const { return m_isReady; }
+    bool isUploadPending() const { return m_uploadQueue != nullptr; }
+    // GL buffer names for drawing the mesh through another vertex array; 0 until
+    // the upload has allocated them
+    unsigned int getVertexBufferID() const { return m_VBO.getID(); }
+    unsigned int getIndexBufferID() const { return m_EBO.getID(); }
+
+    // Residency policy. GpuOnly frees the CPU arrays once the upload has completed;
+    // LODs and bounds are kept. CpuOnly releases the GL objects.
+    void setResidency(MeshResidency residency);
+    MeshResidency getResidency() const { return m_residency; }
+    bool hasCpuData() const { return getVertexCount() > 0; }
+    // Frees the CPU arrays now, for geometry that was copied into a MeshBatch and
+    // is never uploaded itself; LODs and bounds are kept
+    void discardCpuData();
+
+    // Appends the LOD 0 triangles to a collision copy
+    void appendCollision(CollisionMesh& collision) const;
+
+    MeshMemoryStats getMemoryStats() const;
 
 private:
     std::vector<Vertex> m_vertices;
     std::vector<unsigned int> m_indices;
     std::vector<Texture> m_textures;
+    std::vector<MeshLod> m_lods;
 
-    // Render data (mutable to allow lazy initialization in const methods)
-    mutable unsigned int m_VAO;
-    mutable VertexBuffer* m_VBO;
-    mutable VertexBuffer* m_EBO;
+    const Vertex* m_mappedVertices;
+    size_t m_mappedVertexCount;
+    const unsigned int* m_mappedIndices;
+    size_t m_mappedIndexCount;
+
+    glm::vec3 m_boundsCenter;
+    float m_boundsRadius;
+
+    // Render data, filled by UploadQueue
+    GpuHandle m_VAO;
+    VertexBuffer m_VBO;
+    VertexBuffer m_EBO;
+
+    bool m_isReady;
+    size_t m_gpuBytes;
+    UploadQueue* m_uploadQueue;     // Set while an upload is pending
+    uint32_t m_resourceGroup;
+
+    MeshResidency m_residency;
+    size_t m_releasedBytes;
+
+    friend class UploadQueue;
+    bool createGpuBuffers();
+    void finishUpload();
+    void invalidateGpu();
+    void releaseGpu();
+    void releaseCpu();
+};
 
-    mutable bool m_isSetup;
+// Meshes merged into one vertex and index array, so a single multi-draw can cover
+// them all. Each entry records where a source mesh starts in the merged arrays;
+// its LODs and bounds are read from the source.
+struct MeshBatch {
+    struct Entry {
+        const Mesh* source;
+        int baseVertex;
+        unsigned int firstIndex;
+    };
 
+    Mesh mesh;
+    std::vector<Entry> entries;
 };
@@ -0,0 +1,258 @@
+#include "MeshSimplifier.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// Symmetric 4x4 plane quadric, plus the accumulated weight so the error can be
+// normalised back into world units.
+struct Quadric {
+    double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+    double b2 = 0.0, bc = 0.0, bd = 0.0;
+    double c2 = 0.0, cd = 0.0;
+    double d2 = 0.0;
+    double w = 0.0;
+
+    void addPlane(const glm::dvec3& n, double d, double weight) {
+        a2 += weight * n.x * n.x; ab += weight * n.x * n.y; ac += weight * n.x * n.z; ad += weight * n.x * d;
+        b2 += weight * n.y * n.y; bc += weight * n.y * n.z; bd += weight * n.y * d;
+        c2 += weight * n.z * n.z; cd += weight * n.z * d;
+        d2 += weight * d * d;
+        w += weight;
+    }
+
+    void add(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+        w += q.w;
+    }
+
+    // Weighted mean squared distance of p to the accumulated planes
+    double error(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+                 + b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+                 + c2 * z * z + 2.0 * cd * z
+                 + d2;
+        return w > 0.0 ? std::max(e, 0.0) / w : 0.0;
+    }
+};
+
+struct Collapse {
+    unsigned int from;
+    unsigned int to;
+    double cost;
+};
+
+// Weight of the virtual planes that keep open borders from shrinking
+const double BORDER_WEIGHT = 10.0;
+
+unsigned int resolve(std::vector<unsigned int>& remap, unsigned int v) {
+    unsigned int root = v;
+    while (remap[root] != root) root = remap[root];
+    while (remap[v] != root) {
+        unsigned int next = remap[v];
+        remap[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+double edgeCost(const std::vector<Quadric>& quadrics, const std::vector<Vertex>& vertices,
+                unsigned int from, unsigned int to) {
+    Quadric q = quadrics[from];
+    q.add(quadrics[to]);
+    return q.error(vertices[to].position);
+}
+
+// Replacing `from` by `to` must not flip or collapse any surviving triangle around `from`
+bool collapseKeepsOrientation(const std::vector<Vertex>& vertices,
+                              const std::vector<unsigned int>& triangles,
+                              const std::vector<unsigned int>& adjacencyOffsets,
+                              const std::vector<unsigned int>& adjacency,
+                              unsigned int from, unsigned int to) {
+    for (unsigned int i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1]; i++) {
+        const unsigned int* tri = &triangles[adjacency[i] * 3];
+        if (tri[0] == to || tri[1] == to || tri[2] == to) continue; // removed by the collapse
+
+        glm::vec3 p[3];
+        glm::vec3 q[3];
+        for (int k = 0; k < 3; k++) {
+            p[k] = vertices[tri[k]].position;
+            q[k] = tri[k] == from ? vertices[to].position : p[k];
+        }
+
+        glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+        if (glm::dot(before, after) <= 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::vector<unsigned int> MeshSimplifier::simplify(const std::vector<Vertex>& vertices,
+                                                   const unsigned int* indices,
+                                                   size_t indexCount,
+                                                   size_t targetIndexCount,
+                                                   float maxError,
+                                                   float* outError) {
+    const unsigned int vertexCount = static_cast<unsigned int>(vertices.size());
+    const size_t targetTriangles = targetIndexCount / 3;
+    const double maxErrorSq = double(maxError) * double(maxError);
+
+    std::vector<unsigned int> triangles(indices, indices + indexCount);
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<unsigned int> remap(vertexCount);
+    for (unsigned int v = 0; v < vertexCount; v++) remap[v] = v;
+
+    // Face quadrics, area weighted
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        glm::dvec3 p0 = vertices[triangles[i]].position;
+        glm::dvec3 p1 = vertices[triangles[i + 1]].position;
+        glm::dvec3 p2 = vertices[triangles[i + 2]].position;
+        glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+        double len = glm::length(n);
+        if (len <= 0.0) continue;
+        n /= len;
+        double area = 0.5 * len;
+        for (int k = 0; k < 3; k++) {
+            quadrics[triangles[i + k]].addPlane(n, -glm::dot(n, p0), area);
+        }
+    }
+
+    // Border quadrics: a plane through every open edge, perpendicular to its face
+    std::vector<uint64_t> edges;
+    edges.reserve(triangles.size());
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            uint64_t a = triangles[i + k];
+            uint64_t b = triangles[i + (k + 1) % 3];
+            edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+        }
+    }
+    std::vector<uint64_t> sortedEdges = edges;
+    std::sort(sortedEdges.begin(), sortedEdges.end());
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            uint64_t key = edges[i + k];
+            auto range = std::equal_range(sortedEdges.begin(), sortedEdges.end(), key);
+            if (range.second - range.first != 1) continue;
+
+            unsigned int a = triangles[i + k];
+            unsigned int b = triangles[i + (k + 1) % 3];
+            unsigned int c = triangles[i + (k + 2) % 3];
+            glm::dvec3 pa = vertices[a].position;
+            glm::dvec3 pb = vertices[b].position;
+            glm::dvec3 pc = vertices[c].position;
+            glm::dvec3 faceNormal = glm::cross(pb - pa, pc - pa);
+            glm::dvec3 n = glm::cross(pb - pa, faceNormal);
+            double len = glm::length(n);
+            if (len <= 0.0) continue;
+            n /= len;
+            double weight = BORDER_WEIGHT * glm::length(pb - pa);
+            quadrics[a].addPlane(n, -glm::dot(n, pa), weight);
+            quadrics[b].addPlane(n, -glm::dot(n, pa), weight);
+        }
+    }
+
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1);
+    std::vector<unsigned int> adjacency;
+    std::vector<Collapse> candidates;
+    std::vector<char> locked(vertexCount);
+    double achievedError = 0.0;
+
+    for (;;) {
+        // Rebuild the live triangle list through the current remap
+        size_t live = 0;
+        for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+            unsigned int a = resolve(remap, triangles[i]);
+            unsigned int b = resolve(remap, triangles[i + 1]);
+            unsigned int c = resolve(remap, triangles[i + 2]);
+            if (a == b || b == c || a == c) continue;
+            triangles[live++] = a;
+            triangles[live++] = b;
+            triangles[live++] = c;
+        }
+        triangles.resize(live);
+
+        const size_t triangleCount = triangles.size() / 3;
+        if (triangleCount <= targetTriangles) break;
+
+        // Vertex -> triangle adjacency
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (unsigned int v : triangles) adjacencyOffsets[v + 1]++;
+        for (unsigned int v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(triangles.size());
+        {
+            std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < triangles.size(); i++) {
+                adjacency[fill[triangles[i]]++] = static_cast<unsigned int>(i / 3);
+            }
+        }
+
+        // Candidate collapses, cheapest direction per edge
+        edges.clear();
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                uint64_t a = triangles[i + k];
+                uint64_t b = triangles[i + (k + 1) % 3];
+                edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        candidates.clear();
+        for (uint64_t e : edges) {
+            unsigned int a = static_cast<unsigned int>(e >> 32);
+            unsigned int b = static_cast<unsigned int>(e & 0xffffffffu);
+            double costAB = edgeCost(quadrics, vertices, a, b);
+            double costBA = edgeCost(quadrics, vertices, b, a);
+            if (costAB <= costBA) {
+                candidates.push_back({a, b, costAB});
+            } else {
+                candidates.push_back({b, a, costBA});
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+        // Apply independent collapses; vertices around each collapse are locked for this pass
+        std::fill(locked.begin(), locked.end(), 0);
+        size_t remaining = triangleCount;
+        size_t collapsed = 0;
+        for (const Collapse& c : candidates) {
+            if (c.cost > maxErrorSq || remaining <= targetTriangles) break;
+            if (locked[c.from] || locked[c.to]) continue;
+            if (!collapseKeepsOrientation(vertices, triangles, adjacencyOffsets, adjacency, c.from, c.to)) continue;
+
+            size_t removed = 0;
+            for (unsigned int v : {c.from, c.to}) {
+                for (unsigned int i = adjacencyOffsets[v]; i < adjacencyOffsets[v + 1]; i++) {
+                    const unsigned int* tri = &triangles[adjacency[i] * 3];
+                    for (int k = 0; k < 3; k++) locked[tri[k]] = 1;
+                    if (v == c.from && (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)) removed++;
+                }
+            }
+
+            remap[c.from] = c.to;
+            quadrics[c.to].add(quadrics[c.from]);
+            remaining -= std::min(removed, remaining);
+            achievedError = std::max(achievedError, c.cost);
+            collapsed++;
+        }
+
+        if (collapsed == 0) break;
+    }
+
+    if (outError) {
+        *outError = static_cast<float>(std::sqrt(achievedError));
+    }
+    return triangles;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+#include "Mesh.hpp"
+
+// Quadric error metric simplifier.
+// Works purely on the index list: the vertex buffer is left untouched so every
+// LOD can share it and only needs its own index range.
+class MeshSimplifier {
+public:
+    // Collapse edges until the triangle count reaches targetIndexCount / 3 or the
+    // next collapse would move the surface further than maxError (world units).
+    // Returns the simplified index list; the achieved error is written to outError.
+    static std::vector<unsigned int> simplify(const std::vector<Vertex>& vertices,
+                                              const unsigned int* indices,
+                                              size_t indexCount,
+                                              size_t targetIndexCount,
+                                              float maxError,
+                                              float* outError = nullptr);
+};
@@ -0,0 +1,211 @@
+#include "ObjImporter.hpp"
+#include "MappedFile.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+struct CornerKey {
+    int position;
+    int texCoord;
+    int normal;
+
+    bool operator==(const CornerKey& other) const {
+        return position == other.position && texCoord == other.texCoord && normal == other.normal;
+    }
+};
+
+struct CornerHash {
+    size_t operator()(const CornerKey& key) const {
+        size_t hash = static_cast<size_t>(key.position) * 0x9E3779B97F4A7C15ull;
+        hash ^= static_cast<size_t>(key.texCoord) * 0xC2B2AE3D27D4EB4Full + (hash << 6) + (hash >> 2);
+        hash ^= static_cast<size_t>(key.normal) * 0x165667B19E3779F9ull + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+};
+
+// Mesh being assembled from one object/group
+struct Builder {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<bool> hasNormal;
+    std::unordered_map<CornerKey, unsigned int, CornerHash> corners;
+
+    void flush(std::vector<Mesh>& meshes) {
+        if (indices.empty()) return;
+
+        // Area-weighted face normals for corners without one
+        bool missing = false;
+        for (bool has : hasNormal) missing = missing || !has;
+        if (missing) {
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                const glm::vec3& a = vertices[indices[i]].position;
+                const glm::vec3& b = vertices[indices[i + 1]].position;
+                const glm::vec3& c = vertices[indices[i + 2]].position;
+                glm::vec3 faceNormal = glm::cross(b - a, c - a);
+                for (int k = 0; k < 3; k++) {
+                    if (!hasNormal[indices[i + k]]) vertices[indices[i + k]].normal += faceNormal;
+                }
+            }
+            for (size_t i = 0; i < vertices.size(); i++) {
+                if (hasNormal[i]) continue;
+                float length = glm::length(vertices[i].normal);
+                vertices[i].normal = length > 0.0f ? vertices[i].normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        }
+
+        Mesh mesh;
+        mesh.setVertices(vertices);
+        mesh.setIndices(indices);
+        meshes.push_back(std::move(mesh));
+
+        vertices.clear();
+        indices.clear();
+        hasNormal.clear();
+        corners.clear();
+    }
+};
+
+// OBJ indices are 1-based, negative values count back from the end
+bool resolveIndex(long value, size_t count, int& index) {
+    if (value > 0 && static_cast<size_t>(value) <= count) {
+        index = static_cast<int>(value - 1);
+        return true;
+    }
+    if (value < 0 && static_cast<size_t>(-value) <= count) {
+        index = static_cast<int>(count + value);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool ObjImporter::import(const std::string& path, std::vector<Mesh>& meshes) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    std::string error;
+    if (!parse(reinterpret_cast<const char*>(file.getData()), file.getSize(), meshes, error)) {
+        std::cerr << "ObjImporter: " << path << ": " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ObjImporter::parse(const char* data, size_t size, std::vector<Mesh>& meshes, std::string& error) {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    Builder builder;
+
+    // Lines are copied out so number parsing never runs past the end of the mapping
+    std::string line;
+    std::vector<CornerKey> face;
+    int lineNumber = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        const char* end = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        size_t length = end ? static_cast<size_t>(end - (data + pos)) : size - pos;
+        line.assign(data + pos, length);
+        pos += length + 1;
+        lineNumber++;
+
+        const char* cursor = line.c_str();
+        while (*cursor == ' ' || *cursor == '\t') cursor++;
+        if (*cursor == '#' || *cursor == '\0' || *cursor == '\r') continue;
+
+        char* next = nullptr;
+        if (cursor[0] == 'v' && cursor[1] == ' ') {
+            glm::vec3 p;
+            p.x = std::strtof(cursor + 2, &next);
+            p.y = std::strtof(next, &next);
+            p.z = std::strtof(next, &next);
+            positions.push_back(p);
+        } else if (cursor[0] == 'v' && cursor[1] == 't') {
+            glm::vec2 t;
+            t.x = std::strtof(cursor + 2, &next);
+            t.y = std::strtof(next, &next);
+            texCoords.push_back(t);
+        } else if (cursor[0] == 'v' && cursor[1] == 'n') {
+            glm::vec3 n;
+            n.x = std::strtof(cursor + 2, &next);
+            n.y = std::strtof(next, &next);
+            n.z = std::strtof(next, &next);
+            normals.push_back(n);
+        } else if ((cursor[0] == 'o' || cursor[0] == 'g') && (cursor[1] == ' ' || cursor[1] == '\0' || cursor[1] == '\r')) {
+            builder.flush(meshes);
+        } else if (cursor[0] == 'f' && cursor[1] == ' ') {
+            face.clear();
+            const char* token = cursor + 2;
+            while (true) {
+                while (*token == ' ' || *token == '\t') token++;
+                if (*token == '\0' || *token == '\r') break;
+
+                // v, v/vt, v//vn or v/vt/vn
+                CornerKey corner = { -1, -1, -1 };
+                long value = std::strtol(token, &next, 10);
+                if (next == token || !resolveIndex(value, positions.size(), corner.position)) {
+                    error = "invalid face on line " + std::to_string(lineNumber);
+                    return false;
+                }
+                token = next;
+                if (*token == '/') {
+                    token++;
+                    if (*token != '/') {
+                        value = std::strtol(token, &next, 10);
+                        if (next == token || !resolveIndex(value, texCoords.size(), corner.texCoord)) {
+                            error = "invalid texture coordinate on line " + std::to_string(lineNumber);
+                            return false;
+                        }
+                        token = next;
+                    }
+                    if (*token == '/') {
+                        token++;
+                        value = std::strtol(token, &next, 10);
+                        if (next == token || !resolveIndex(value, normals.size(), corner.normal)) {
+                            error = "invalid normal on line " + std::to_string(lineNumber);
+                            return false;
+                        }
+                        token = next;
+                    }
+                }
+                face.push_back(corner);
+            }
+            if (face.size() < 3) {
+                error = "face with fewer than 3 corners on line " + std::to_string(lineNumber);
+                return false;
+            }
+
+            unsigned int faceIndices[3];
+            for (size_t i = 2; i < face.size(); i++) {
+                const CornerKey fan[3] = { face[0], face[i - 1], face[i] };
+                for (int k = 0; k < 3; k++) {
+                    auto found = builder.corners.find(fan[k]);
+                    if (found == builder.corners.end()) {
+                        Vertex vertex;
+                        vertex.position = positions[fan[k].position];
+                        vertex.texCoords = fan[k].texCoord >= 0 ? texCoords[fan[k].texCoord] : glm::vec2(0.0f);
+                        vertex.normal = fan[k].normal >= 0 ? normals[fan[k].normal] : glm::vec3(0.0f);
+                        unsigned int index = static_cast<unsigned int>(builder.vertices.size());
+                        builder.vertices.push_back(vertex);
+                        builder.hasNormal.push_back(fan[k].normal >= 0);
+                        found = builder.corners.emplace(fan[k], index).first;
+                    }
+                    faceIndices[k] = found->second;
+                }
+                builder.indices.insert(builder.indices.end(), faceIndices, faceIndices + 3);
+            }
+        }
+        // Anything else (mtllib, usemtl, s, l, p) is ignored
+    }
+
+    builder.flush(meshes);
+    if (meshes.empty()) {
+        error = "no faces";
+        return false;
+    }
+    return true;
+}
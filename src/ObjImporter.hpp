@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Mesh.hpp"
+
+// Wavefront OBJ reader for the asset cooker. Positions, texture coordinates and
+// normals are supported; polygons are fanned into triangles, every object or
+// group ("o"/"g") becomes one mesh, and materials are ignored. Vertices that
+// share a position/uv/normal triple are merged; missing normals are generated.
+class ObjImporter {
+public:
+    static bool import(const std::string& path, std::vector<Mesh>& meshes);
+    static bool parse(const char* data, size_t size, std::vector<Mesh>& meshes, std::string& error);
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include "MemoryTracker.hpp"
+
+// Reference to an object in an ObjectPool. A slot's generation changes every time
+// its object is destroyed, so a handle kept past destroy() or reset() resolves to
+// nullptr instead of to whatever reuses the slot. Default-constructed handles are null.
+template <typename T>
+struct PoolHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const PoolHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PoolHandle& other) const { return !(*this == other); }
+};
+
+// Fixed-capacity pool of T in one contiguous block. create() and destroy() are
+// O(1) through a free list; reset() destroys every live object at once (the end
+// of a match) and invalidates all outstanding handles. Not thread-safe.
+template <typename T>
+class ObjectPool {
+public:
+    using Handle = PoolHandle<T>;
+
+    // The block, and whatever the objects allocate while they are constructed,
+    // is charged to tag in the MemoryTracker
+    explicit ObjectPool(size_t capacity, MemoryTag tag = MemoryTracker::getCurrentTag())
+        : m_capacity(capacity)
+        , m_size(0)
+        , m_freeHead(0)
+        , m_tag(tag)
+    {
+        MemoryTracker::Scope memoryScope(tag);
+        m_slots.reset(new Slot[capacity]);
+        for (size_t i = 0; i < capacity; i++) {
+            m_slots[i].generation = 1;
+            m_slots[i].alive = false;
+        }
+        linkFreeList();
+    }
+
+    ~ObjectPool() { reset(); }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Null handle when the pool is full
+    template <typename... Args>
+    Handle create(Args&&... args) {
+        if (m_freeHead == NONE) return Handle();
+        uint32_t index = m_freeHead;
+        Slot& slot = m_slots[index];
+        m_freeHead = slot.nextFree;
+        MemoryTracker::Scope memoryScope(m_tag);
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.alive = true;
+        m_size++;
+
+        Handle handle;
+        handle.index = index;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    // Stale and null handles are ignored
+    void destroy(Handle handle) {
+        if (!isAlive(handle)) return;
+        Slot& slot = m_slots[handle.index];
+        release(slot);
+        slot.nextFree = m_freeHead;
+        m_freeHead = handle.index;
+    }
+
+    // nullptr for stale or null handles
+    T* get(Handle handle) { return isAlive(handle) ? object(m_slots[handle.index]) : nullptr; }
+    const T* get(Handle handle) const { return isAlive(handle) ? object(m_slots[handle.index]) : nullptr; }
+
+    bool isAlive(Handle handle) const {
+        return handle.index < m_capacity && m_slots[handle.index].alive &&
+               m_slots[handle.index].generation == handle.generation;
+    }
+
+    // Destroys every live object; the walk stops at the last one
+    void reset() {
+        if (!m_slots) return;
+        for (size_t i = 0; i < m_capacity && m_size > 0; i++) {
+            if (m_slots[i].alive) release(m_slots[i]);
+        }
+        linkFreeList();
+    }
+
+    size_t getSize() const { return m_size; }
+    size_t getCapacity() const { return m_capacity; }
+
+private:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation;    // Never 0, so null handles never match
+        uint32_t nextFree;
+        bool alive;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_capacity;
+    size_t m_size;
+    uint32_t m_freeHead;
+    MemoryTag m_tag;
+
+    static T* object(Slot& slot) { return std::launder(reinterpret_cast<T*>(slot.storage)); }
+    static const T* object(const Slot& slot) { return std::launder(reinterpret_cast<const T*>(slot.storage)); }
+
+    void release(Slot& slot) {
+        object(slot)->~T();
+        slot.alive = false;
+        slot.generation = slot.generation == 0xFFFFFFFFu ? 1 : slot.generation + 1;
+        m_size--;
+    }
+
+    // Lowest index first, so a fresh pool fills front to back
+    void linkFreeList() {
+        for (size_t i = 0; i < m_capacity; i++) {
+            m_slots[i].nextFree = i + 1 < m_capacity ? static_cast<uint32_t>(i + 1) : NONE;
+        }
+        m_freeHead = m_capacity > 0 ? 0 : NONE;
+    }
+};
@@ -0,0 +1,194 @@
+#include "OverlayRenderer.hpp"
+#include <GL/glew.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+// 16-bit indices: 4 vertices per quad
+static const int MAX_QUADS_LIMIT = 16384;
+
+OverlayRenderer::OverlayRenderer()
+    : m_shader(0)
+    , m_VAO(0)
+    , m_maxQuads(0)
+    , m_width(0)
+    , m_height(0)
+{
+}
+
+OverlayRenderer::~OverlayRenderer() {
+    if (m_VAO) {
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    if (m_shader) {
+        glDeleteProgram(m_shader);
+    }
+}
+
+bool OverlayRenderer::initialize(unsigned int shader, int maxQuads) {
+    m_shader = shader;
+    m_maxQuads = std::min(std::max(maxQuads, 1), MAX_QUADS_LIMIT);
+
+    m_atlas.build();
+    if (!m_atlas.upload()) {
+        std::cerr << "Failed to create glyph atlas" << std::endl;
+        return false;
+    }
+
+    // Shared quad index pattern
+    std::vector<unsigned short> indices(static_cast<size_t>(m_maxQuads) * 6);
+    for (int q = 0; q < m_maxQuads; q++) {
+        unsigned short base = static_cast<unsigned short>(q * 4);
+        unsigned short* quad = &indices[static_cast<size_t>(q) * 6];
+        quad[0] = base; quad[1] = base + 1; quad[2] = base + 2;
+        quad[3] = base; quad[4] = base + 2; quad[5] = base + 3;
+    }
+
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+
+    m_vertexBuffer.reset(new VertexBuffer(GL_ARRAY_BUFFER));
+    m_vertexBuffer->setData(nullptr, m_maxQuads * 4 * sizeof(OverlayVertex), GL_STREAM_DRAW);
+    m_indexBuffer.reset(new VertexBuffer(GL_ELEMENT_ARRAY_BUFFER));
+    m_indexBuffer->setData(indices.data(), indices.size() * sizeof(unsigned short));
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex), (void*)offsetof(OverlayVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex), (void*)offsetof(OverlayVertex, texCoords));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OverlayVertex), (void*)offsetof(OverlayVertex, color));
+
+    glBindVertexArray(0);
+
+    m_vertices.reserve(static_cast<size_t>(m_maxQuads) * 4);
+    return true;
+}
+
+void OverlayRenderer::begin(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_vertices.clear();
+}
+
+unsigned int OverlayRenderer::packColor(const glm::vec4& color) {
+    glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return static_cast<unsigned int>(c.r) | (static_cast<unsigned int>(c.g) << 8) |
+           (static_cast<unsigned int>(c.b) << 16) | (static_cast<unsigned int>(c.a) << 24);
+}
+
+void OverlayRenderer::pushQuad(const glm::vec4& rect, const glm::vec4& texRect, unsigned int color) {
+    // Full batch: drop the quad rather than grow the buffer
+    if (static_cast<int>(m_vertices.size()) >= m_maxQuads * 4) return;
+
+    m_vertices.push_back({ glm::vec2(rect.x, rect.y), glm::vec2(texRect.x, texRect.y), color });
+    m_vertices.push_back({ glm::vec2(rect.z, rect.y), glm::vec2(texRect.z, texRect.y), color });
+    m_vertices.push_back({ glm::vec2(rect.z, rect.w), glm::vec2(texRect.z, texRect.w), color });
+    m_vertices.push_back({ glm::vec2(rect.x, rect.w), glm::vec2(texRect.x, texRect.w), color });
+}
+
+void OverlayRenderer::drawRect(float x, float y, float width, float height, const glm::vec4& color) {
+    glm::vec2 uv = m_atlas.getSolidTexCoord();
+    pushQuad(glm::vec4(x, y, x + width, y + height), glm::vec4(uv, uv), packColor(color));
+}
+
+void OverlayRenderer::drawText(const char* text, float x, float y, float size, const glm::vec4& color) {
+    const float scale = size / GlyphAtlas::CAP_HEIGHT;
+    const float padding = GlyphAtlas::PADDING * scale;
+    const float cellWidth = GlyphAtlas::CELL_WIDTH * scale;
+    const float cellHeight = GlyphAtlas::CELL_HEIGHT * scale;
+    const unsigned int packed = packColor(color);
+
+    float penX = x;
+    for (const char* c = text; *c; c++) {
+        if (*c != ' ') {
+            glm::vec4 rect(penX - padding, y - padding, penX - padding + cellWidth, y - padding + cellHeight);
+            pushQuad(rect, m_atlas.getGlyphRect(*c), packed);
+        }
+        penX += GlyphAtlas::ADVANCE * scale;
+    }
+}
+
+float OverlayRenderer::measureText(const char* text, float size) const {
+    size_t length = 0;
+    while (text[length]) length++;
+    if (length == 0) return 0.0f;
+
+    // Last glyph has no trailing spacing
+    const float scale = size / GlyphAtlas::CAP_HEIGHT;
+    return (length * GlyphAtlas::ADVANCE - (GlyphAtlas::ADVANCE - 5 * GlyphAtlas::PIXELS_PER_DOT)) * scale;
+}
+
+OverlayRenderer::TextHandle OverlayRenderer::cacheText(const char* text, float size) {
+    const float scale = size / GlyphAtlas::CAP_HEIGHT;
+    const float padding = GlyphAtlas::PADDING * scale;
+    const float cellWidth = GlyphAtlas::CELL_WIDTH * scale;
+    const float cellHeight = GlyphAtlas::CELL_HEIGHT * scale;
+
+    CachedText cached;
+    cached.firstGlyph = static_cast<int>(m_cachedGlyphs.size());
+    cached.width = measureText(text, size);
+
+    float penX = 0.0f;
+    for (const char* c = text; *c; c++) {
+        if (*c != ' ') {
+            glm::vec4 rect(penX - padding, -padding, penX - padding + cellWidth, cellHeight - padding);
+            m_cachedGlyphs.push_back({ rect, m_atlas.getGlyphRect(*c) });
+        }
+        penX += GlyphAtlas::ADVANCE * scale;
+    }
+
+    cached.glyphCount = static_cast<int>(m_cachedGlyphs.size()) - cached.firstGlyph;
+    m_cachedTexts.push_back(cached);
+    return static_cast<TextHandle>(m_cachedTexts.size() - 1);
+}
+
+void OverlayRenderer::drawText(TextHandle text, float x, float y, const glm::vec4& color, float scale) {
+    if (text < 0 || text >= static_cast<TextHandle>(m_cachedTexts.size())) return;
+
+    const CachedText& cached = m_cachedTexts[text];
+    const unsigned int packed = packColor(color);
+    const glm::vec4 offset(x, y, x, y);
+    for (int i = 0; i < cached.glyphCount; i++) {
+        const CachedGlyph& glyph = m_cachedGlyphs[cached.firstGlyph + i];
+        pushQuad(glyph.rect * scale + offset, glyph.texRect, packed);
+    }
+}
+
+float OverlayRenderer::getTextWidth(TextHandle text) const {
+    if (text < 0 || text >= static_cast<TextHandle>(m_cachedTexts.size())) return 0.0f;
+    return m_cachedTexts[text].width;
+}
+
+void OverlayRenderer::render() {
+    if (m_vertices.empty() || !m_VAO || m_width <= 0 || m_height <= 0) return;
+
+    // Orphan last frame's storage, then stream this frame's quads
+    m_vertexBuffer->setData(nullptr, m_maxQuads * 4 * sizeof(OverlayVertex), GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(OverlayVertex), m_vertices.data());
+    m_vertexBuffer->unbind();
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Pixel coordinates, y down
+    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(m_width), static_cast<float>(m_height), 0.0f);
+    glUseProgram(m_shader);
+    glUniformMatrix4fv(glGetUniformLocation(m_shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform1i(glGetUniformLocation(m_shader, "glyphAtlas"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_atlas.getTexture());
+
+    glBindVertexArray(m_VAO);
+    glDrawElements(GL_TRIANGLES, getQuadCount() * 6, GL_UNSIGNED_SHORT, 0);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "GlyphAtlas.hpp"
+#include "VertexBuffer.hpp"
+
+// Batched 2D overlay in screen pixels (origin top-left).
+// Rectangles and SDF text are appended to one CPU-side vertex array between
+// begin() and render(); render() streams it into a single vertex buffer and
+// issues one draw call. Storage is sized once, so a frame never allocates.
+class OverlayRenderer {
+public:
+    typedef int TextHandle;
+    static const TextHandle INVALID_TEXT = -1;
+
+    OverlayRenderer();
+    ~OverlayRenderer();
+
+    // Takes ownership of the shader program
+    bool initialize(unsigned int shader, int maxQuads = 4096);
+
+    // Start a new batch for a target of the given size
+    void begin(int width, int height);
+
+    void drawRect(float x, float y, float width, float height, const glm::vec4& color);
+
+    // Text with (x, y) at the top-left of the first character; `size` is the cap height in pixels
+    void drawText(const char* text, float x, float y, float size, const glm::vec4& color);
+    float measureText(const char* text, float size) const;
+
+    // Static strings: laid out once, then drawn by copying the cached quads.
+    // `scale` multiplies the size the text was cached at.
+    TextHandle cacheText(const char* text, float size);
+    void drawText(TextHandle text, float x, float y, const glm::vec4& color, float scale = 1.0f);
+    float getTextWidth(TextHandle text) const;
+
+    // Upload the batch and draw it into the bound target
+    void render();
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getQuadCount() const { return static_cast<int>(m_vertices.size() / 4); }
+
+private:
+    struct OverlayVertex {
+        glm::vec2 position;
+        glm::vec2 texCoords;
+        unsigned int color;     // RGBA8
+    };
+
+    // Quad relative to the text origin, in pixels
+    struct CachedGlyph {
+        glm::vec4 rect;
+        glm::vec4 texRect;
+    };
+
+    struct CachedText {
+        int firstGlyph;
+        int glyphCount;
+        float width;
+    };
+
+    GlyphAtlas m_atlas;
+    unsigned int m_shader;
+    unsigned int m_VAO;
+    std::unique_ptr<VertexBuffer> m_vertexBuffer;
+    std::unique_ptr<VertexBuffer> m_indexBuffer;
+    int m_maxQuads;
+
+    std::vector<OverlayVertex> m_vertices;
+    std::vector<CachedGlyph> m_cachedGlyphs;
+    std::vector<CachedText> m_cachedTexts;
+    int m_width;
+    int m_height;
+
+    void pushQuad(const glm::vec4& rect, const glm::vec4& texRect, unsigned int color);
+    static unsigned int packColor(const glm::vec4& color);
+};
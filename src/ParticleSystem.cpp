@@ -0,0 +1,303 @@
+#include "ParticleSystem.hpp"
+#include "Random.hpp"
+#include "ThreadPool.hpp"
+#include <GL/glew.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_SSE
+#endif
+
+namespace {
+
+const float PI = 3.14159265f;
+
+// Integrate one emitter's particles. `count` is padded to a multiple of 8.
+void integrate(float* px, float* py, float* pz,
+               float* vx, float* vy, float* vz,
+               float* life, const float* inverseLifetime, float* fade,
+               int count, float deltaTime, float gravity, float damping) {
+    const float gravityStep = gravity * deltaTime;
+
+#if defined(__AVX__)
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 g = _mm256_set1_ps(gravityStep);
+    const __m256 damp = _mm256_set1_ps(damping);
+    const __m256 zero = _mm256_setzero_ps();
+    for (int i = 0; i < count; i += 8) {
+        __m256 velX = _mm256_mul_ps(_mm256_loadu_ps(vx + i), damp);
+        __m256 velY = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(vy + i), g), damp);
+        __m256 velZ = _mm256_mul_ps(_mm256_loadu_ps(vz + i), damp);
+        _mm256_storeu_ps(vx + i, velX);
+        _mm256_storeu_ps(vy + i, velY);
+        _mm256_storeu_ps(vz + i, velZ);
+        _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(velX, dt)));
+        _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(velY, dt)));
+        _mm256_storeu_ps(pz + i, _mm256_add_ps(_mm256_loadu_ps(pz + i), _mm256_mul_ps(velZ, dt)));
+        __m256 remaining = _mm256_sub_ps(_mm256_loadu_ps(life + i), dt);
+        _mm256_storeu_ps(life + i, remaining);
+        _mm256_storeu_ps(fade + i, _mm256_max_ps(_mm256_mul_ps(remaining, _mm256_loadu_ps(inverseLifetime + i)), zero));
+    }
+#elif defined(PARTICLES_SSE)
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 g = _mm_set1_ps(gravityStep);
+    const __m128 damp = _mm_set1_ps(damping);
+    const __m128 zero = _mm_setzero_ps();
+    for (int i = 0; i < count; i += 4) {
+        __m128 velX = _mm_mul_ps(_mm_loadu_ps(vx + i), damp);
+        __m128 velY = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), g), damp);
+        __m128 velZ = _mm_mul_ps(_mm_loadu_ps(vz + i), damp);
+        _mm_storeu_ps(vx + i, velX);
+        _mm_storeu_ps(vy + i, velY);
+        _mm_storeu_ps(vz + i, velZ);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, dt)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, dt)));
+        _mm_storeu_ps(pz + i, _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(velZ, dt)));
+        __m128 remaining = _mm_sub_ps(_mm_loadu_ps(life + i), dt);
+        _mm_storeu_ps(life + i, remaining);
+        _mm_storeu_ps(fade + i, _mm_max_ps(_mm_mul_ps(remaining, _mm_loadu_ps(inverseLifetime + i)), zero));
+    }
+#else
+    // Plain loop; compilers auto-vectorize this on NEON targets
+    for (int i = 0; i < count; i++) {
+        vx[i] *= damping;
+        vy[i] = (vy[i] + gravityStep) * damping;
+        vz[i] *= damping;
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        pz[i] += vz[i] * deltaTime;
+        life[i] -= deltaTime;
+        fade[i] = std::max(life[i] * inverseLifetime[i], 0.0f);
+    }
+#endif
+}
+
+int paddedCount(int count) {
+    return (count + 7) & ~7;
+}
+
+unsigned int packColor(float r, float g, float b, float a) {
+    auto channel = [](float v) { return static_cast<unsigned int>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f); };
+    return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+}
+
+} // namespace
+
+const ParticleEffect& ParticleEffect::muzzleFlash() {
+    static const ParticleEffect effect = { 3, 0.2f, 0.6f, 0.3f, 0.04f, 0.07f, 0.12f, glm::vec4(1.0f, 0.8f, 0.4f, 1.0f) };
+    return effect;
+}
+
+const ParticleEffect& ParticleEffect::muzzleSparks() {
+    static const ParticleEffect effect = { 8, 3.0f, 7.0f, 0.25f, 0.08f, 0.2f, 0.015f, glm::vec4(1.0f, 0.7f, 0.3f, 1.0f) };
+    return effect;
+}
+
+const ParticleEffect& ParticleEffect::impactSparks() {
+    static const ParticleEffect effect = { 10, 2.0f, 5.0f, 1.0f, 0.15f, 0.35f, 0.012f, glm::vec4(1.0f, 0.85f, 0.5f, 1.0f) };
+    return effect;
+}
+
+const ParticleEffect& ParticleEffect::impactDust() {
+    static const ParticleEffect effect = { 6, 0.3f, 1.0f, 0.8f, 0.4f, 0.8f, 0.08f, glm::vec4(0.6f, 0.58f, 0.55f, 0.5f) };
+    return effect;
+}
+
+ParticleSystem::ParticleSystem()
+    : m_totalCapacity(0)
+    , m_instanceCount(0)
+    , m_shader(0)
+    , m_VAO(0)
+    , m_bufferCapacity(0)
+{
+}
+
+ParticleSystem::~ParticleSystem() {
+    if (m_VAO) {
+        glDeleteVertexArrays(1, &m_VAO);
+    }
+    if (m_shader) {
+        glDeleteProgram(m_shader);
+    }
+}
+
+bool ParticleSystem::initialize(unsigned int shader) {
+    m_shader = shader;
+
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+
+    // Per-instance attributes only; the quad corner comes from gl_VertexID
+    m_instanceBuffer.reset(new VertexBuffer(GL_ARRAY_BUFFER));
+    m_instanceBuffer->bind();
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, positionSize));
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, color));
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    m_instanceBuffer->unbind();
+    return true;
+}
+
+int ParticleSystem::createEmitter(const EmitterSettings& settings) {
+    std::unique_ptr<Emitter> emitter(new Emitter());
+    emitter->settings = settings;
+    emitter->capacity = std::max(settings.capacity, 1);
+    emitter->count = 0;
+    emitter->instanceOffset = 0;
+    emitter->random = 0x9E3779B9u * static_cast<unsigned int>(m_emitters.size() + 1);
+
+    const size_t padded = static_cast<size_t>(paddedCount(emitter->capacity));
+    for (std::vector<float>* array : { &emitter->positionX, &emitter->positionY, &emitter->positionZ,
+                                       &emitter->velocityX, &emitter->velocityY, &emitter->velocityZ,
+                                       &emitter->life, &emitter->inverseLifetime, &emitter->fade,
+                                       &emitter->size, &emitter->red, &emitter->green, &emitter->blue,
+                                       &emitter->opacity }) {
+        array->assign(padded, 0.0f);
+    }
+
+    m_totalCapacity += emitter->capacity;
+    m_instances.resize(m_totalCapacity);
+    m_emitters.push_back(std::move(emitter));
+    return static_cast<int>(m_emitters.size()) - 1;
+}
+
+void ParticleSystem::emit(int emitterIndex, const ParticleEffect& effect,
+                          const glm::vec3& position, const glm::vec3& direction) {
+    if (emitterIndex < 0 || emitterIndex >= static_cast<int>(m_emitters.size())) return;
+    Emitter& emitter = *m_emitters[emitterIndex];
+
+    // Basis around the emission direction
+    glm::vec3 forward = glm::length(direction) > 0.0f ? glm::normalize(direction) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 helper = std::fabs(forward.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    glm::vec3 tangent = glm::normalize(glm::cross(helper, forward));
+    glm::vec3 bitangent = glm::cross(forward, tangent);
+    const float sizeSign = emitter.settings.additive ? 1.0f : -1.0f;
+
+    for (int n = 0; n < effect.count && emitter.count < emitter.capacity; n++) {
+        unsigned int& rng = emitter.random;
+
+        // Uniform direction inside the cone
+        float cosAngle = 1.0f - random01(rng) * (1.0f - std::cos(effect.spread));
+        float sinAngle = std::sqrt(std::max(0.0f, 1.0f - cosAngle * cosAngle));
+        float phi = random01(rng) * 2.0f * PI;
+        glm::vec3 dir = forward * cosAngle + (tangent * std::cos(phi) + bitangent * std::sin(phi)) * sinAngle;
+        glm::vec3 velocity = dir * (effect.speedMin + (effect.speedMax - effect.speedMin) * random01(rng));
+        float lifetime = effect.lifeMin + (effect.lifeMax - effect.lifeMin) * random01(rng);
+
+        int i = emitter.count++;
+        emitter.positionX[i] = position.x;
+        emitter.positionY[i] = position.y;
+        emitter.positionZ[i] = position.z;
+        emitter.velocityX[i] = velocity.x;
+        emitter.velocityY[i] = velocity.y;
+        emitter.velocityZ[i] = velocity.z;
+        emitter.life[i] = lifetime;
+        emitter.inverseLifetime[i] = 1.0f / std::max(lifetime, 1e-4f);
+        emitter.fade[i] = 1.0f;
+        emitter.size[i] = effect.size * (0.75f + 0.5f * random01(rng)) * sizeSign;
+        emitter.red[i] = effect.color.r;
+        emitter.green[i] = effect.color.g;
+        emitter.blue[i] = effect.color.b;
+        emitter.opacity[i] = effect.color.a;
+    }
+}
+
+void ParticleSystem::updateEmitter(Emitter& emitter, float deltaTime) {
+    if (emitter.count == 0) return;
+
+    // Padding lanes are integrated too; they are never read back
+    float damping = std::max(0.0f, 1.0f - emitter.settings.drag * deltaTime);
+    integrate(emitter.positionX.data(), emitter.positionY.data(), emitter.positionZ.data(),
+              emitter.velocityX.data(), emitter.velocityY.data(), emitter.velocityZ.data(),
+              emitter.life.data(), emitter.inverseLifetime.data(), emitter.fade.data(),
+              paddedCount(emitter.count), deltaTime, emitter.settings.gravity, damping);
+
+    // Remove dead particles by moving the last live one into their slot
+    int i = 0;
+    while (i < emitter.count) {
+        if (emitter.life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --emitter.count;
+        for (std::vector<float>* array : { &emitter.positionX, &emitter.positionY, &emitter.positionZ,
+                                           &emitter.velocityX, &emitter.velocityY, &emitter.velocityZ,
+                                           &emitter.life, &emitter.inverseLifetime, &emitter.fade,
+                                           &emitter.size, &emitter.red, &emitter.green, &emitter.blue,
+                                           &emitter.opacity }) {
+            (*array)[i] = (*array)[last];
+        }
+    }
+}
+
+void ParticleSystem::gatherEmitter(const Emitter& emitter) {
+    ParticleInstance* out = &m_instances[emitter.instanceOffset];
+    for (int i = 0; i < emitter.count; i++) {
+        out[i].positionSize = glm::vec4(emitter.positionX[i], emitter.positionY[i], emitter.positionZ[i], emitter.size[i]);
+        out[i].color = packColor(emitter.red[i], emitter.green[i], emitter.blue[i], emitter.opacity[i] * emitter.fade[i]);
+    }
+}
+
+void ParticleSystem::update(float deltaTime, ThreadPool* pool) {
+    const int emitterCount = static_cast<int>(m_emitters.size());
+    if (deltaTime > 0.0f) {
+        if (pool) {
+            pool->parallelFor(emitterCount, [this, deltaTime](int i) { updateEmitter(*m_emitters[i], deltaTime); });
+        } else {
+            for (auto& emitter : m_emitters) updateEmitter(*emitter, deltaTime);
+        }
+    }
+
+    // Each emitter owns a contiguous range of the instance array
+    m_instanceCount = 0;
+    for (auto& emitter : m_emitters) {
+        emitter->instanceOffset = m_instanceCount;
+        m_instanceCount += emitter->count;
+    }
+
+    if (pool) {
+        pool->parallelFor(emitterCount, [this](int i) { gatherEmitter(*m_emitters[i]); });
+    } else {
+        for (const auto& emitter : m_emitters) gatherEmitter(*emitter);
+    }
+}
+
+void ParticleSystem::render(const glm::mat4& view, const glm::mat4& projection) {
+    if (m_instanceCount == 0 || !m_VAO) return;
+
+    // Orphan and refill; the buffer only grows when emitters are added
+    if (m_bufferCapacity < m_totalCapacity) {
+        m_bufferCapacity = m_totalCapacity;
+    }
+    m_instanceBuffer->setData(nullptr, m_bufferCapacity * sizeof(ParticleInstance), GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_instanceCount * sizeof(ParticleInstance), m_instances.data());
+    m_instanceBuffer->unbind();
+
+    // Premultiplied output: additive particles write alpha 0
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+
+    glUseProgram(m_shader);
+    glUniformMatrix4fv(glGetUniformLocation(m_shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(glGetUniformLocation(m_shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+
+    glBindVertexArray(m_VAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_instanceCount);
+    glBindVertexArray(0);
+
+    glEnable(GL_CULL_FACE);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
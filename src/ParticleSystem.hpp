@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "VertexBuffer.hpp"
+
+class ThreadPool;
+
+// Burst spawned by ParticleSystem::emit
+struct ParticleEffect {
+    int count;
+    float speedMin;
+    float speedMax;
+    float spread;           // Cone half-angle around the direction, radians
+    float lifeMin;
+    float lifeMax;
+    float size;             // Billboard half-size, world units
+    glm::vec4 color;        // Alpha fades to 0 over the lifetime
+
+    static const ParticleEffect& muzzleFlash();
+    static const ParticleEffect& muzzleSparks();
+    static const ParticleEffect& impactSparks();
+    static const ParticleEffect& impactDust();
+};
+
+// CPU particles in structure-of-arrays pools, one pool per emitter.
+// update() integrates every emitter with SIMD kernels (AVX when compiled with
+// it, SSE on x86-64, scalar otherwise), spreading emitters across the thread
+// pool, then gathers the live particles into one instance array. render() draws
+// them as camera-facing billboards from a single streaming buffer in one draw
+// (premultiplied blending covers additive and alpha-blended emitters alike).
+// All storage is sized by createEmitter(); emitting into a full pool drops particles.
+class ParticleSystem {
+public:
+    struct EmitterSettings {
+        int capacity = 1024;
+        float gravity = -9.81f;
+        float drag = 2.0f;          // Velocity damping per second
+        bool additive = true;
+    };
+
+    ParticleSystem();
+    ~ParticleSystem();
+
+    // Takes ownership of the billboard shader program
+    bool initialize(unsigned int shader);
+
+    int createEmitter(const EmitterSettings& settings);
+
+    void emit(int emitter, const ParticleEffect& effect, const glm::vec3& position, const glm::vec3& direction);
+
+    void update(float deltaTime, ThreadPool* pool = nullptr);
+
+    void render(const glm::mat4& view, const glm::mat4& projection);
+
+    int getLiveCount() const { return m_instanceCount; }
+    int getCapacity() const { return m_totalCapacity; }
+
+private:
+    // Arrays are padded to a multiple of 8 so the kernels never need a scalar tail
+    struct Emitter {
+        EmitterSettings settings;
+        int capacity;
+        int count;
+        int instanceOffset;
+        unsigned int random;
+
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> velocityX, velocityY, velocityZ;
+        std::vector<float> life, inverseLifetime, fade;
+        std::vector<float> size;
+        std::vector<float> red, green, blue, opacity;
+    };
+
+    struct ParticleInstance {
+        glm::vec4 positionSize;     // xyz + half-size, negative size = alpha blended
+        unsigned int color;         // RGBA8
+    };
+
+    std::vector<std::unique_ptr<Emitter>> m_emitters;
+    std::vector<ParticleInstance> m_instances;
+    int m_totalCapacity;
+    int m_instanceCount;
+
+    unsigned int m_shader;
+    unsigned int m_VAO;
+    std::unique_ptr<VertexBuffer> m_instanceBuffer;
+    int m_bufferCapacity;
+
+    void updateEmitter(Emitter& emitter, float deltaTime);
+    void gatherEmitter(const Emitter& emitter);
+};
@@ -1,6 +1,29 @@
 #include "Player.hpp"
+#include "BvhRaycaster.hpp"
+#include "ParticleSystem.hpp"
+#include "DecalSystem.hpp"
+#include "Level.hpp"
+#include "MemoryTracker.hpp"
+#include "Random.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
+namespace {
+
+const float WEAPON_RANGE = 100.0f;
+const float SPREAD_ANGLE = 0.25f;       // Cone half-angle in radians at spread 1
+const float SURFACE_TOLERANCE = 0.01f;  // Decal surfaces within this of a hit are the thing hit
+
+CharacterController::Settings controllerSettings(float radius, float height) {
+    CharacterController::Settings settings;
+    settings.radius = radius;
+    settings.height = height;
+    return settings;
+}
+
+} // namespace
+
 Player::Player(const glm::vec3& spawnPosition)
     : m_position(spawnPosition)
     , m_camera(spawnPosition + glm::vec3(0.0f, 1.7f, 0.0f))
@@ -11,36 +34,58 @@ Player::Player(const glm::vec3& spawnPosition)
     , m_isJumping(false)
     , m_velocity(0.0f)
     , m_currentWeaponIndex(0)
+    , m_spreadRandom(0x9E3779B9u)
+    , m_particles(nullptr)
+    , m_decals(nullptr)
+    , m_level(nullptr)
+    , m_muzzleEmitter(-1)
+    , m_impactEmitter(-1)
     , m_height(1.8f)
     , m_radius(0.3f)
+    , m_controller(controllerSettings(m_radius, m_height))
 {
+    MemoryTracker::Scope memoryScope(MemoryTag::Player);
     // Initialize weapons (we'll create specific weapon types later)
-    m_weapons[0] = new Weapon("Pistol", 30.0f, 15, 7);     // Basic pistol
-    m_weapons[1] = new Weapon("Shotgun", 80.0f, 30, 2);    // Powerful but limited
-    m_weapons[2] = new Weapon("SMG", 15.0f, 10, 30);       // Fast firing
-
-    m_currentWeapon = m_weapons[0];
+    ObjectPool<Weapon>& weapons = Weapon::getPool();
+    m_weapons[0] = weapons.create("Pistol", 30.0f, 15, 7);     // Basic pistol
+    m_weapons[1] = weapons.create("Shotgun", 80.0f, 30, 2);    // Powerful but limited
+    m_weapons[2] = weapons.create("SMG", 15.0f, 10, 30);       // Fast firing
+    for (const Weapon::Handle& handle : m_weapons) {
+        if (handle.isNull()) {
+            std::cerr << "Player: weapon pool full (" << weapons.getCapacity() << " weapons)" << std::endl;
+            break;
+        }
+    }
 }
 
 Player::~Player() {
+    // No-ops if the match already reset the pool
     for (int i = 0; i < 3; i++) {
-        delete m_weapons[i];
+        Weapon::getPool().destroy(m_weapons[i]);
     }
 }
 
+const Weapon* Player::getCurrentWeapon() const {
+    return Weapon::getPool().get(m_weapons[m_currentWeaponIndex]);
+}
+
 void Player::update(float deltaTime) {
-    // Apply gravity if jumping/falling
-    if (m_isJumping || m_position.y > 0.0f) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Player);
+    // Airborne: fall under gravity until there is ground underfoot
+    if (m_isJumping || !isOnGround()) {
         applyGravity(deltaTime);
-    }
-
-    // Update position based on velocity
-    if (m_isJumping) {
-        m_position += m_velocity * deltaTime;
+        if (m_level) {
+            m_position = m_controller.move(*m_level, m_position, m_velocity * deltaTime);
+            if (m_controller.hitCeiling() && m_velocity.y > 0.0f) {
+                m_velocity.y = 0.0f;
+            }
+        } else {
+            m_position += m_velocity * deltaTime;
+            m_position.y = std::max(m_position.y, 0.0f);
+        }
 
         // Check if landed
-        if (m_position.y <= 0.0f) {
-            m_position.y = 0.0f;
+        if (isOnGround() && m_velocity.y <= 0.0f) {
             m_isJumping = false;
             m_velocity.y = 0.0f;
         }
@@ -80,15 +125,17 @@ void Player::move(char direction, float deltaTime) {
             newPosition += right * velocity;
             break;
         case ' ': // Space - jump
-            if (!m_isJumping && m_position.y <= 0.0f) {
+            if (!m_isJumping && isOnGround()) {
                 m_isJumping = true;
                 m_velocity.y = m_jumpForce;
             }
             break;
     }
 
-    // Check collision before updating position
-    if (!checkCollision(newPosition)) {
+    // Sweep the capsule along the move, sliding along walls and up steps
+    if (m_level) {
+        m_position = m_controller.move(*m_level, m_position, newPosition - m_position);
+    } else {
         m_position = newPosition;
     }
 }
@@ -97,28 +144,81 @@ void Player::look(float xoffset, float yoffset) {
     m_camera.processMouseMovement(xoffset, yoffset);
 }
 
+void Player::setParticleSystem(ParticleSystem* particles) {
+    m_particles = particles;
+    m_muzzleEmitter = particles ? particles->createEmitter(ParticleSystem::EmitterSettings()) : -1;
+    m_impactEmitter = particles ? particles->createEmitter(ParticleSystem::EmitterSettings()) : -1;
+}
+
 void Player::shoot() {
-    if (m_currentWeapon && m_currentWeapon->canShoot()) {
-        m_currentWeapon->shoot();
+    Weapon* weapon = Weapon::getPool().get(m_weapons[m_currentWeaponIndex]);
+    if (weapon && weapon->canShoot()) {
+        weapon->shoot();
 
-        // Ray casting for bullet hit detection would go here
-        // For now, we'll just log the action
-        std::cout << "Shot fired with " << m_currentWeapon->getName() << std::endl;
+        // Muzzle flash slightly right of and below the eye
+        if (m_particles) {
+            glm::vec3 front = m_camera.getFront();
+            glm::vec3 right = glm::normalize(glm::cross(front, glm::vec3(0.0f, 1.0f, 0.0f)));
+            glm::vec3 muzzle = m_camera.getPosition() + front * 0.5f + right * 0.15f - glm::vec3(0.0f, 0.12f, 0.0f);
+            m_particles->emit(m_muzzleEmitter, ParticleEffect::muzzleFlash(), muzzle, front);
+            m_particles->emit(m_muzzleEmitter, ParticleEffect::muzzleSparks(), muzzle, front);
+        }
+
+        // Bullets stop at the first collision triangle: walls, doors and furniture.
+        // Pellets fan out inside the weapon's spread and are traced as one packet.
+        if (m_level) {
+            glm::vec3 eye = m_camera.getPosition();
+            glm::vec3 front = m_camera.getFront();
+            glm::vec3 right = glm::normalize(glm::cross(front, glm::vec3(0.0f, 1.0f, 0.0f)));
+            glm::vec3 up = glm::cross(right, front);
+
+            int pellets = weapon->getPellets();
+            BvhRaycaster::Ray rays[Weapon::MAX_PELLETS];
+            BvhRaycaster::Hit hits[Weapon::MAX_PELLETS];
+            for (int i = 0; i < pellets; i++) {
+                glm::vec3 direction = front;
+                if (pellets > 1) {
+                    float angle = random01(m_spreadRandom) * 6.2831853f;
+                    float offset = std::tan(weapon->getSpread() * SPREAD_ANGLE) * std::sqrt(random01(m_spreadRandom));
+                    direction = glm::normalize(front + (right * std::cos(angle) + up * std::sin(angle)) * offset);
+                }
+                rays[i] = BvhRaycaster::Ray{ eye, direction, WEAPON_RANGE };
+            }
+            BvhRaycaster(m_level->getCollisionBvh()).cast(rays, pellets, BvhRaycaster::Mode::ClosestHit, hits);
+
+            for (int i = 0; i < pellets; i++) {
+                const BvhRaycaster::Hit& hit = hits[i];
+                if (hit.triangle < 0) continue;
+
+                // Decals need the wall surface the bullet stopped on; furniture has none
+                Level::RaycastHit surfaceHit;
+                if (m_decals && m_level->raycast(eye, rays[i].direction, hit.distance + SURFACE_TOLERANCE, surfaceHit) &&
+                    surfaceHit.distance >= hit.distance - SURFACE_TOLERANCE) {
+                    m_decals->spawn(*m_level, surfaceHit.surface, surfaceHit.point, surfaceHit.normal, DecalType::BulletHole);
+                }
+                if (m_particles) {
+                    m_particles->emit(m_impactEmitter, ParticleEffect::impactSparks(), hit.point, hit.normal);
+                    m_particles->emit(m_impactEmitter, ParticleEffect::impactDust(), hit.point, hit.normal);
+                }
+            }
+        }
     }
 }
 
 void Player::reload() {
-    if (m_currentWeapon) {
-        m_currentWeapon->reload();
-        std::cout << "Reloading " << m_currentWeapon->getName() << std::endl;
+    Weapon* weapon = Weapon::getPool().get(m_weapons[m_currentWeaponIndex]);
+    if (weapon) {
+        weapon->reload();
+        std::cout << "Reloading " << weapon->getName() << std::endl;
     }
 }
 
 void Player::changeWeapon(int slot) {
     if (slot >= 0 && slot < 3) {
         m_currentWeaponIndex = slot;
-        m_currentWeapon = m_weapons[slot];
-        std::cout << "Switched to " << m_currentWeapon->getName() << std::endl;
+        if (const Weapon* weapon = getCurrentWeapon()) {
+            std::cout << "Switched to " << weapon->getName() << std::endl;
+        }
     }
 }
 
@@ -146,14 +246,8 @@ void Player::addArmor(float amount) {
     m_armor = std::min(100.0f, m_armor + amount);
 }
 
-bool Player::checkCollision(const glm::vec3& position) {
-    // TODO: Implement collision detection with level geometry
-    // For now, just check if within bounds of the apartment
-    if (position.x < -10.0f || position.x > 10.0f ||
-        position.z < -10.0f || position.z > 10.0f) {
-        return true; // Collision detected (hit wall)
-    }
-    return false;
+bool Player::isOnGround() const {
+    return m_level ? m_controller.isGrounded() : m_position.y <= 0.0f;
 }
 
 void Player::applyGravity(float deltaTime) {
@@ -2,8 +2,13 @@
 
 #include <glm/glm.hpp>
 #include "Camera.hpp"
+#include "CharacterController.hpp"
 #include "Weapon.hpp"
 
+class ParticleSystem;
+class DecalSystem;
+class Level;
+
 class Player {
 public:
     Player(const glm::vec3& spawnPosition);
@@ -16,6 +21,13 @@ public:
     void move(char direction, float deltaTime);
     void look(float xoffset, float yoffset);
 
+    // Muzzle and impact effects are emitted into these systems
+    void setParticleSystem(ParticleSystem* particles);
+    void setDecalSystem(DecalSystem* decals) { m_decals = decals; }
+
+    // Geometry that shots hit
+    void setLevel(const Level* level) { m_level = level; }
+
     // Actions
     void shoot();
     void reload();
@@ -26,16 +38,13 @@ public:
     void heal(float amount);
     void addArmor(float amount);
 
-    // Collision detection
-    bool checkCollision(const glm::vec3& position);
-
     // Getters
     Camera& getCamera() { return m_camera; }
     const Camera& getCamera() const { return m_camera; }
     glm::vec3 getPosition() const { return m_position; }
     float getHealth() const { return m_health; }
     float getArmor() const { return m_armor; }
-    const Weapon* getCurrentWeapon() const { return m_currentWeapon; }
+    const Weapon* getCurrentWeapon() const;
     bool isAlive() const { return m_health > 0.0f; }
 
 private:
@@ -51,16 +60,25 @@ private:
     bool m_isJumping;
     glm::vec3 m_velocity;
 
-    // Weapon management
-    Weapon* m_weapons[3];
-    Weapon* m_currentWeapon;
+    // Weapon management; handles into Weapon::getPool()
+    Weapon::Handle m_weapons[3];
     int m_currentWeaponIndex;
+    unsigned int m_spreadRandom;    // Pellet directions
+
+    // Effects
+    ParticleSystem* m_particles;
+    DecalSystem* m_decals;
+    const Level* m_level;
+    int m_muzzleEmitter;
+    int m_impactEmitter;
 
     // Collision properties
     float m_height;
     float m_radius;
+    CharacterController m_controller;
 
     // Helper methods
     void applyGravity(float deltaTime);
+    bool isOnGround() const;
     void updateCollisionBox();
 };
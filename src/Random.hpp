@@ -0,0 +1,9 @@
+#pragma once
+
+// xorshift32 step; returns a float in [0, 1). state must never be 0.
+inline float random01(unsigned int& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,555 @@
+#include "RenderGraph.hpp"
+#include "Framebuffer.hpp"
+#include "MemoryTracker.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Physical resources unused for this many frames are released
+const int MAX_UNUSED_FRAMES = 60;
+
+bool isDepthFormat(GLenum format) {
+    return format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 ||
+           format == GL_DEPTH_COMPONENT32 || format == GL_DEPTH_COMPONENT32F ||
+           format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+bool hasStencil(GLenum format) {
+    return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+size_t bytesPerPixel(GLenum format) {
+    switch (format) {
+        case GL_R8: return 1;
+        case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16: return 2;
+        case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8: return 8;
+        case GL_RGBA32F: return 16;
+        default: return 4;
+    }
+}
+
+bool sameDesc(const RenderGraph::TextureDesc& a, const RenderGraph::TextureDesc& b) {
+    return a.width == b.width && a.height == b.height && a.format == b.format;
+}
+
+} // namespace
+
+// Builder
+
+RenderGraph::ResourceHandle RenderGraph::Builder::createTexture(const char* name, const TextureDesc& desc) {
+    int resource = m_graph.addResource(name, ResourceType::Texture, desc, 0);
+    int node = m_graph.addNode(resource, m_pass, -1);
+    m_graph.m_passes[m_pass].writes.push_back(node);
+    return node;
+}
+
+RenderGraph::ResourceHandle RenderGraph::Builder::createBuffer(const char* name, size_t size) {
+    int resource = m_graph.addResource(name, ResourceType::Buffer, TextureDesc(), size);
+    int node = m_graph.addNode(resource, m_pass, -1);
+    m_graph.m_passes[m_pass].writes.push_back(node);
+    return node;
+}
+
+RenderGraph::ResourceHandle RenderGraph::Builder::read(ResourceHandle resource) {
+    if (resource == INVALID_RESOURCE) return resource;
+    m_graph.m_passes[m_pass].reads.push_back(resource);
+    return resource;
+}
+
+RenderGraph::ResourceHandle RenderGraph::Builder::write(ResourceHandle resource) {
+    if (resource == INVALID_RESOURCE) return resource;
+
+    // Written in place this pass: nothing to version
+    Pass& pass = m_graph.m_passes[m_pass];
+    if (std::find(pass.writes.begin(), pass.writes.end(), resource) != pass.writes.end()) {
+        return resource;
+    }
+
+    // Writes are read-modify-write: the previous contents must exist first
+    pass.reads.push_back(resource);
+    int node = m_graph.addNode(m_graph.m_nodes[resource].resource, m_pass, resource);
+    pass.writes.push_back(node);
+
+    if (m_graph.m_resources[m_graph.m_nodes[resource].resource].imported) {
+        pass.sideEffect = true;
+    }
+    return node;
+}
+
+void RenderGraph::Builder::setSideEffect() {
+    m_graph.m_passes[m_pass].sideEffect = true;
+}
+
+// Context
+
+unsigned int RenderGraph::Context::getTexture(ResourceHandle resource) const {
+    const Resource& res = m_graph.m_resources[m_graph.m_nodes[resource].resource];
+    if (res.imported) return res.importedName;
+    return res.physical >= 0 ? m_graph.m_pool[res.physical].name : 0;
+}
+
+unsigned int RenderGraph::Context::getBuffer(ResourceHandle resource) const {
+    return getTexture(resource);
+}
+
+const RenderGraph::TextureDesc& RenderGraph::Context::getTextureDesc(ResourceHandle resource) const {
+    return m_graph.m_resources[m_graph.m_nodes[resource].resource].desc;
+}
+
+// RenderGraph
+
+RenderGraph::RenderGraph()
+    : m_passCount(0)
+    , m_resourceCount(0)
+    , m_nodeCount(0)
+    , m_culledPassCount(0)
+    , m_transientBytes(0)
+    , m_allocatedBytes(0)
+    , m_compiled(false)
+{
+}
+
+RenderGraph::~RenderGraph() {
+    for (auto& cached : m_framebuffers) {
+        glDeleteFramebuffers(1, &cached.framebuffer);
+    }
+    for (auto& physical : m_pool) {
+        destroyPhysical(physical);
+    }
+}
+
+void RenderGraph::reset() {
+    for (int i = 0; i < m_passCount; i++) {
+        m_passes[i].reads.clear();
+        m_passes[i].writes.clear();
+    }
+    m_passCount = 0;
+    m_resourceCount = 0;
+    m_nodeCount = 0;
+    m_compiled = false;
+}
+
+RenderGraph::ResourceHandle RenderGraph::importTexture(const char* name, unsigned int texture, const TextureDesc& desc) {
+    int resource = addResource(name, ResourceType::Texture, desc, 0);
+    m_resources[resource].imported = true;
+    m_resources[resource].importedName = texture;
+    return addNode(resource, -1, -1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::importBuffer(const char* name, unsigned int buffer, size_t size) {
+    int resource = addResource(name, ResourceType::Buffer, TextureDesc(), size);
+    m_resources[resource].imported = true;
+    m_resources[resource].importedName = buffer;
+    return addNode(resource, -1, -1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::importRenderTarget(const char* name, const Framebuffer* framebuffer,
+                                                            int width, int height) {
+    TextureDesc desc;
+    desc.width = width;
+    desc.height = height;
+    int resource = addResource(name, ResourceType::RenderTarget, desc, 0);
+    m_resources[resource].imported = true;
+    m_resources[resource].importedTarget = framebuffer;
+    return addNode(resource, -1, -1);
+}
+
+void RenderGraph::addPass(const char* name, const SetupFunction& setup, const ExecuteFunction& execute) {
+    if (m_passCount == static_cast<int>(m_passes.size())) {
+        m_passes.emplace_back();
+    }
+
+    int index = m_passCount++;
+    Pass& pass = m_passes[index];
+    pass.name = name;
+    pass.execute = execute;
+    pass.sideEffect = false;
+    pass.refCount = 0;
+    pass.culled = false;
+
+    Builder builder(*this, index);
+    setup(builder);
+    m_compiled = false;
+}
+
+bool RenderGraph::compile() {
+    cull();
+    if (!sortPasses()) {
+        std::cerr << "Render graph has a dependency cycle" << std::endl;
+        m_compiled = false;
+        return false;
+    }
+    allocateResources();
+    m_compiled = true;
+    return true;
+}
+
+void RenderGraph::execute() {
+    if (!m_compiled) return;
+
+    Context context(*this);
+    for (int index : m_order) {
+        const Pass& pass = m_passes[index];
+
+        // Bind the pass's render target: an imported target, or an FBO of its written textures
+        const Resource* target = nullptr;
+        bool writesTextures = false;
+        for (int node : pass.writes) {
+            const Resource& res = m_resources[m_nodes[node].resource];
+            if (res.type == ResourceType::RenderTarget) target = &res;
+            if (res.type == ResourceType::Texture) writesTextures = true;
+        }
+
+        if (target) {
+            if (target->importedTarget) {
+                target->importedTarget->bind();
+            } else {
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glViewport(0, 0, target->desc.width, target->desc.height);
+            }
+        } else if (writesTextures) {
+            glBindFramebuffer(GL_FRAMEBUFFER, acquireFramebuffer(pass));
+        }
+
+        pass.execute(context);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    releaseUnusedPhysical();
+}
+
+int RenderGraph::addResource(const char* name, ResourceType type, const TextureDesc& desc, size_t bufferSize) {
+    if (m_resourceCount == static_cast<int>(m_resources.size())) {
+        m_resources.emplace_back();
+    }
+
+    Resource& res = m_resources[m_resourceCount];
+    res.name = name;
+    res.type = type;
+    res.desc = desc;
+    res.bufferSize = bufferSize;
+    res.imported = false;
+    res.importedName = 0;
+    res.importedTarget = nullptr;
+    res.physical = -1;
+    res.firstUse = -1;
+    res.lastUse = -1;
+    return m_resourceCount++;
+}
+
+int RenderGraph::addNode(int resource, int producer, int previous) {
+    if (m_nodeCount == static_cast<int>(m_nodes.size())) {
+        m_nodes.emplace_back();
+    }
+
+    ResourceNode& node = m_nodes[m_nodeCount];
+    node.resource = resource;
+    node.producer = producer;
+    node.previous = previous;
+    node.refCount = 0;
+    return m_nodeCount++;
+}
+
+void RenderGraph::cull() {
+    // Reference counts: readers per version, written versions per pass
+    for (int i = 0; i < m_nodeCount; i++) {
+        m_nodes[i].refCount = 0;
+    }
+    for (int p = 0; p < m_passCount; p++) {
+        Pass& pass = m_passes[p];
+        pass.culled = false;
+        pass.refCount = static_cast<int>(pass.writes.size());
+        for (int node : pass.reads) {
+            m_nodes[node].refCount++;
+        }
+    }
+
+    // Versions nobody reads release their producer; producers with no
+    // remaining consumers are culled and release what they read in turn
+    m_cullStack.clear();
+    for (int i = 0; i < m_nodeCount; i++) {
+        if (m_nodes[i].refCount == 0) m_cullStack.push_back(i);
+    }
+    for (int p = 0; p < m_passCount; p++) {
+        m_passes[p].refCount++;                 // Released by the sweep below
+        m_cullStack.push_back(-1 - p);
+    }
+
+    m_culledPassCount = 0;
+    while (!m_cullStack.empty()) {
+        int entry = m_cullStack.back();
+        m_cullStack.pop_back();
+
+        int producer = entry >= 0 ? m_nodes[entry].producer : -1 - entry;
+        if (producer < 0) continue;
+
+        Pass& pass = m_passes[producer];
+        if (--pass.refCount > 0 || pass.sideEffect || pass.culled) continue;
+
+        pass.culled = true;
+        m_culledPassCount++;
+        for (int node : pass.reads) {
+            if (--m_nodes[node].refCount == 0) m_cullStack.push_back(node);
+        }
+    }
+}
+
+bool RenderGraph::sortPasses() {
+    // Dependencies: producer before reader, and readers of a version before
+    // the pass that overwrites it
+    m_edges.clear();
+    for (int p = 0; p < m_passCount; p++) {
+        const Pass& pass = m_passes[p];
+        if (pass.culled) continue;
+
+        for (int node : pass.reads) {
+            int producer = m_nodes[node].producer;
+            if (producer >= 0 && producer != p) {
+                m_edges.push_back(producer);
+                m_edges.push_back(p);
+            }
+        }
+
+        for (int node : pass.writes) {
+            int previous = m_nodes[node].previous;
+            if (previous < 0) continue;
+            for (int r = 0; r < m_passCount; r++) {
+                if (r == p || m_passes[r].culled) continue;
+                const auto& reads = m_passes[r].reads;
+                if (std::find(reads.begin(), reads.end(), previous) != reads.end()) {
+                    m_edges.push_back(r);
+                    m_edges.push_back(p);
+                }
+            }
+        }
+    }
+
+    m_pendingDeps.assign(m_passCount, 0);
+    for (size_t e = 0; e < m_edges.size(); e += 2) {
+        m_pendingDeps[m_edges[e + 1]]++;
+    }
+
+    // Kahn's algorithm; ties resolve to declaration order for determinism
+    m_order.clear();
+    int liveCount = m_passCount - m_culledPassCount;
+    while (static_cast<int>(m_order.size()) < liveCount) {
+        int next = -1;
+        for (int p = 0; p < m_passCount; p++) {
+            if (!m_passes[p].culled && m_pendingDeps[p] == 0) {
+                next = p;
+                break;
+            }
+        }
+        if (next < 0) return false;
+
+        m_pendingDeps[next] = -1;
+        m_order.push_back(next);
+        for (size_t e = 0; e < m_edges.size(); e += 2) {
+            if (m_edges[e] == next) m_pendingDeps[m_edges[e + 1]]--;
+        }
+    }
+    return true;
+}
+
+void RenderGraph::allocateResources() {
+    // Lifetimes in execution order
+    for (int r = 0; r < m_resourceCount; r++) {
+        m_resources[r].firstUse = -1;
+        m_resources[r].lastUse = -1;
+        m_resources[r].physical = -1;
+    }
+    for (int position = 0; position < static_cast<int>(m_order.size()); position++) {
+        const Pass& pass = m_passes[m_order[position]];
+        for (const auto* nodes : { &pass.reads, &pass.writes }) {
+            for (int node : *nodes) {
+                Resource& res = m_resources[m_nodes[node].resource];
+                if (res.firstUse < 0) res.firstUse = position;
+                res.lastUse = position;
+            }
+        }
+    }
+
+    for (auto& physical : m_pool) {
+        physical.inUse = false;
+    }
+
+    // Greedy assignment: a physical resource freed after a transient's last use
+    // can back any later transient with the same description
+    m_transientBytes = 0;
+    for (int position = 0; position < static_cast<int>(m_order.size()); position++) {
+        for (int r = 0; r < m_resourceCount; r++) {
+            Resource& res = m_resources[r];
+            if (res.imported || res.firstUse != position) continue;
+
+            int match = -1;
+            for (int i = 0; i < static_cast<int>(m_pool.size()); i++) {
+                const PhysicalResource& physical = m_pool[i];
+                if (physical.inUse || physical.type != res.type) continue;
+                if (res.type == ResourceType::Texture ? sameDesc(physical.desc, res.desc)
+                                                      : physical.bufferSize == res.bufferSize) {
+                    match = i;
+                    break;
+                }
+            }
+
+            if (match < 0) {
+                PhysicalResource physical;
+                physical.type = res.type;
+                physical.desc = res.desc;
+                physical.bufferSize = res.bufferSize;
+                physical.name = 0;
+                physical.inUse = false;
+                physical.unusedFrames = 0;
+
+                if (res.type == ResourceType::Texture) {
+                    GLenum format = GL_RGBA;
+                    GLenum type = GL_UNSIGNED_BYTE;
+                    if (res.desc.format == GL_DEPTH24_STENCIL8) {
+                        format = GL_DEPTH_STENCIL;
+                        type = GL_UNSIGNED_INT_24_8;
+                    } else if (res.desc.format == GL_DEPTH32F_STENCIL8) {
+                        format = GL_DEPTH_STENCIL;
+                        type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+                    } else if (isDepthFormat(res.desc.format)) {
+                        format = GL_DEPTH_COMPONENT;
+                        type = GL_FLOAT;
+                    }
+
+                    glGenTextures(1, &physical.name);
+                    glBindTexture(GL_TEXTURE_2D, physical.name);
+                    glTexImage2D(GL_TEXTURE_2D, 0, res.desc.format, res.desc.width, res.desc.height, 0,
+                                 format, type, nullptr);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                    glBindTexture(GL_TEXTURE_2D, 0);
+                    physical.bytes = size_t(res.desc.width) * res.desc.height * bytesPerPixel(res.desc.format);
+                } else {
+                    glGenBuffers(1, &physical.name);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, physical.name);
+                    glBufferData(GL_COPY_WRITE_BUFFER, res.bufferSize, nullptr, GL_DYNAMIC_DRAW);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                    physical.bytes = res.bufferSize;
+                }
+
+                MemoryTracker::addGpuBytes(MemoryTag::Renderer, static_cast<int64_t>(physical.bytes));
+                m_pool.push_back(physical);
+                match = static_cast<int>(m_pool.size()) - 1;
+            }
+
+            m_pool[match].inUse = true;
+            m_pool[match].unusedFrames = 0;
+            res.physical = match;
+            m_transientBytes += m_pool[match].bytes;
+        }
+
+        // Transients that end here hand their memory to later passes
+        for (int r = 0; r < m_resourceCount; r++) {
+            const Resource& res = m_resources[r];
+            if (!res.imported && res.lastUse == position && res.physical >= 0) {
+                m_pool[res.physical].inUse = false;
+            }
+        }
+    }
+
+    m_allocatedBytes = 0;
+    for (const auto& physical : m_pool) {
+        m_allocatedBytes += physical.bytes;
+    }
+}
+
+void RenderGraph::releaseUnusedPhysical() {
+    // Entries used this frame were reset to 0 by allocateResources
+    for (size_t i = m_pool.size(); i-- > 0;) {
+        if (++m_pool[i].unusedFrames <= MAX_UNUSED_FRAMES) continue;
+
+        // Drop cached framebuffers that reference the texture
+        unsigned int name = m_pool[i].name;
+        for (size_t f = m_framebuffers.size(); f-- > 0;) {
+            const CachedFramebuffer& cached = m_framebuffers[f];
+            if (m_pool[i].type == ResourceType::Texture &&
+                std::find(cached.attachments, cached.attachments + 5, name) != cached.attachments + 5) {
+                glDeleteFramebuffers(1, &m_framebuffers[f].framebuffer);
+                m_framebuffers.erase(m_framebuffers.begin() + f);
+            }
+        }
+
+        m_allocatedBytes -= m_pool[i].bytes;
+        destroyPhysical(m_pool[i]);
+        m_pool.erase(m_pool.begin() + i);
+    }
+
+    for (size_t f = m_framebuffers.size(); f-- > 0;) {
+        if (++m_framebuffers[f].unusedFrames > MAX_UNUSED_FRAMES) {
+            glDeleteFramebuffers(1, &m_framebuffers[f].framebuffer);
+            m_framebuffers.erase(m_framebuffers.begin() + f);
+        }
+    }
+}
+
+unsigned int RenderGraph::acquireFramebuffer(const Pass& pass) {
+    unsigned int attachments[5] = { 0, 0, 0, 0, 0 };
+    int colorCount = 0;
+    GLenum depthAttachment = GL_DEPTH_ATTACHMENT;
+    for (int node : pass.writes) {
+        const Resource& res = m_resources[m_nodes[node].resource];
+        if (res.type != ResourceType::Texture) continue;
+
+        unsigned int texture = res.imported ? res.importedName : m_pool[res.physical].name;
+        if (isDepthFormat(res.desc.format)) {
+            attachments[4] = texture;
+            depthAttachment = hasStencil(res.desc.format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        } else if (colorCount < 4) {
+            attachments[colorCount++] = texture;
+        }
+    }
+
+    for (auto& cached : m_framebuffers) {
+        if (std::memcmp(cached.attachments, attachments, sizeof(attachments)) == 0) {
+            cached.unusedFrames = 0;
+            return cached.framebuffer;
+        }
+    }
+
+    CachedFramebuffer cached;
+    std::memcpy(cached.attachments, attachments, sizeof(attachments));
+    cached.unusedFrames = 0;
+    glGenFramebuffers(1, &cached.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, cached.framebuffer);
+
+    GLenum drawBuffers[4];
+    for (int i = 0; i < colorCount; i++) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, attachments[i], 0);
+        drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+    if (attachments[4]) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, depthAttachment, GL_TEXTURE_2D, attachments[4], 0);
+    }
+    if (colorCount > 0) {
+        glDrawBuffers(colorCount, drawBuffers);
+    } else {
+        glDrawBuffer(GL_NONE);
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Render graph pass '" << pass.name << "' has an incomplete framebuffer" << std::endl;
+    }
+
+    m_framebuffers.push_back(cached);
+    return cached.framebuffer;
+}
+
+void RenderGraph::destroyPhysical(PhysicalResource& physical) {
+    if (physical.name == 0) return;
+
+    if (physical.type == ResourceType::Texture) {
+        glDeleteTextures(1, &physical.name);
+    } else {
+        glDeleteBuffers(1, &physical.name);
+    }
+    MemoryTracker::addGpuBytes(MemoryTag::Renderer, -static_cast<int64_t>(physical.bytes));
+    physical.name = 0;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <GL/glew.h>
+
+class Framebuffer;
+
+// Per-frame render graph.
+// Passes declare the textures and buffers they read and write; compile() culls
+// passes whose results are never consumed, orders the rest by their data
+// dependencies and assigns transient resources to a pool of physical GL objects,
+// reusing (aliasing) memory between resources whose lifetimes do not overlap.
+//
+// Resource handles are versioned: write() returns a new handle for the written
+// version, and reads always refer to a specific version, so every version has
+// exactly one producing pass.
+class RenderGraph {
+public:
+    typedef int ResourceHandle;
+    static const ResourceHandle INVALID_RESOURCE = -1;
+
+    struct TextureDesc {
+        int width = 0;
+        int height = 0;
+        GLenum format = GL_RGBA8;   // Internal format; depth formats become depth attachments
+    };
+
+    // Declares resource usage while a pass is being added
+    class Builder {
+    public:
+        // New transient resources, produced by this pass
+        ResourceHandle createTexture(const char* name, const TextureDesc& desc);
+        ResourceHandle createBuffer(const char* name, size_t size);
+
+        ResourceHandle read(ResourceHandle resource);
+        ResourceHandle write(ResourceHandle resource);
+
+        // Never cull this pass, even if nothing reads its output
+        void setSideEffect();
+
+    private:
+        friend class RenderGraph;
+        Builder(RenderGraph& graph, int pass) : m_graph(graph), m_pass(pass) {}
+
+        RenderGraph& m_graph;
+        int m_pass;
+    };
+
+    // Physical resources available while a pass executes
+    class Context {
+    public:
+        unsigned int getTexture(ResourceHandle resource) const;
+        unsigned int getBuffer(ResourceHandle resource) const;
+        const TextureDesc& getTextureDesc(ResourceHandle resource) const;
+
+    private:
+        friend class RenderGraph;
+        explicit Context(const RenderGraph& graph) : m_graph(graph) {}
+
+        const RenderGraph& m_graph;
+    };
+
+    typedef std::function<void(Builder&)> SetupFunction;
+    typedef std::function<void(const Context&)> ExecuteFunction;
+
+    RenderGraph();
+    ~RenderGraph();
+
+    // Start a new frame. Pass and resource storage, and the physical pool, are kept.
+    void reset();
+
+    // External resources; writing to an imported resource marks it as a graph output
+    ResourceHandle importTexture(const char* name, unsigned int texture, const TextureDesc& desc);
+    ResourceHandle importBuffer(const char* name, unsigned int buffer, size_t size);
+    ResourceHandle importRenderTarget(const char* name, const Framebuffer* framebuffer, int width, int height);
+
+    // Names must outlive the frame (string literals)
+    void addPass(const char* name, const SetupFunction& setup, const ExecuteFunction& execute);
+
+    bool compile();
+    void execute();
+
+    // Statistics of the last compiled frame
+    int getPassCount() const { return m_passCount; }
+    int getCulledPassCount() const { return m_culledPassCount; }
+    size_t getTransientBytes() const { return m_transientBytes; }   // Without aliasing
+    size_t getAllocatedBytes() const { return m_allocatedBytes; }   // Physical pool
+
+private:
+    enum class ResourceType { Texture, Buffer, RenderTarget };
+
+    struct Resource {
+        const char* name;
+        ResourceType type;
+        TextureDesc desc;
+        size_t bufferSize;
+        bool imported;
+        unsigned int importedName;              // Texture/buffer name when imported
+        const Framebuffer* importedTarget;      // RenderTarget (nullptr = window)
+        int physical;                           // Index into the pool, -1 if none
+        int firstUse;                           // Execution order positions
+        int lastUse;
+    };
+
+    // One version of a resource
+    struct ResourceNode {
+        int resource;
+        int producer;       // Pass that wrote this version, -1 for imports
+        int previous;       // Version this one overwrites, -1 for the first version
+        int refCount;
+    };
+
+    struct Pass {
+        const char* name;
+        ExecuteFunction execute;
+        std::vector<int> reads;     // Resource nodes
+        std::vector<int> writes;
+        bool sideEffect;
+        int refCount;
+        bool culled;
+    };
+
+    struct PhysicalResource {
+        ResourceType type;
+        TextureDesc desc;
+        size_t bufferSize;
+        unsigned int name;
+        size_t bytes;
+        bool inUse;
+        int unusedFrames;
+    };
+
+    struct CachedFramebuffer {
+        unsigned int attachments[5];    // 4 color + depth texture names
+        unsigned int framebuffer;
+        int unusedFrames;
+    };
+
+    std::vector<Pass> m_passes;
+    std::vector<Resource> m_resources;
+    std::vector<ResourceNode> m_nodes;
+    int m_passCount;
+    int m_resourceCount;
+    int m_nodeCount;
+
+    std::vector<int> m_order;           // Execution order of surviving passes
+    std::vector<int> m_pendingDeps;
+    std::vector<int> m_edges;           // Flattened (before, after) pass pairs
+    std::vector<int> m_cullStack;
+    std::vector<PhysicalResource> m_pool;
+    std::vector<CachedFramebuffer> m_framebuffers;
+
+    int m_culledPassCount;
+    size_t m_transientBytes;
+    size_t m_allocatedBytes;
+    bool m_compiled;
+
+    int addResource(const char* name, ResourceType type, const TextureDesc& desc, size_t bufferSize);
+    int addNode(int resource, int producer, int previous);
+
+    void cull();
+    bool sortPasses();
+    void allocateResources();
+    void releaseUnusedPhysical();
+    unsigned int acquireFramebuffer(const Pass& pass);
+    void destroyPhysical(PhysicalResource& physical);
+};
@@ -1,14 +1,44 @@
 #include "Renderer.hpp"
+#include "GpuResourceRegistry.hpp"
+#include "MemoryTracker.hpp"
 #include <GL/glew.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+
+// Fraction of the screen height the bounding sphere must cover to stay at LOD 0, 1, 2
+static const float LOD_SCREEN_SIZES[] = { 0.25f, 0.10f, 0.04f };
+static const int LOD_SCREEN_SIZE_COUNT = sizeof(LOD_SCREEN_SIZES) / sizeof(LOD_SCREEN_SIZES[0]);
+
+// Width of the cross-fade band above each threshold, relative to the threshold
+static const float LOD_FADE_BAND = 0.2f;
+
+// Dynamic resolution limits
+static const float MIN_RENDER_SCALE = 0.5f;
+static const float MAX_RENDER_SCALE = 1.0f;
 
 Renderer::Renderer(int width, int height)
     : m_width(width)
     , m_height(height)
     , m_camera(nullptr)
     , m_defaultShader(0)
+    , m_lodCrossFade(false)
+    , m_lodScale(1.0f)
+    , m_staticMeshes(nullptr)
+    , m_gpuDriven(true)
+    , m_sceneColor(RenderGraph::INVALID_RESOURCE)
+    , m_sceneDepth(RenderGraph::INVALID_RESOURCE)
+    , m_backbuffer(RenderGraph::INVALID_RESOURCE)
+    , m_upscaleShader(0)
+    , m_fullscreenVAO(0)
+    , m_dynamicResolution(true)
+    , m_targetFrameTime(1000.0f / 144.0f)
+    , m_renderScale(1.0f)
+    , m_sharpness(0.5f)
+    , m_gpuFrameTime(0.0)
+    , m_inFrame(false)
 {
     setProjection(45.0f, (float)width / (float)height, 0.1f, 100.0f);
 }
@@ -17,9 +47,16 @@ Renderer::~Renderer() {
     if (m_defaultShader) {
         glDeleteProgram(m_defaultShader);
     }
+    if (m_upscaleShader) {
+        glDeleteProgram(m_upscaleShader);
+    }
+    if (m_fullscreenVAO) {
+        glDeleteVertexArrays(1, &m_fullscreenVAO);
+    }
 }
 
 bool Renderer::initialize() {
+    MemoryTracker::Scope memoryScope(MemoryTag::Renderer);
     // Initialize GLEW
     if (glewInit() != GLEW_OK) {
         std::cerr << "Failed to initialize GLEW" << std::endl;
@@ -38,10 +75,236 @@ bool Renderer::initialize() {
         return false;
     }
 
+    // Upscale from the dynamic-resolution scene target
+    m_upscaleShader = loadShader("res/shaders/upscale.vert", "res/shaders/upscale.frag");
+    if (m_upscaleShader == 0) {
+        std::cerr << "Failed to load upscale shader" << std::endl;
+        return false;
+    }
+
+    glGenVertexArrays(1, &m_fullscreenVAO);
+    m_frameTimer.reset(new GpuTimer());
+
+    // Staging ring for mesh uploads
+    m_uploads.reset(new UploadQueue());
+    if (!m_uploads->initialize()) {
+        std::cerr << "Failed to initialize upload queue" << std::endl;
+        return false;
+    }
+
+    // GPU-skinned characters
+    unsigned int skinnedShader = loadShader("res/shaders/skinned.vert", "res/shaders/basic.frag");
+    m_characters.reset(new CharacterSystem());
+    if (skinnedShader == 0 || !m_characters->initialize(skinnedShader)) {
+        std::cerr << "Failed to initialize character system" << std::endl;
+        return false;
+    }
+
+    // Decal ring
+    unsigned int decalShader = loadShader("res/shaders/decal.vert", "res/shaders/decal.frag");
+    m_decals.reset(new DecalSystem());
+    if (decalShader == 0 || !m_decals->initialize(decalShader)) {
+        std::cerr << "Failed to initialize decal system" << std::endl;
+        return false;
+    }
+
+    // Billboard particles
+    unsigned int particleShader = loadShader("res/shaders/particle.vert", "res/shaders/particle.frag");
+    m_particles.reset(new ParticleSystem());
+    if (particleShader == 0 || !m_particles->initialize(particleShader)) {
+        std::cerr << "Failed to initialize particle system" << std::endl;
+        return false;
+    }
+
+    // HUD and text
+    unsigned int overlayShader = loadShader("res/shaders/overlay.vert", "res/shaders/overlay.frag");
+    m_overlay.reset(new OverlayRenderer());
+    if (overlayShader == 0 || !m_overlay->initialize(overlayShader)) {
+        std::cerr << "Failed to initialize overlay renderer" << std::endl;
+        return false;
+    }
+
+    // GPU-driven path for static geometry; falls back to per-mesh draws
+    if (IndirectRenderer::isSupported()) {
+        unsigned int cullShader = loadComputeShader("res/shaders/cull.comp");
+        unsigned int drawShader = loadShader("res/shaders/indirect.vert", "res/shaders/basic.frag");
+        if (cullShader && drawShader) {
+            m_indirect.reset(new IndirectRenderer());
+            m_indirect->setShaders(cullShader, drawShader);
+        } else {
+            if (cullShader) glDeleteProgram(cullShader);
+            if (drawShader) glDeleteProgram(drawShader);
+            std::cerr << "GPU-driven rendering unavailable, using per-mesh draws" << std::endl;
+        }
+    }
+
     return true;
 }
 
+void Renderer::beginFrame() {
+    MemoryTracker::Scope memoryScope(MemoryTag::Renderer);
+    m_inFrame = true;
+    m_drawQueue.clear();
+
+    // Meshes whose uploads completed become drawable; the next budget is copied
+    m_uploads->update();
+}
+
+void Renderer::endFrame(const Framebuffer* output) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Renderer);
+    if (!m_inFrame) return;
+    m_inFrame = false;
+
+    // Build this frame's graph. Scene targets are native-size transients rendered
+    // into a sub-rectangle, so a render-scale change never reallocates them.
+    m_graph.reset();
+    m_backbuffer = m_graph.importRenderTarget("backbuffer", output,
+                                              output ? output->getWidth() : m_width,
+                                              output ? output->getHeight() : m_height);
+
+    m_graph.addPass("scene",
+        [this](RenderGraph::Builder& builder) {
+            RenderGraph::TextureDesc color;
+            color.width = m_width;
+            color.height = m_height;
+            color.format = GL_RGBA8;
+            RenderGraph::TextureDesc depth = color;
+            depth.format = GL_DEPTH24_STENCIL8;
+            m_sceneColor = builder.createTexture("sceneColor", color);
+            m_sceneDepth = builder.createTexture("sceneDepth", depth);
+        },
+        [this](const RenderGraph::Context&) {
+            executeScenePass();
+        });
+
+    m_graph.addPass("upscale",
+        [this](RenderGraph::Builder& builder) {
+            builder.read(m_sceneColor);
+            m_backbuffer = builder.write(m_backbuffer);
+        },
+        [this](const RenderGraph::Context& context) {
+            executeUpscalePass(context.getTexture(m_sceneColor));
+        });
+
+    if (m_overlay->getQuadCount() > 0) {
+        m_graph.addPass("overlay",
+            [this](RenderGraph::Builder& builder) {
+                m_backbuffer = builder.write(m_backbuffer);
+            },
+            [this](const RenderGraph::Context&) {
+                m_overlay->render();
+            });
+    }
+
+    if (!m_graph.compile()) return;
+
+    m_frameTimer->begin();
+    m_graph.execute();
+    m_frameTimer->end();
+
+    // GL objects released before this point are deleted once the GPU passes here
+    GpuResourceRegistry::get().endFrame();
+
+    // Smoothed GPU frame time drives the next frame's resolution
+    double gpuMs = 0.0;
+    while (m_frameTimer->poll(gpuMs)) {
+        m_gpuFrameTime = m_gpuFrameTime > 0.0 ? m_gpuFrameTime * 0.9 + gpuMs * 0.1 : gpuMs;
+    }
+    if (m_dynamicResolution) {
+        updateRenderScale();
+    }
+}
+
+void Renderer::executeScenePass() {
+    if (!m_camera) return;
+
+    int sceneWidth = std::max(1, static_cast<int>(m_width * m_renderScale + 0.5f));
+    int sceneHeight = std::max(1, static_cast<int>(m_height * m_renderScale + 0.5f));
+
+    glViewport(0, 0, sceneWidth, sceneHeight);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, sceneWidth, sceneHeight);
+    glEnable(GL_DEPTH_TEST);
+
+    // Transient targets may alias other memory: always start from a cleared target
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Static world: the batch in one indirect draw, then the meshes with their own
+    // GPU copy (batch members never get one)
+    if (isGpuDriven()) {
+        float lodScreenFactor = m_lodScale / std::tan(glm::radians(m_camera->getZoom()) * 0.5f);
+        m_indirect->draw(m_camera->getViewMatrix(), m_projection, m_camera->getPosition(),
+                         lodScreenFactor, LOD_SCREEN_SIZES);
+    }
+    if (m_staticMeshes) {
+        for (const Mesh& mesh : *m_staticMeshes) {
+            if (mesh.isReady()) submitMesh(&mesh, glm::mat4(1.0f));
+        }
+    }
+
+    for (const auto& command : m_drawQueue) {
+        submitMesh(command.mesh, command.modelMatrix);
+    }
+
+    m_characters->render(m_camera->getViewMatrix(), m_projection);
+    m_decals->render(m_camera->getViewMatrix(), m_projection);
+    m_particles->render(m_camera->getViewMatrix(), m_projection);
+
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void Renderer::setStaticMeshes(const std::vector<Mesh>& meshes, const MeshBatch* batch) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Renderer);
+    m_staticMeshes = &meshes;
+    if (!m_indirect) {
+        if (batch) std::cerr << "Renderer: GPU-driven rendering unavailable, static batch not drawn" << std::endl;
+    } else if (batch) {
+        m_indirect->build(*batch);
+    } else {
+        m_indirect->clear();
+    }
+}
+
+void Renderer::executeUpscalePass(unsigned int sceneTexture) {
+    // Upscale + sharpen into the output at native resolution
+    glDisable(GL_DEPTH_TEST);
+    useShader(m_upscaleShader);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, sceneTexture);
+    glUniform1i(glGetUniformLocation(m_upscaleShader, "sceneTexture"), 0);
+    glUniform2f(glGetUniformLocation(m_upscaleShader, "uvScale"),
+                std::max(1, static_cast<int>(m_width * m_renderScale + 0.5f)) / (float)m_width,
+                std::max(1, static_cast<int>(m_height * m_renderScale + 0.5f)) / (float)m_height);
+    glUniform2f(glGetUniformLocation(m_upscaleShader, "texelSize"), 1.0f / m_width, 1.0f / m_height);
+    setShaderFloat(m_upscaleShader, "sharpness", m_renderScale < MAX_RENDER_SCALE ? m_sharpness : 0.0f);
+
+    glBindVertexArray(m_fullscreenVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void Renderer::setRenderScale(float scale) {
+    m_renderScale = std::min(std::max(scale, MIN_RENDER_SCALE), MAX_RENDER_SCALE);
+}
+
+void Renderer::updateRenderScale() {
+    if (m_gpuFrameTime <= 0.0) return;
+
+    // Pixel cost scales with the square of the render scale
+    float ratio = static_cast<float>(m_targetFrameTime / m_gpuFrameTime);
+    if (ratio < 0.95f) {
+        setRenderScale(m_renderScale * std::max(0.9f, std::sqrt(ratio)));
+    } else if (ratio > 1.2f) {
+        setRenderScale(m_renderScale + 0.01f);
+    }
+}
+
 void Renderer::clear() {
+    if (m_inFrame) return;
+
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -49,6 +312,17 @@ void Renderer::clear() {
 void Renderer::drawMesh(const Mesh* mesh, const glm::mat4& modelMatrix) {
     if (!m_camera) return;
 
+    if (m_inFrame) {
+        m_drawQueue.push_back({mesh, modelMatrix});
+        return;
+    }
+
+    submitMesh(mesh, modelMatrix);
+}
+
+void Renderer::submitMesh(const Mesh* mesh, const glm::mat4& modelMatrix) {
+    if (!m_camera) return;
+
     // Use default shader if no shader is explicitly set
     useShader(m_defaultShader);
 
@@ -57,8 +331,58 @@ void Renderer::drawMesh(const Mesh* mesh, const glm::mat4& modelMatrix) {
     setShaderMat4(m_defaultShader, "view", m_camera->getViewMatrix());
     setShaderMat4(m_defaultShader, "projection", m_projection);
 
-    // Draw the mesh
-    mesh->draw();
+    // Meshes bind their diffuse texture to unit 0 in draw()
+    const std::vector<Texture>& textures = mesh->getTextures();
+    bool textured = !textures.empty() && GpuResourceRegistry::get().isAlive(textures[0].handle);
+    glUniform1i(glGetUniformLocation(m_defaultShader, "hasTexture"), textured ? 1 : 0);
+
+    // Draw the mesh, dithering between two levels inside the fade band
+    float fade = 0.0f;
+    int lod = selectLod(mesh, modelMatrix, m_lodCrossFade ? &fade : nullptr);
+
+    if (fade > 0.0f) {
+        setShaderFloat(m_defaultShader, "lodFade", -fade);
+        mesh->draw(lod);
+        setShaderFloat(m_defaultShader, "lodFade", fade);
+        mesh->draw(lod + 1);
+    } else {
+        setShaderFloat(m_defaultShader, "lodFade", 0.0f);
+        mesh->draw(lod);
+    }
+}
+
+int Renderer::selectLod(const Mesh* mesh, const glm::mat4& modelMatrix, float* crossFade) const {
+    if (crossFade) *crossFade = 0.0f;
+    if (!m_camera || mesh->getLodCount() <= 1) return 0;
+
+    // World-space bounding sphere
+    glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(mesh->getBoundsCenter(), 1.0f));
+    float scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+                  std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    float radius = mesh->getBoundsRadius() * scale;
+
+    float distance = glm::distance(center, m_camera->getPosition());
+    if (distance <= radius) return 0;
+
+    // Projected diameter as a fraction of the screen height
+    float screenSize = radius / (distance * std::tan(glm::radians(m_camera->getZoom()) * 0.5f)) * m_lodScale;
+
+    int maxLod = std::min(mesh->getLodCount() - 1, LOD_SCREEN_SIZE_COUNT);
+    int lod = 0;
+    while (lod < maxLod && screenSize < LOD_SCREEN_SIZES[lod]) {
+        lod++;
+    }
+
+    // Blend towards the next level when just above its threshold
+    if (crossFade && lod < maxLod) {
+        float threshold = LOD_SCREEN_SIZES[lod];
+        float bandTop = threshold * (1.0f + LOD_FADE_BAND);
+        if (screenSize < bandTop) {
+            *crossFade = (bandTop - screenSize) / (bandTop - threshold);
+        }
+    }
+
+    return lod;
 }
 
 void Renderer::setCamera(const Camera* camera) {
@@ -69,28 +393,24 @@ void Renderer::setProjection(float fov, float aspect, float near, float far) {
     m_projection = glm::perspective(glm::radians(fov), aspect, near, far);
 }
 
-unsigned int Renderer::loadShader(const char* vertexPath, const char* fragmentPath) {
-    // Read vertex shader
-    std::string vertexCode;
-    std::ifstream vShaderFile(vertexPath);
-    if (vShaderFile) {
-        std::stringstream vShaderStream;
-        vShaderStream << vShaderFile.rdbuf();
-        vertexCode = vShaderStream.str();
-    } else {
-        std::cerr << "Failed to read vertex shader file: " << vertexPath << std::endl;
-        return 0;
+bool Renderer::readShaderFile(const char* path, std::string& source) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to read shader file: " << path << std::endl;
+        return false;
     }
 
-    // Read fragment shader
+    std::stringstream stream;
+    stream << file.rdbuf();
+    source = stream.str();
+    return true;
+}
+
+unsigned int Renderer::loadShader(const char* vertexPath, const char* fragmentPath) {
+    // Read shader sources
+    std::string vertexCode;
     std::string fragmentCode;
-    std::ifstream fShaderFile(fragmentPath);
-    if (fShaderFile) {
-        std::stringstream fShaderStream;
-        fShaderStream << fShaderFile.rdbuf();
-        fragmentCode = fShaderStream.str();
-    } else {
-        std::cerr << "Failed to read fragment shader file: " << fragmentPath << std::endl;
+    if (!readShaderFile(vertexPath, vertexCode) || !readShaderFile(fragmentPath, fragmentCode)) {
         return 0;
     }
 
@@ -99,6 +419,8 @@ unsigned int Renderer::loadShader(const char* vertexPath, const char* fragmentPa
     unsigned int fragment = compileShader(fragmentCode.c_str(), GL_FRAGMENT_SHADER);
 
     if (vertex == 0 || fragment == 0) {
+        if (vertex) glDeleteShader(vertex);
+        if (fragment) glDeleteShader(fragment);
         return 0;
     }
 
@@ -120,6 +442,30 @@ unsigned int Renderer::loadShader(const char* vertexPath, const char* fragmentPa
     return shaderProgram;
 }
 
+unsigned int Renderer::loadComputeShader(const char* computePath) {
+    std::string computeCode;
+    if (!readShaderFile(computePath, computeCode)) {
+        return 0;
+    }
+
+    unsigned int compute = compileShader(computeCode.c_str(), GL_COMPUTE_SHADER);
+    if (compute == 0) {
+        return 0;
+    }
+
+    unsigned int shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, compute);
+    glLinkProgram(shaderProgram);
+
+    if (!checkProgramLinkErrors(shaderProgram)) {
+        glDeleteProgram(shaderProgram);
+        shaderProgram = 0;
+    }
+
+    glDeleteShader(compute);
+    return shaderProgram;
+}
+
 void Renderer::useShader(unsigned int shaderProgram) {
     glUseProgram(shaderProgram);
 }
@@ -140,6 +486,10 @@ void Renderer::setShaderFloat(unsigned int shaderProgram, const char* name, floa
 }
 
 void Renderer::resize(int width, int height) {
+    MemoryTracker::Scope memoryScope(MemoryTag::Renderer);
+    // Minimized window
+    if (width <= 0 || height <= 0) return;
+
     m_width = width;
     m_height = height;
     glViewport(0, 0, width, height);
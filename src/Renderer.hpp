@@ -1,9 +1,21 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Camera.hpp"
 #include "Mesh.hpp"
+#include "Framebuffer.hpp"
+#include "GpuTimer.hpp"
+#include "RenderGraph.hpp"
+#include "IndirectRenderer.hpp"
+#include "OverlayRenderer.hpp"
+#include "ParticleSystem.hpp"
+#include "DecalSystem.hpp"
+#include "CharacterSystem.hpp"
+#include "UploadQueue.hpp"
 
 class Renderer {
 public:
@@ -13,20 +25,57 @@ public:
     // Initialize OpenGL context
     bool initialize();
 
-    // Clear the screen
+    // Frame structure: between beginFrame and endFrame, clear/drawMesh are recorded.
+    // endFrame builds the frame's render graph (scene at the current render scale,
+    // upscale into `output`, nullptr = window) and executes it.
+    void beginFrame();
+    void endFrame(const Framebuffer* output = nullptr);
+
+    // Clear the screen (inside a frame the scene pass always starts cleared)
     void clear();
 
-    // Draw a mesh
+    // Draw a mesh (recorded for the scene pass inside a frame)
     void drawMesh(const Mesh* mesh, const glm::mat4& modelMatrix);
 
+    // Static world geometry, drawn every frame before recorded meshes. A batch
+    // (Level::buildStaticBatch) is culled and drawn by the GPU-driven indirect path;
+    // every mesh uploaded on its own gets a per-mesh draw.
+    void setStaticMeshes(const std::vector<Mesh>& meshes, const MeshBatch* batch = nullptr);
+    // Whether static geometry should be batched: enabled and GL 4.3 is available
+    void setGpuDriven(bool enabled) { m_gpuDriven = enabled; }
+    bool wantsStaticBatch() const { return m_gpuDriven && m_indirect; }
+    bool isGpuDriven() const { return m_indirect && m_indirect->isReady(); }
+
+    // Mesh uploads, advanced under a per-frame byte budget in beginFrame
+    UploadQueue* getUploadQueue() { return m_uploads.get(); }
+
+    // Animated characters, drawn with the scene's opaque geometry
+    CharacterSystem* getCharacters() { return m_characters.get(); }
+
+    // Decals and particles, drawn after the scene's opaque geometry
+    DecalSystem* getDecals() { return m_decals.get(); }
+    ParticleSystem* getParticles() { return m_particles.get(); }
+
+    // 2D overlay batch, drawn at native resolution after upscaling
+    OverlayRenderer* getOverlay() { return m_overlay.get(); }
+
+    // Render graph of the last frame, for statistics
+    const RenderGraph& getRenderGraph() const { return m_graph; }
+
     // Set camera for rendering
     void setCamera(const Camera* camera);
 
+    // Level of detail selection
+    int selectLod(const Mesh* mesh, const glm::mat4& modelMatrix, float* crossFade = nullptr) const;
+    void setLodCrossFade(bool enabled) { m_lodCrossFade = enabled; }
+    void setLodScale(float scale) { m_lodScale = scale; }
+
     // Projection control
     void setProjection(float fov, float aspect, float near, float far);
 
     // Shader management
     unsigned int loadShader(const char* vertexPath, const char* fragmentPath);
+    unsigned int loadComputeShader(const char* computePath);
     void useShader(unsigned int shaderProgram);
     void setShaderMat4(unsigned int shaderProgram, const char* name, const glm::mat4& mat);
     void setShaderVec3(unsigned int shaderProgram, const char* name, const glm::vec3& vec);
@@ -34,6 +83,16 @@ public:
 
     // Resize viewport
     void resize(int width, int height);
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+    // Dynamic resolution: the render scale follows the GPU frame time towards the target
+    void setDynamicResolution(bool enabled) { m_dynamicResolution = enabled; }
+    void setTargetFrameTime(float milliseconds) { m_targetFrameTime = milliseconds; }
+    void setRenderScale(float scale);
+    void setSharpness(float sharpness) { m_sharpness = sharpness; }
+    float getRenderScale() const { return m_renderScale; }
+    double getGpuFrameTime() const { return m_gpuFrameTime; }
 
 private:
     int m_width;
@@ -44,7 +103,51 @@ private:
 
     unsigned int m_defaultShader;
 
+    // LOD settings
+    bool m_lodCrossFade;
+    float m_lodScale;
+
+    // Static world
+    const std::vector<Mesh>* m_staticMeshes;
+    std::unique_ptr<IndirectRenderer> m_indirect;
+    bool m_gpuDriven;
+
+    std::unique_ptr<UploadQueue> m_uploads;
+    std::unique_ptr<CharacterSystem> m_characters;
+    std::unique_ptr<DecalSystem> m_decals;
+    std::unique_ptr<ParticleSystem> m_particles;
+    std::unique_ptr<OverlayRenderer> m_overlay;
+
+    // Frame recording
+    struct DrawCommand {
+        const Mesh* mesh;
+        glm::mat4 modelMatrix;
+    };
+    std::vector<DrawCommand> m_drawQueue;
+
+    // Render graph and the handles of the current frame's resources
+    RenderGraph m_graph;
+    RenderGraph::ResourceHandle m_sceneColor;
+    RenderGraph::ResourceHandle m_sceneDepth;
+    RenderGraph::ResourceHandle m_backbuffer;
+
+    // Dynamic resolution
+    std::unique_ptr<GpuTimer> m_frameTimer;
+    unsigned int m_upscaleShader;
+    unsigned int m_fullscreenVAO;
+    bool m_dynamicResolution;
+    float m_targetFrameTime;
+    float m_renderScale;
+    float m_sharpness;
+    double m_gpuFrameTime;
+    bool m_inFrame;
+
     // Helper functions
+    bool readShaderFile(const char* path, std::string& source);
+    void submitMesh(const Mesh* mesh, const glm::mat4& modelMatrix);
+    void executeScenePass();
+    void executeUpscalePass(unsigned int sceneTexture);
+    void updateRenderScale();
     unsigned int compileShader(const char* source, GLenum type);
     bool checkShaderCompileErrors(unsigned int shader);
     bool checkProgramLinkErrors(unsigned int program);
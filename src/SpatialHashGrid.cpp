@@ -0,0 +1,207 @@
+#include "SpatialHashGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const uint32_t NONE = 0xFFFFFFFFu;
+
+// Keeps cell coordinates far from int overflow for anything inside a level
+const float MAX_COORDINATE = 1e6f;
+
+bool overlaps(const glm::vec3& minA, const glm::vec3& maxA, const glm::vec3& minB, const glm::vec3& maxB) {
+    return minA.x <= maxB.x && maxA.x >= minB.x &&
+           minA.y <= maxB.y && maxA.y >= minB.y &&
+           minA.z <= maxB.z && maxA.z >= minB.z;
+}
+
+float distanceSquared(const glm::vec3& point, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    glm::vec3 offset = point - glm::clamp(point, boundsMin, boundsMax);
+    return glm::dot(offset, offset);
+}
+
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(float cellSize, uint32_t bucketCount)
+    : m_cellSize(cellSize > 0.0f ? cellSize : 2.0f)
+    , m_inverseCellSize(1.0f / m_cellSize)
+    , m_freeHead(NONE)
+    , m_liveCount(0)
+    , m_maxHalfExtent(0.0f)
+{
+    uint32_t buckets = 1;
+    while (buckets < bucketCount && buckets < (1u << 30)) buckets <<= 1;
+    m_bucketMask = buckets - 1;
+    m_buckets.assign(buckets, NONE);
+}
+
+uint32_t SpatialHashGrid::insert(uint32_t userData, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    uint32_t proxy = m_freeHead;
+    if (proxy != NONE) {
+        m_freeHead = m_proxies[proxy].next;
+    } else {
+        proxy = static_cast<uint32_t>(m_proxies.size());
+        m_proxies.push_back(Proxy());
+    }
+
+    Proxy& entry = m_proxies[proxy];
+    entry.userData = userData;
+    setBounds(entry, boundsMin, boundsMax);
+    glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    entry.cellX = cellCoordinate(center.x);
+    entry.cellZ = cellCoordinate(center.z);
+    link(proxy);
+    m_liveCount++;
+    return proxy;
+}
+
+void SpatialHashGrid::update(uint32_t proxy, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    if (proxy >= m_proxies.size() || m_proxies[proxy].bucket == NONE) return;
+    Proxy& entry = m_proxies[proxy];
+    setBounds(entry, boundsMin, boundsMax);
+
+    // Only a move into another column touches the lists
+    glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    int32_t cellX = cellCoordinate(center.x);
+    int32_t cellZ = cellCoordinate(center.z);
+    if (entry.cellX == cellX && entry.cellZ == cellZ) return;
+    unlink(proxy);
+    entry.cellX = cellX;
+    entry.cellZ = cellZ;
+    link(proxy);
+}
+
+void SpatialHashGrid::remove(uint32_t proxy) {
+    if (proxy >= m_proxies.size() || m_proxies[proxy].bucket == NONE) return;
+    unlink(proxy);
+    m_proxies[proxy].next = m_freeHead;
+    m_freeHead = proxy;
+    m_liveCount--;
+}
+
+void SpatialHashGrid::clear() {
+    std::fill(m_buckets.begin(), m_buckets.end(), NONE);
+    m_proxies.clear();
+    m_freeHead = NONE;
+    m_liveCount = 0;
+    m_maxHalfExtent = glm::vec2(0.0f);
+}
+
+size_t SpatialHashGrid::queryAabb(const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                                  uint32_t* results, size_t capacity) const {
+    auto accept = [&](const Proxy& proxy) {
+        return overlaps(proxy.boundsMin, proxy.boundsMax, boundsMin, boundsMax);
+    };
+    return query(boundsMin, boundsMax, accept, results, capacity);
+}
+
+size_t SpatialHashGrid::queryRadius(const glm::vec3& center, float radius, uint32_t* results, size_t capacity) const {
+    float radiusSquared = radius * radius;
+    auto accept = [&](const Proxy& proxy) {
+        return distanceSquared(center, proxy.boundsMin, proxy.boundsMax) <= radiusSquared;
+    };
+    return query(center - glm::vec3(radius), center + glm::vec3(radius), accept, results, capacity);
+}
+
+size_t SpatialHashGrid::queryAabbs(const Aabb* boxes, size_t count, uint32_t* results, size_t capacity,
+                                   QueryRange* ranges) const {
+    size_t written = 0;
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t found = queryAabb(boxes[i].boundsMin, boxes[i].boundsMax, results + written, capacity - written);
+        ranges[i].offset = static_cast<uint32_t>(written);
+        ranges[i].count = static_cast<uint32_t>(std::min(found, capacity - written));
+        written += ranges[i].count;
+        total += found;
+    }
+    return total;
+}
+
+size_t SpatialHashGrid::queryRadii(const Sphere* spheres, size_t count, uint32_t* results, size_t capacity,
+                                   QueryRange* ranges) const {
+    size_t written = 0;
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t found = queryRadius(spheres[i].center, spheres[i].radius, results + written, capacity - written);
+        ranges[i].offset = static_cast<uint32_t>(written);
+        ranges[i].count = static_cast<uint32_t>(std::min(found, capacity - written));
+        written += ranges[i].count;
+        total += found;
+    }
+    return total;
+}
+
+template <typename Accept>
+size_t SpatialHashGrid::query(const glm::vec3& boundsMin, const glm::vec3& boundsMax, Accept accept,
+                              uint32_t* results, size_t capacity) const {
+    size_t found = 0;
+    auto visit = [&](const Proxy& proxy) {
+        if (!accept(proxy)) return;
+        if (found < capacity) results[found] = proxy.userData;
+        found++;
+    };
+
+    // A proxy can only touch the box if its center is within its half-extent of it
+    int32_t minX = cellCoordinate(boundsMin.x - m_maxHalfExtent.x);
+    int32_t maxX = cellCoordinate(boundsMax.x + m_maxHalfExtent.x);
+    int32_t minZ = cellCoordinate(boundsMin.z - m_maxHalfExtent.y);
+    int32_t maxZ = cellCoordinate(boundsMax.z + m_maxHalfExtent.y);
+
+    // Ranges wider than the table are cheaper to answer by walking every proxy
+    uint64_t columns = static_cast<uint64_t>(maxX - minX + 1) * static_cast<uint64_t>(maxZ - minZ + 1);
+    if (columns > m_buckets.size() || columns > m_liveCount) {
+        for (const Proxy& proxy : m_proxies) {
+            if (proxy.bucket != NONE) visit(proxy);
+        }
+        return found;
+    }
+
+    for (int32_t z = minZ; z <= maxZ; z++) {
+        for (int32_t x = minX; x <= maxX; x++) {
+            // Buckets are shared between columns: skip the other columns' proxies
+            for (uint32_t i = m_buckets[bucketOf(x, z)]; i != NONE; i = m_proxies[i].next) {
+                const Proxy& proxy = m_proxies[i];
+                if (proxy.cellX == x && proxy.cellZ == z) visit(proxy);
+            }
+        }
+    }
+    return found;
+}
+
+void SpatialHashGrid::setBounds(Proxy& proxy, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    proxy.boundsMin = boundsMin;
+    proxy.boundsMax = boundsMax;
+    glm::vec3 halfExtent = (boundsMax - boundsMin) * 0.5f;
+    m_maxHalfExtent = glm::max(m_maxHalfExtent, glm::vec2(halfExtent.x, halfExtent.z));
+}
+
+int32_t SpatialHashGrid::cellCoordinate(float value) const {
+    float clamped = std::min(std::max(value, -MAX_COORDINATE), MAX_COORDINATE);
+    return static_cast<int32_t>(std::floor(clamped * m_inverseCellSize));
+}
+
+uint32_t SpatialHashGrid::bucketOf(int32_t cellX, int32_t cellZ) const {
+    uint32_t hash = static_cast<uint32_t>(cellX) * 0x9E3779B1u ^ static_cast<uint32_t>(cellZ) * 0x85EBCA77u;
+    hash ^= hash >> 16;
+    return hash & m_bucketMask;
+}
+
+void SpatialHashGrid::link(uint32_t proxy) {
+    Proxy& entry = m_proxies[proxy];
+    entry.bucket = bucketOf(entry.cellX, entry.cellZ);
+    entry.previous = NONE;
+    entry.next = m_buckets[entry.bucket];
+    if (entry.next != NONE) m_proxies[entry.next].previous = proxy;
+    m_buckets[entry.bucket] = proxy;
+}
+
+void SpatialHashGrid::unlink(uint32_t proxy) {
+    Proxy& entry = m_proxies[proxy];
+    if (entry.previous != NONE) {
+        m_proxies[entry.previous].next = entry.next;
+    } else {
+        m_buckets[entry.bucket] = entry.next;
+    }
+    if (entry.next != NONE) m_proxies[entry.next].previous = entry.previous;
+    entry.bucket = NONE;
+}
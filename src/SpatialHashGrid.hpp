@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Broadphase for dynamic entities (players, projectiles, pickups). Space is cut
+// into vertical columns of cellSize x cellSize, indoor levels being wide rather
+// than tall, and columns are hashed into a fixed table of buckets. Each proxy
+// lives in the column holding its center, linked into that bucket's list, so
+// moving it is O(1) and usually leaves it where it was; queries widen their range
+// by the largest proxy half-extent seen. Queries write the user data of what they
+// find into caller buffers and allocate nothing. Not thread-safe for updates;
+// concurrent queries are fine.
+class SpatialHashGrid {
+public:
+    struct Aabb {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    struct Sphere {
+        glm::vec3 center;
+        float radius;
+    };
+
+    // Where a batched query's results went
+    struct QueryRange {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    // bucketCount is rounded up to a power of two
+    explicit SpatialHashGrid(float cellSize = 2.0f, uint32_t bucketCount = 8192);
+
+    // Proxy ids are reused after remove()
+    uint32_t insert(uint32_t userData, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    void update(uint32_t proxy, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    void remove(uint32_t proxy);
+    void clear();
+
+    // Number of proxies found; only the first capacity are written to results
+    size_t queryAabb(const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                     uint32_t* results, size_t capacity) const;
+    size_t queryRadius(const glm::vec3& center, float radius, uint32_t* results, size_t capacity) const;
+
+    // Batches fill results back to back and record each query's range. Once
+    // results is full the remaining ranges are empty; the return value is the
+    // total found, so a result above capacity means the batch was cut short.
+    size_t queryAabbs(const Aabb* boxes, size_t count, uint32_t* results, size_t capacity,
+                      QueryRange* ranges) const;
+    size_t queryRadii(const Sphere* spheres, size_t count, uint32_t* results, size_t capacity,
+                      QueryRange* ranges) const;
+
+    size_t getProxyCount() const { return m_liveCount; }
+    float getCellSize() const { return m_cellSize; }
+    size_t getMemoryUsage() const {
+        return m_proxies.capacity() * sizeof(Proxy) + m_buckets.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    struct Proxy {
+        glm::vec3 boundsMin;
+        uint32_t userData;
+        glm::vec3 boundsMax;
+        uint32_t next;              // In the bucket, or in the free list
+        int32_t cellX;
+        int32_t cellZ;
+        uint32_t previous;
+        uint32_t bucket;            // All ones when free
+    };
+
+    float m_cellSize;
+    float m_inverseCellSize;
+    uint32_t m_bucketMask;
+    std::vector<uint32_t> m_buckets;    // First proxy of each bucket
+    std::vector<Proxy> m_proxies;
+    uint32_t m_freeHead;
+    size_t m_liveCount;
+    glm::vec2 m_maxHalfExtent;          // XZ, over every proxy since the last clear()
+
+    void setBounds(Proxy& proxy, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    int32_t cellCoordinate(float value) const;
+    uint32_t bucketOf(int32_t cellX, int32_t cellZ) const;
+    void link(uint32_t proxy);
+    void unlink(uint32_t proxy);
+
+    // User data of the proxies near the box that accept() takes
+    template <typename Accept>
+    size_t query(const glm::vec3& boundsMin, const glm::vec3& boundsMax, Accept accept,
+                 uint32_t* results, size_t capacity) const;
+};
@@ -0,0 +1,309 @@
+#include "TextureCompressor.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+bool loadTga(const unsigned char* data, size_t size, TextureCompressor::Image& image) {
+    if (size < 18) return false;
+    const int idLength = data[0];
+    const int colorMapType = data[1];
+    const int imageType = data[2];
+    const int width = data[12] | (data[13] << 8);
+    const int height = data[14] | (data[15] << 8);
+    const int bitsPerPixel = data[16];
+    const bool topDown = (data[17] & 0x20) != 0;
+
+    // True-color only: 2 = raw, 10 = RLE
+    if (colorMapType != 0 || (imageType != 2 && imageType != 10) ||
+        (bitsPerPixel != 24 && bitsPerPixel != 32) || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    const int bytesPerPixel = bitsPerPixel / 8;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    size_t pos = 18 + idLength;
+    image.width = width;
+    image.height = height;
+    image.rgba.assign(pixelCount * 4, 255);
+
+    size_t pixel = 0;
+    auto store = [&](const unsigned char* bgra) {
+        size_t x = pixel % width;
+        size_t y = pixel / width;
+        size_t row = topDown ? y : height - 1 - y;
+        unsigned char* out = &image.rgba[(row * width + x) * 4];
+        out[0] = bgra[2];
+        out[1] = bgra[1];
+        out[2] = bgra[0];
+        if (bytesPerPixel == 4) out[3] = bgra[3];
+        pixel++;
+    };
+
+    while (pixel < pixelCount) {
+        if (imageType == 2) {
+            if (pos + bytesPerPixel > size) return false;
+            store(data + pos);
+            pos += bytesPerPixel;
+            continue;
+        }
+
+        if (pos >= size) return false;
+        int header = data[pos++];
+        int count = (header & 0x7f) + 1;
+        if (pixel + count > pixelCount) return false;
+        if (header & 0x80) {
+            if (pos + bytesPerPixel > size) return false;
+            for (int i = 0; i < count; i++) store(data + pos);
+            pos += bytesPerPixel;
+        } else {
+            if (pos + static_cast<size_t>(count) * bytesPerPixel > size) return false;
+            for (int i = 0; i < count; i++, pos += bytesPerPixel) store(data + pos);
+        }
+    }
+    return true;
+}
+
+// Binary PPM (P6), 8 bits per channel
+bool loadPpm(const unsigned char* data, size_t size, TextureCompressor::Image& image) {
+    size_t pos = 2;
+    int values[3];
+    for (int& value : values) {
+        // Whitespace and comments between header fields
+        while (pos < size && (std::isspace(data[pos]) || data[pos] == '#')) {
+            if (data[pos] == '#') {
+                while (pos < size && data[pos] != '\n') pos++;
+            } else {
+                pos++;
+            }
+        }
+        value = 0;
+        size_t digits = 0;
+        while (pos < size && data[pos] >= '0' && data[pos] <= '9' && digits < 9) {
+            value = value * 10 + (data[pos++] - '0');
+            digits++;
+        }
+        if (digits == 0) return false;
+    }
+    pos++;
+
+    const int width = values[0];
+    const int height = values[1];
+    if (width <= 0 || height <= 0 || values[2] != 255) return false;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    if (pos + pixelCount * 3 > size) return false;
+
+    image.width = width;
+    image.height = height;
+    image.rgba.resize(pixelCount * 4);
+    for (size_t i = 0; i < pixelCount; i++) {
+        image.rgba[i * 4 + 0] = data[pos + i * 3 + 0];
+        image.rgba[i * 4 + 1] = data[pos + i * 3 + 1];
+        image.rgba[i * 4 + 2] = data[pos + i * 3 + 2];
+        image.rgba[i * 4 + 3] = 255;
+    }
+    return true;
+}
+
+uint16_t packRgb565(const float color[3]) {
+    int r = static_cast<int>(std::min(std::max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    int g = static_cast<int>(std::min(std::max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+    int b = static_cast<int>(std::min(std::max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t packed, int color[3]) {
+    int r = (packed >> 11) & 31;
+    int g = (packed >> 5) & 63;
+    int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+void writeLittle32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+} // namespace
+
+bool TextureCompressor::loadImage(const std::string& path, Image& image) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    const unsigned char* data = file.getData();
+    const size_t size = file.getSize();
+    bool loaded = size >= 2 && data[0] == 'P' && data[1] == '6' ? loadPpm(data, size, image)
+                                                              : loadTga(data, size, image);
+    if (!loaded) {
+        std::cerr << "TextureCompressor: unsupported or corrupt image: " << path << std::endl;
+    }
+    return loaded;
+}
+
+void TextureCompressor::compressBlock(const unsigned char block[16][4], unsigned char out[8]) {
+    // Principal axis of the block's colors (power iteration on the covariance)
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) mean[c] += block[i][c] / 16.0f;
+    }
+    float cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; i++) {
+        float d[3] = { block[i][0] - mean[0], block[i][1] - mean[1], block[i][2] - mean[2] };
+        cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+    }
+    float axis[3] = { 0.577f, 0.577f, 0.577f };
+    for (int iteration = 0; iteration < 4; iteration++) {
+        float next[3] = {
+            cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+            cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+            cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2],
+        };
+        float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (length < 1e-6f) break;
+        for (int c = 0; c < 3; c++) axis[c] = next[c] / length;
+    }
+
+    // Extremes along the axis become the endpoints
+    float minProj = 1e30f;
+    float maxProj = -1e30f;
+    for (int i = 0; i < 16; i++) {
+        float proj = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] + (block[i][2] - mean[2]) * axis[2];
+        minProj = std::min(minProj, proj);
+        maxProj = std::max(maxProj, proj);
+    }
+    float endpointA[3];
+    float endpointB[3];
+    for (int c = 0; c < 3; c++) {
+        endpointA[c] = mean[c] + axis[c] * maxProj;
+        endpointB[c] = mean[c] + axis[c] * minProj;
+    }
+    uint16_t color0 = packRgb565(endpointA);
+    uint16_t color1 = packRgb565(endpointB);
+    if (color0 < color1) std::swap(color0, color1);
+
+    // Four-color mode needs color0 > color1; a flat block uses index 0 only
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        int palette[4][3];
+        unpackRgb565(color0, palette[0]);
+        unpackRgb565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestError = 1 << 30;
+            for (int p = 0; p < 4; p++) {
+                int dr = block[i][0] - palette[p][0];
+                int dg = block[i][1] - palette[p][1];
+                int db = block[i][2] - palette[p][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(color0 & 0xff);
+    out[1] = static_cast<unsigned char>(color0 >> 8);
+    out[2] = static_cast<unsigned char>(color1 & 0xff);
+    out[3] = static_cast<unsigned char>(color1 >> 8);
+    for (int i = 0; i < 4; i++) out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+}
+
+std::vector<unsigned char> TextureCompressor::compressBC1(const Image& image) {
+    const int blocksX = (image.width + 3) / 4;
+    const int blocksY = (image.height + 3) / 4;
+    std::vector<unsigned char> out(static_cast<size_t>(blocksX) * blocksY * 8);
+
+    unsigned char block[16][4];
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            for (int i = 0; i < 16; i++) {
+                int x = std::min(bx * 4 + i % 4, image.width - 1);
+                int y = std::min(by * 4 + i / 4, image.height - 1);
+                std::memcpy(block[i], &image.rgba[(static_cast<size_t>(y) * image.width + x) * 4], 4);
+            }
+            compressBlock(block, &out[(static_cast<size_t>(by) * blocksX + bx) * 8]);
+        }
+    }
+    return out;
+}
+
+TextureCompressor::Image TextureCompressor::downsample(const Image& image) {
+    Image half;
+    half.width = std::max(1, image.width / 2);
+    half.height = std::max(1, image.height / 2);
+    half.rgba.resize(static_cast<size_t>(half.width) * half.height * 4);
+
+    for (int y = 0; y < half.height; y++) {
+        for (int x = 0; x < half.width; x++) {
+            int x0 = std::min(x * 2, image.width - 1);
+            int x1 = std::min(x * 2 + 1, image.width - 1);
+            int y0 = std::min(y * 2, image.height - 1);
+            int y1 = std::min(y * 2 + 1, image.height - 1);
+            for (int c = 0; c < 4; c++) {
+                int sum = image.rgba[(static_cast<size_t>(y0) * image.width + x0) * 4 + c] +
+                          image.rgba[(static_cast<size_t>(y0) * image.width + x1) * 4 + c] +
+                          image.rgba[(static_cast<size_t>(y1) * image.width + x0) * 4 + c] +
+                          image.rgba[(static_cast<size_t>(y1) * image.width + x1) * 4 + c];
+                half.rgba[(static_cast<size_t>(y) * half.width + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+    return half;
+}
+
+bool TextureCompressor::writeDds(const std::string& path, const Image& image) {
+    int mipCount = 1;
+    while ((image.width >> mipCount) > 0 || (image.height >> mipCount) > 0) mipCount++;
+
+    // DDS_HEADER with a DXT1 pixel format
+    const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+    std::vector<unsigned char> out;
+    out.insert(out.end(), { 'D', 'D', 'S', ' ' });
+    writeLittle32(out, 124);
+    writeLittle32(out, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE);
+    writeLittle32(out, image.height);
+    writeLittle32(out, image.width);
+    writeLittle32(out, static_cast<uint32_t>(((image.width + 3) / 4) * ((image.height + 3) / 4) * 8));
+    writeLittle32(out, 0);
+    writeLittle32(out, mipCount);
+    for (int i = 0; i < 11; i++) writeLittle32(out, 0);
+    writeLittle32(out, 32);
+    writeLittle32(out, DDPF_FOURCC);
+    out.insert(out.end(), { 'D', 'X', 'T', '1' });
+    for (int i = 0; i < 5; i++) writeLittle32(out, 0);
+    writeLittle32(out, DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX);
+    for (int i = 0; i < 4; i++) writeLittle32(out, 0);
+
+    Image level = image;
+    for (int mip = 0; mip < mipCount; mip++) {
+        std::vector<unsigned char> blocks = compressBC1(level);
+        out.insert(out.end(), blocks.begin(), blocks.end());
+        if (mip + 1 < mipCount) level = downsample(level);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(reinterpret_cast<const char*>(out.data()), out.size())) {
+        std::cerr << "TextureCompressor: failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
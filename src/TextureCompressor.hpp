@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Offline texture conversion for the asset cooker: reads uncompressed or RLE TGA
+// and binary PPM images and writes BC1 (DXT1) DDS files with a full mip chain,
+// ready for glCompressedTexImage2D with GL_COMPRESSED_RGB_S3TC_DXT1_EXT.
+class TextureCompressor {
+public:
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> rgba;
+    };
+
+    static bool loadImage(const std::string& path, Image& image);
+
+    // 8 bytes per 4x4 block; edges are clamped for sizes that are not multiples of 4
+    static std::vector<unsigned char> compressBC1(const Image& image);
+
+    // Box-filtered half-size image (at least 1x1)
+    static Image downsample(const Image& image);
+
+    static bool writeDds(const std::string& path, const Image& image);
+
+private:
+    static void compressBlock(const unsigned char block[16][4], unsigned char out[8]);
+};
@@ -0,0 +1,68 @@
+#include "TextureLoader.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// "DDS " plus the 124-byte DDS_HEADER
+const size_t DDS_HEADER_SIZE = 128;
+const size_t BC1_BLOCK_BYTES = 8;
+
+uint32_t readLittle32(const unsigned char* data) {
+    return uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+}
+
+} // namespace
+
+GpuHandle TextureLoader::loadDds(const std::string& path, size_t& bytes) {
+    bytes = 0;
+    MappedFile file;
+    if (!file.open(path)) return GpuHandle();
+    const unsigned char* data = file.getData();
+    const size_t size = file.getSize();
+
+    if (size < DDS_HEADER_SIZE || std::memcmp(data, "DDS ", 4) != 0 || readLittle32(data + 4) != 124 ||
+        std::memcmp(data + 84, "DXT1", 4) != 0) {
+        std::cerr << "TextureLoader: " << path << " is not a BC1 DDS file" << std::endl;
+        return GpuHandle();
+    }
+    const int height = static_cast<int>(readLittle32(data + 12));
+    const int width = static_cast<int>(readLittle32(data + 16));
+    const int mipCount = std::max(1, static_cast<int>(readLittle32(data + 28)));
+
+    // Whole chain inside the file before anything is created
+    size_t offset = DDS_HEADER_SIZE;
+    for (int mip = 0; mip < mipCount; mip++) {
+        size_t mipWidth = std::max(1, width >> mip);
+        size_t mipHeight = std::max(1, height >> mip);
+        offset += ((mipWidth + 3) / 4) * ((mipHeight + 3) / 4) * BC1_BLOCK_BYTES;
+    }
+    if (width <= 0 || height <= 0 || offset > size) {
+        std::cerr << "TextureLoader: " << path << " is truncated" << std::endl;
+        return GpuHandle();
+    }
+
+    GpuHandle texture = GpuResourceRegistry::get().create(GpuResourceType::Texture);
+    glBindTexture(GL_TEXTURE_2D, GpuResourceRegistry::get().getName(texture));
+    offset = DDS_HEADER_SIZE;
+    for (int mip = 0; mip < mipCount; mip++) {
+        int mipWidth = std::max(1, width >> mip);
+        int mipHeight = std::max(1, height >> mip);
+        size_t mipBytes = size_t((mipWidth + 3) / 4) * ((mipHeight + 3) / 4) * BC1_BLOCK_BYTES;
+        glCompressedTexImage2D(GL_TEXTURE_2D, mip, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, mipWidth, mipHeight, 0,
+                               static_cast<GLsizei>(mipBytes), data + offset);
+        offset += mipBytes;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipCount - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    bytes = offset - DDS_HEADER_SIZE;
+    return texture;
+}
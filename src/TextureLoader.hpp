@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "GpuResourceRegistry.hpp"
+
+// Runtime side of the asset cooker's textures: BC1 (DXT1) DDS files written by
+// TextureCompressor are mapped and their mip chains uploaded as they are with
+// glCompressedTexImage2D into a registry texture of the current resource group.
+// GL thread only.
+class TextureLoader {
+public:
+    // Null handle on failure; bytes receives the GPU size of the mip chain
+    static GpuHandle loadDds(const std::string& path, size_t& bytes);
+};
@@ -0,0 +1,99 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+    : m_task(nullptr)
+    , m_context(nullptr)
+    , m_count(0)
+    , m_next(0)
+    , m_completed(0)
+    , m_generation(0)
+    , m_activeWorkers(0)
+    , m_stop(false)
+{
+    if (workerCount == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    m_workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(int count, TaskFunction task, const void* context) {
+    if (count <= 0) return;
+
+    // Small loops, or a loop started from inside a task: run on this thread
+    std::unique_lock<std::mutex> submit(m_submitMutex, std::try_to_lock);
+    if (count == 1 || m_workers.empty() || !submit.owns_lock()) {
+        for (int i = 0; i < count; i++) task(context, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = task;
+        m_context = context;
+        m_count = count;
+        m_next.store(0);
+        m_completed.store(0);
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    runTasks();
+
+    // Wait for the last task, and for every worker to leave this loop
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_completed.load() == m_count && m_activeWorkers == 0; });
+    m_task = nullptr;
+}
+
+void ThreadPool::runTasks() {
+    for (;;) {
+        int index = m_next.fetch_add(1);
+        if (index >= m_count) break;
+        m_task(m_context, index);
+        if (m_completed.fetch_add(1) + 1 == m_count) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, seen] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+
+            // Woke after the loop already finished
+            if (!m_task) continue;
+            m_activeWorkers++;
+        }
+
+        runTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_activeWorkers--;
+        }
+        m_done.notify_all();
+    }
+}
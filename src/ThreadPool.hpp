@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops.
+// parallelFor() hands out indices through an atomic counter, so submitting
+// work allocates nothing; the calling thread takes part and the call returns
+// once every index has run. One loop runs at a time; nested calls run inline.
+class ThreadPool {
+public:
+    // 0 = one worker per hardware thread, minus the caller
+    explicit ThreadPool(unsigned int workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Run task(i) for every i in [0, count). The task is called through a plain
+    // function pointer, so large captures do not allocate the way std::function would.
+    template <typename Task>
+    void parallelFor(int count, const Task& task) {
+        run(count, [](const void* context, int index) { (*static_cast<const Task*>(context))(index); }, &task);
+    }
+
+    // Workers plus the calling thread
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::mutex m_submitMutex;
+
+    using TaskFunction = void (*)(const void* context, int index);
+
+    TaskFunction m_task;
+    const void* m_context;
+    int m_count;
+    std::atomic<int> m_next;
+    std::atomic<int> m_completed;
+    unsigned long long m_generation;
+    int m_activeWorkers;
+    bool m_stop;
+
+    void run(int count, TaskFunction task, const void* context);
+    void workerLoop();
+    void runTasks();
+};
@@ -0,0 +1,236 @@
+#include "UploadQueue.hpp"
+#include "Mesh.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Staged copies start on this boundary
+static const size_t STAGING_ALIGNMENT = 16;
+
+// Upper bound for blocking waits in flush()
+static const GLuint64 FLUSH_TIMEOUT_NS = 1000000000ull;
+
+UploadQueue::UploadQueue()
+    : m_mapped(nullptr)
+    , m_persistent(false)
+    , m_stagingSize(0)
+    , m_frameBudget(DEFAULT_FRAME_BUDGET)
+    , m_head(0)
+    , m_lastFrameBytes(0)
+{
+}
+
+UploadQueue::~UploadQueue() {
+    for (auto& job : m_jobs) {
+        job.mesh->m_uploadQueue = nullptr;
+    }
+    for (auto& batch : m_batches) {
+        for (Mesh* mesh : batch.completed) {
+            if (mesh) mesh->m_uploadQueue = nullptr;
+        }
+        glDeleteSync(batch.fence);
+    }
+    if (m_mapped) {
+        m_staging.bind();
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        m_staging.unbind();
+    }
+}
+
+bool UploadQueue::initialize(size_t stagingSize, size_t frameBudget) {
+    m_stagingSize = stagingSize;
+    m_frameBudget = frameBudget;
+    m_staging = VertexBuffer(GL_COPY_READ_BUFFER);
+    m_staging.bind();
+
+    if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        m_staging.setStorage(stagingSize, flags);
+        m_mapped = static_cast<char*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, stagingSize, flags));
+    } else {
+        m_staging.setData(nullptr, stagingSize, GL_STREAM_DRAW);
+    }
+    m_persistent = m_mapped != nullptr;
+    m_staging.unbind();
+
+    if (!m_staging.isValid()) {
+        std::cerr << "UploadQueue: failed to create staging buffer" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void UploadQueue::enqueue(Mesh& mesh) {
+    if (mesh.m_isReady || mesh.m_uploadQueue || mesh.m_residency == MeshResidency::CpuOnly) return;
+    if (!mesh.createGpuBuffers()) return;
+
+    Job job;
+    job.mesh = &mesh;
+    job.vertexBytes = mesh.getVertexCount() * sizeof(Vertex);
+    job.indexBytes = mesh.getIndexCount() * sizeof(unsigned int);
+    job.copiedBytes = 0;
+    m_jobs.push_back(job);
+    mesh.m_uploadQueue = this;
+}
+
+void UploadQueue::cancel(Mesh& mesh) {
+    // Copies already issued only touch the mesh's own buffers; they are harmless
+    m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(),
+                                [&mesh](const Job& job) { return job.mesh == &mesh; }),
+                 m_jobs.end());
+    for (auto& batch : m_batches) {
+        std::replace(batch.completed.begin(), batch.completed.end(), &mesh, static_cast<Mesh*>(nullptr));
+    }
+    mesh.m_uploadQueue = nullptr;
+}
+
+void UploadQueue::retarget(Mesh& from, Mesh& to) {
+    for (auto& job : m_jobs) {
+        if (job.mesh == &from) job.mesh = &to;
+    }
+    for (auto& batch : m_batches) {
+        std::replace(batch.completed.begin(), batch.completed.end(), &from, &to);
+    }
+}
+
+void UploadQueue::update() {
+    m_lastFrameBytes = 0;
+    retireBatches(false);
+    stageJobs(m_frameBudget);
+}
+
+void UploadQueue::flush() {
+    while (!m_jobs.empty()) {
+        size_t before = getPendingBytes();
+        stageJobs(m_stagingSize);
+        if (getPendingBytes() != before) continue;
+
+        // Ring full: wait for the oldest copies, give up if nothing is in flight
+        if (m_batches.empty()) {
+            std::cerr << "UploadQueue: flush made no progress" << std::endl;
+            break;
+        }
+        if (!retireBatches(true)) return;
+    }
+    retireBatches(true);
+}
+
+size_t UploadQueue::getPendingBytes() const {
+    size_t bytes = 0;
+    for (const auto& job : m_jobs) {
+        bytes += job.vertexBytes + job.indexBytes - job.copiedBytes;
+    }
+    return bytes;
+}
+
+bool UploadQueue::retireBatches(bool wait) {
+    while (!m_batches.empty()) {
+        Batch& batch = m_batches.front();
+        GLenum status = glClientWaitSync(batch.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                         wait ? FLUSH_TIMEOUT_NS : 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            // A fence that outlives the flush timeout is treated as lost; its
+            // meshes stay pending rather than blocking forever
+            if (wait) std::cerr << "UploadQueue: timed out waiting for a copy fence" << std::endl;
+            return false;
+        }
+        if (status == GL_WAIT_FAILED) {
+            std::cerr << "UploadQueue: fence wait failed" << std::endl;
+        }
+
+        glDeleteSync(batch.fence);
+        for (Mesh* mesh : batch.completed) {
+            if (mesh) mesh->finishUpload();
+        }
+        m_batches.pop_front();
+    }
+    return true;
+}
+
+size_t UploadQueue::reserveStaging(size_t wanted) {
+    if (m_batches.empty()) {
+        m_head = 0;
+        return std::min(wanted, m_stagingSize);
+    }
+
+    // Space between the write head and the oldest in-flight batch
+    size_t tail = m_batches.front().begin;
+    if (m_head < tail) return std::min(wanted, tail - m_head);
+    if (m_head == tail) return 0;
+
+    size_t toEnd = m_stagingSize - m_head;
+    if (toEnd >= wanted || tail <= toEnd) return std::min(wanted, toEnd);
+
+    // More room at the start of the ring
+    m_head = 0;
+    return std::min(wanted, tail);
+}
+
+void UploadQueue::stageJobs(size_t budget) {
+    size_t size = reserveStaging(std::min(budget, getPendingBytes()));
+    if (size == 0) return;
+
+    const size_t begin = m_head;
+    m_staging.bind();
+    char* staging = m_persistent
+        ? m_mapped + begin
+        : static_cast<char*>(glMapBufferRange(GL_COPY_READ_BUFFER, begin, size,
+                                              GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    if (!staging) {
+        std::cerr << "UploadQueue: failed to map staging buffer" << std::endl;
+        m_staging.unbind();
+        return;
+    }
+
+    struct Copy {
+        unsigned int buffer;
+        size_t source;
+        size_t destination;
+        size_t size;
+    };
+    std::vector<Copy> copies;
+    Batch batch;
+    size_t used = 0;
+
+    while (!m_jobs.empty() && used < size) {
+        Job& job = m_jobs.front();
+        Mesh* mesh = job.mesh;
+        size_t total = job.vertexBytes + job.indexBytes;
+
+        // A chunk may end in the vertices, span into the indices, or both
+        while (job.copiedBytes < total && used < size) {
+            bool vertices = job.copiedBytes < job.vertexBytes;
+            size_t offset = vertices ? job.copiedBytes : job.copiedBytes - job.vertexBytes;
+            size_t available = (vertices ? job.vertexBytes : job.indexBytes) - offset;
+            size_t bytes = std::min(available, size - used);
+            const char* source = vertices ? reinterpret_cast<const char*>(mesh->getVertexData())
+                                          : reinterpret_cast<const char*>(mesh->getIndexData());
+
+            std::memcpy(staging + used, source + offset, bytes);
+            copies.push_back({vertices ? mesh->m_VBO.getID() : mesh->m_EBO.getID(), begin + used, offset, bytes});
+            used += bytes;
+            job.copiedBytes += bytes;
+        }
+
+        if (job.copiedBytes < total) break;
+        batch.completed.push_back(mesh);
+        m_jobs.pop_front();
+    }
+
+    if (!m_persistent) glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+    for (const auto& copy : copies) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, copy.buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, copy.source, copy.destination, copy.size);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    m_staging.unbind();
+
+    batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    batch.begin = begin;
+    batch.end = begin + used;
+    m_batches.push_back(batch);
+
+    m_head = std::min((batch.end + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT, m_stagingSize);
+    m_lastFrameBytes += used;
+}
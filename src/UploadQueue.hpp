@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <GL/glew.h>
+#include "VertexBuffer.hpp"
+
+class Mesh;
+
+// Streams mesh geometry to the GPU without stalling the render thread.
+// Vertex and index data are written into a staging ring (persistently mapped on
+// GL 4.4 / ARB_buffer_storage, unsynchronized maps otherwise) and copied into the
+// meshes' buffers with glCopyBufferSubData, at most the frame budget per update.
+// Each update's copies are fenced; a mesh becomes ready once the fence covering
+// its last bytes has signaled, and the ring space is reused after that.
+//
+// Queued meshes must stay alive or be cancelled; Mesh does this itself when it is
+// moved, destroyed or given new data.
+class UploadQueue {
+public:
+    static const size_t DEFAULT_STAGING_SIZE = 4 * 1024 * 1024;
+    static const size_t DEFAULT_FRAME_BUDGET = 1024 * 1024;
+
+    UploadQueue();
+    ~UploadQueue();
+
+    UploadQueue(const UploadQueue&) = delete;
+    UploadQueue& operator=(const UploadQueue&) = delete;
+
+    bool initialize(size_t stagingSize = DEFAULT_STAGING_SIZE, size_t frameBudget = DEFAULT_FRAME_BUDGET);
+
+    // Allocates the mesh's GL storage and queues its data. Ignored for meshes that
+    // are already ready or pending, have no CPU data, or are CPU-only.
+    void enqueue(Mesh& mesh);
+    void cancel(Mesh& mesh);
+    void retarget(Mesh& from, Mesh& to);
+
+    // Once per frame: retire signaled batches, then stage and copy up to the budget
+    void update();
+
+    // Upload everything that is queued and wait for it (loading screens)
+    void flush();
+
+    void setFrameBudget(size_t bytes) { m_frameBudget = bytes; }
+    size_t getFrameBudget() const { return m_frameBudget; }
+    bool isPersistent() const { return m_persistent; }
+
+    // Statistics
+    size_t getPendingBytes() const;
+    int getPendingCount() const { return static_cast<int>(m_jobs.size()); }
+    size_t getLastFrameBytes() const { return m_lastFrameBytes; }
+
+private:
+    struct Job {
+        Mesh* mesh;
+        size_t vertexBytes;
+        size_t indexBytes;
+        size_t copiedBytes;     // Over vertices then indices
+    };
+
+    // Copies of one update, guarded by a fence
+    struct Batch {
+        GLsync fence;
+        size_t begin;
+        size_t end;
+        std::vector<Mesh*> completed;
+    };
+
+    VertexBuffer m_staging;
+    char* m_mapped;             // Persistent mapping, null when mapping per update
+    bool m_persistent;
+    size_t m_stagingSize;
+    size_t m_frameBudget;
+    size_t m_head;
+
+    std::deque<Job> m_jobs;
+    std::deque<Batch> m_batches;
+    size_t m_lastFrameBytes;
+
+    // False when the oldest batch is still in flight, after the flush timeout when waiting
+    bool retireBatches(bool wait);
+    size_t reserveStaging(size_t wanted);
+    void stageJobs(size_t budget);
+};
@@ -1,24 +1,76 @@
 #include "VertexBuffer.hpp"
 
+VertexBuffer::VertexBuffer()
+    : m_type(GL_ARRAY_BUFFER)
+    , m_size(0)
+    , m_tag(MemoryTag::Untagged)
+{
+}
+
 VertexBuffer::VertexBuffer(GLenum type)
-    : m_type(type)
+    : m_handle(GpuResourceRegistry::get().create(GpuResourceType::Buffer))
+    , m_type(type)
+    , m_size(0)
+    , m_tag(MemoryTag::Untagged)
 {
-    glGenBuffers(1, &m_bufferID);
 }
 
 VertexBuffer::~VertexBuffer() {
-    glDeleteBuffers(1, &m_bufferID);
+    release();
+}
+
+VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept
+    : m_handle(other.m_handle)
+    , m_type(other.m_type)
+    , m_size(other.m_size)
+    , m_tag(other.m_tag)
+{
+    other.m_handle = GpuHandle();
+    other.m_size = 0;
+}
+
+VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_handle = other.m_handle;
+        m_type = other.m_type;
+        m_size = other.m_size;
+        m_tag = other.m_tag;
+        other.m_handle = GpuHandle();
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+void VertexBuffer::release() {
+    GpuResourceRegistry::get().release(m_handle);
+    m_handle = GpuHandle();
+    track(0);
 }
 
 void VertexBuffer::bind() const {
-    glBindBuffer(m_type, m_bufferID);
+    glBindBuffer(m_type, getID());
 }
 
 void VertexBuffer::unbind() const {
     glBindBuffer(m_type, 0);
 }
 
-void VertexBuffer::setData(const void* data, unsigned int size) {
+void VertexBuffer::setData(const void* data, unsigned int size, GLenum usage) {
     bind();
-    glBufferData(m_type, size, data, GL_STATIC_DRAW);
+    glBufferData(m_type, size, data, usage);
+    track(size);
+}
+
+void VertexBuffer::setStorage(unsigned int size, GLbitfield flags) {
+    bind();
+    glBufferStorage(m_type, size, nullptr, flags);
+    track(size);
+}
+
+void VertexBuffer::track(size_t size) {
+    MemoryTracker::addGpuBytes(m_tag, -static_cast<int64_t>(m_size));
+    m_tag = MemoryTracker::getCurrentTag();
+    m_size = size;
+    MemoryTracker::addGpuBytes(m_tag, static_cast<int64_t>(m_size));
 }
@@ -1,20 +1,42 @@
 #pragma once
 
+#include <cstddef>
 #include <GL/glew.h>
+#include "GpuResourceRegistry.hpp"
+#include "MemoryTracker.hpp"
 
+// Owns one GL buffer object through the GpuResourceRegistry, so deletion waits
+// for the GPU. Move-only; a default-constructed buffer holds no GL object, so it
+// can live inside value types created before the GL context.
 class VertexBuffer {
 public:
-    VertexBuffer(GLenum type = GL_ARRAY_BUFFER);
+    VertexBuffer();
+    explicit VertexBuffer(GLenum type);
     ~VertexBuffer();
 
+    VertexBuffer(const VertexBuffer&) = delete;
+    VertexBuffer& operator=(const VertexBuffer&) = delete;
+    VertexBuffer(VertexBuffer&& other) noexcept;
+    VertexBuffer& operator=(VertexBuffer&& other) noexcept;
+
     void bind() const;
     void unbind() const;
 
-    void setData(const void* data, unsigned int size);
+    // Storage is charged to the calling thread's MemoryTracker tag
+    void setData(const void* data, unsigned int size, GLenum usage = GL_STATIC_DRAW);
+    void setStorage(unsigned int size, GLbitfield flags);      // Immutable (GL 4.4)
 
-    unsigned int getID() const { return m_bufferID; }
+    // 0 once released, including by a group release
+    unsigned int getID() const { return GpuResourceRegistry::get().getName(m_handle); }
+    size_t getSize() const { return m_size; }
+    bool isValid() const { return GpuResourceRegistry::get().isAlive(m_handle); }
 
 private:
-    unsigned int m_bufferID;
+    GpuHandle m_handle;
     GLenum m_type;
+    size_t m_size;
+    MemoryTag m_tag;
+
+    void release();
+    void track(size_t size);
 };
@@ -0,0 +1,308 @@
+#include "VisibilitySet.hpp"
+#include "BvhRaycaster.hpp"
+#include "CollisionBvh.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const int RAY_BATCH = 256;
+const uint32_t WORDS_PER_BLOCK = 32;                    // 2-bit kinds in one uint64_t
+const uint64_t LITERAL_KINDS = 0xAAAAAAAAAAAAAAAAull;   // High bit of every kind
+const uint64_t KIND_ONES = 1;
+const uint64_t KIND_LITERAL = 2;
+const uint32_t RAW_ROW = 0x80000000u;                   // Row offset flag: the row is a plain bitset
+const float STAND_CLEARANCE = 0.05f;                    // Capsule bottom above the floor for the stand test
+const float MAX_FLOOR_OFFSET = 1.0f;                    // A spot this far off a sample's floor is not on it
+const float COVER_SNAP = 0.25f;                         // Snap distance to a cover, in grid spacings
+
+size_t popcount(uint64_t bits) {
+    return std::bitset<64>(bits).count();
+}
+
+} // namespace
+
+VisibilitySet::VisibilitySet()
+    : VisibilitySet(Settings())
+{
+}
+
+VisibilitySet::VisibilitySet(const Settings& settings)
+    : m_settings(settings)
+    , m_firstCover(0)
+    , m_gridOrigin(0)
+    , m_gridSize(0)
+    , m_rowWords(0)
+    , m_rowBlocks(0)
+{
+}
+
+void VisibilitySet::bake(const CollisionBvh& bvh, const std::vector<glm::vec3>& floorMin,
+                         const std::vector<glm::vec3>& floorMax, const std::vector<glm::vec3>& covers,
+                         ThreadPool* pool) {
+    clear();
+    auto start = std::chrono::steady_clock::now();
+    const float spacing = m_settings.gridSpacing;
+    const float radius = m_settings.playerRadius;
+    const float snap = spacing * COVER_SNAP;
+
+    // World-aligned cells over all floor areas and covers, one point at each cell
+    // center the player can stand on; overlapping areas share their cells
+    if (!floorMin.empty() || !covers.empty()) {
+        glm::vec3 boundsMin(std::numeric_limits<float>::max());
+        glm::vec3 boundsMax(-std::numeric_limits<float>::max());
+        for (size_t i = 0; i < floorMin.size(); i++) {
+            boundsMin = glm::min(boundsMin, floorMin[i]);
+            boundsMax = glm::max(boundsMax, floorMax[i]);
+        }
+        for (const glm::vec3& cover : covers) {
+            boundsMin = glm::min(boundsMin, cover - glm::vec3(snap));
+            boundsMax = glm::max(boundsMax, cover + glm::vec3(snap));
+        }
+        m_gridOrigin = glm::ivec2(static_cast<int>(std::floor(boundsMin.x / spacing)),
+                                  static_cast<int>(std::floor(boundsMin.z / spacing)));
+        m_gridSize = glm::ivec2(static_cast<int>(std::floor(boundsMax.x / spacing)),
+                                static_cast<int>(std::floor(boundsMax.z / spacing))) - m_gridOrigin + 1;
+        m_gridPoints.assign(static_cast<size_t>(m_gridSize.x) * m_gridSize.y, -1);
+
+        for (size_t i = 0; i < floorMin.size(); i++) {
+            for (int z = 0; z < m_gridSize.y; z++) {
+                for (int x = 0; x < m_gridSize.x; x++) {
+                    glm::vec3 feet((m_gridOrigin.x + x + 0.5f) * spacing, floorMin[i].y,
+                                   (m_gridOrigin.y + z + 0.5f) * spacing);
+                    if (feet.x < floorMin[i].x + radius || feet.x > floorMax[i].x - radius ||
+                        feet.z < floorMin[i].z + radius || feet.z > floorMax[i].z - radius) {
+                        continue;
+                    }
+                    int32_t& cell = m_gridPoints[static_cast<size_t>(z) * m_gridSize.x + x];
+                    if (cell >= 0) continue;
+
+                    glm::vec3 bottom = feet + glm::vec3(0.0f, radius + STAND_CLEARANCE, 0.0f);
+                    glm::vec3 top = feet + glm::vec3(0.0f, m_settings.playerHeight - radius, 0.0f);
+                    if (bvh.overlapCapsule(bottom, top, radius)) continue;
+
+                    cell = static_cast<int32_t>(m_points.size());
+                    m_points.push_back(feet);
+                }
+            }
+        }
+    }
+    m_firstCover = static_cast<int>(m_points.size());
+    m_points.insert(m_points.end(), covers.begin(), covers.end());
+
+    // Every cell a spot could snap to a cover from lists that cover, in cover order
+    auto coverCells = [&](const glm::vec3& cover, glm::ivec2& first, glm::ivec2& last) {
+        first = glm::ivec2(static_cast<int>(std::floor((cover.x - snap) / spacing)),
+                           static_cast<int>(std::floor((cover.z - snap) / spacing))) - m_gridOrigin;
+        last = glm::ivec2(static_cast<int>(std::floor((cover.x + snap) / spacing)),
+                          static_cast<int>(std::floor((cover.z + snap) / spacing))) - m_gridOrigin;
+        first = glm::clamp(first, glm::ivec2(0), m_gridSize - 1);
+        last = glm::clamp(last, glm::ivec2(0), m_gridSize - 1);
+    };
+    m_cellCoverStart.assign(m_gridPoints.size() + 1, 0);
+    for (const glm::vec3& cover : covers) {
+        glm::ivec2 first, last;
+        coverCells(cover, first, last);
+        for (int z = first.y; z <= last.y; z++) {
+            for (int x = first.x; x <= last.x; x++) {
+                m_cellCoverStart[static_cast<size_t>(z) * m_gridSize.x + x + 1]++;
+            }
+        }
+    }
+    for (size_t cell = 0; cell < m_gridPoints.size(); cell++) {
+        m_cellCoverStart[cell + 1] += m_cellCoverStart[cell];
+    }
+    m_cellCovers.resize(m_cellCoverStart.back());
+    std::vector<uint32_t> cellFill(m_cellCoverStart.begin(), m_cellCoverStart.end() - 1);
+    for (size_t i = 0; i < covers.size(); i++) {
+        glm::ivec2 first, last;
+        coverCells(covers[i], first, last);
+        for (int z = first.y; z <= last.y; z++) {
+            for (int x = first.x; x <= last.x; x++) {
+                size_t cell = static_cast<size_t>(z) * m_gridSize.x + x;
+                m_cellCovers[cellFill[cell]++] = m_firstCover + static_cast<int32_t>(i);
+            }
+        }
+    }
+
+    const int samples = getSampleCount();
+    m_rowWords = (samples + 63) / 64;
+    m_rowBlocks = (m_rowWords + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK;
+    std::vector<uint64_t> matrix(static_cast<size_t>(samples) * m_rowWords, 0);
+
+    // Row i casts to every later sample; pairing short rows with long ones keeps
+    // the tasks even. Each task writes only its own rows.
+    BvhRaycaster raycaster(bvh);
+    auto bakeRow = [&](int row) {
+        BvhRaycaster::Ray rays[RAY_BATCH];
+        BvhRaycaster::Hit hits[RAY_BATCH];
+        uint64_t* bits = &matrix[static_cast<size_t>(row) * m_rowWords];
+        bits[row >> 6] |= 1ull << (row & 63);
+        glm::vec3 eye = getSampleEye(row);
+        for (int first = row + 1; first < samples; first += RAY_BATCH) {
+            int count = std::min(RAY_BATCH, samples - first);
+            for (int i = 0; i < count; i++) {
+                rays[i] = BvhRaycaster::Ray{ eye, getSampleEye(first + i) - eye, 1.0f };
+            }
+            raycaster.cast(rays, count, BvhRaycaster::Mode::AnyHit, hits);
+            for (int i = 0; i < count; i++) {
+                int column = first + i;
+                if (hits[i].triangle < 0) bits[column >> 6] |= 1ull << (column & 63);
+            }
+        }
+    };
+    auto bakeRows = [&](int task) {
+        bakeRow(task);
+        if (samples - 1 - task != task) bakeRow(samples - 1 - task);
+    };
+    int tasks = (samples + 1) / 2;
+    if (pool) {
+        pool->parallelFor(tasks, bakeRows);
+    } else {
+        for (int task = 0; task < tasks; task++) {
+            bakeRows(task);
+        }
+    }
+
+    // Mirror the upper triangle, then compress
+    for (int row = 0; row < samples; row++) {
+        const uint64_t* bits = &matrix[static_cast<size_t>(row) * m_rowWords];
+        for (int column = row + 1; column < samples; column++) {
+            if (bits[column >> 6] & (1ull << (column & 63))) {
+                matrix[static_cast<size_t>(column) * m_rowWords + (row >> 6)] |= 1ull << (row & 63);
+            }
+        }
+    }
+    m_exposure.resize(samples);
+    for (int row = 0; row < samples; row++) {
+        const uint64_t* bits = &matrix[static_cast<size_t>(row) * m_rowWords];
+        size_t visible = 0;
+        for (uint32_t word = 0; word < m_rowWords; word++) {
+            visible += popcount(bits[word]);
+        }
+        m_exposure[row] = static_cast<uint32_t>(visible - 1);
+        compressRow(bits);
+    }
+
+    // Without enough uniform words the row offsets outweigh the savings: keep the
+    // matrix as it is, with no offsets
+    m_stats.uncompressedBytes = matrix.size() * sizeof(uint64_t);
+    if (m_rowOffsets.size() * sizeof(uint32_t) + m_rowData.size() * sizeof(uint64_t) >= m_stats.uncompressedBytes) {
+        m_rowOffsets.clear();
+        m_rowOffsets.shrink_to_fit();
+        m_rowData = std::move(matrix);
+    }
+    m_rowData.shrink_to_fit();
+
+    m_stats.samples = samples;
+    m_stats.rays = static_cast<size_t>(samples) * (samples - 1) / 2;
+    m_stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_stats.compressedBytes = m_rowOffsets.size() * sizeof(uint32_t) + m_rowData.size() * sizeof(uint64_t);
+}
+
+void VisibilitySet::clear() {
+    m_stats = Stats();
+    m_points.clear();
+    m_firstCover = 0;
+    m_gridOrigin = glm::ivec2(0);
+    m_gridSize = glm::ivec2(0);
+    m_gridPoints.clear();
+    m_cellCoverStart.clear();
+    m_cellCovers.clear();
+    m_rowWords = 0;
+    m_rowBlocks = 0;
+    m_rowOffsets.clear();
+    m_rowData.clear();
+    m_exposure.clear();
+}
+
+int VisibilitySet::findSample(const glm::vec3& position, Stance stance) const {
+    int x = static_cast<int>(std::floor(position.x / m_settings.gridSpacing)) - m_gridOrigin.x;
+    int z = static_cast<int>(std::floor(position.z / m_settings.gridSpacing)) - m_gridOrigin.y;
+    if (x < 0 || z < 0 || x >= m_gridSize.x || z >= m_gridSize.y) return -1;
+    size_t cell = static_cast<size_t>(z) * m_gridSize.x + x;
+
+    int point = -1;
+    float snap = m_settings.gridSpacing * COVER_SNAP;
+    for (uint32_t i = m_cellCoverStart[cell]; i < m_cellCoverStart[cell + 1] && point < 0; i++) {
+        glm::vec3 offset = position - m_points[m_cellCovers[i]];
+        if (offset.x * offset.x + offset.z * offset.z <= snap * snap && std::fabs(offset.y) < MAX_FLOOR_OFFSET) {
+            point = m_cellCovers[i];
+        }
+    }
+
+    if (point < 0) {
+        point = m_gridPoints[cell];
+        if (point < 0 || std::fabs(position.y - m_points[point].y) >= MAX_FLOOR_OFFSET) return -1;
+    }
+    return point * 2 + (stance == Stance::Crouching ? 1 : 0);
+}
+
+bool VisibilitySet::isVisible(int from, int to) const {
+    uint32_t word = static_cast<uint32_t>(to) >> 6;
+    if (m_rowOffsets.empty()) {
+        return (m_rowData[static_cast<size_t>(from) * m_rowWords + word] >> (to & 63)) & 1;
+    }
+    uint32_t offset = m_rowOffsets[from];
+    const uint64_t* row = &m_rowData[offset & ~RAW_ROW];
+    if (offset & RAW_ROW) return (row[word] >> (to & 63)) & 1;
+
+    uint32_t block = word / WORDS_PER_BLOCK;
+    uint32_t shift = (word % WORDS_PER_BLOCK) * 2;
+    uint64_t kind = (row[block] >> shift) & 3;
+    if (kind != KIND_LITERAL) return kind == KIND_ONES;
+
+    // Literals follow the row's kinds in word order
+    size_t literal = m_rowBlocks + popcount(row[block] & LITERAL_KINDS & ((1ull << shift) - 1));
+    for (uint32_t previous = 0; previous < block; previous++) {
+        literal += popcount(row[previous] & LITERAL_KINDS);
+    }
+    return (row[literal] >> (to & 63)) & 1;
+}
+
+bool VisibilitySet::isExposed(const glm::vec3& position, Stance stance, const glm::vec3& from, Stance fromStance) const {
+    int target = findSample(position, stance);
+    int viewer = findSample(from, fromStance);
+    if (target < 0 || viewer < 0) return true;
+    return isVisible(viewer, target);
+}
+
+glm::vec3 VisibilitySet::getSampleEye(int sample) const {
+    float height = (sample & 1) ? m_settings.crouchingEyeHeight : m_settings.standingEyeHeight;
+    return m_points[sample >> 1] + glm::vec3(0.0f, height, 0.0f);
+}
+
+size_t VisibilitySet::getMemoryUsage() const {
+    return m_points.capacity() * sizeof(glm::vec3) + m_gridPoints.capacity() * sizeof(int32_t) +
+           m_cellCoverStart.capacity() * sizeof(uint32_t) + m_cellCovers.capacity() * sizeof(int32_t) +
+           m_rowOffsets.capacity() * sizeof(uint32_t) + m_rowData.capacity() * sizeof(uint64_t) +
+           m_exposure.capacity() * sizeof(uint32_t);
+}
+
+void VisibilitySet::compressRow(const uint64_t* row) {
+    size_t offset = m_rowData.size();
+    m_rowData.resize(offset + m_rowBlocks, 0);
+    uint32_t literals = 0;
+    for (uint32_t word = 0; word < m_rowWords; word++) {
+        uint64_t bits = row[word];
+        uint64_t kind = bits == 0 ? 0 : bits == ~0ull ? KIND_ONES : KIND_LITERAL;
+        if (kind == KIND_LITERAL) {
+            m_rowData.push_back(bits);
+            literals++;
+        }
+        m_rowData[offset + word / WORDS_PER_BLOCK] |= kind << ((word % WORDS_PER_BLOCK) * 2);
+    }
+
+    // Rows the kinds would not shrink are kept as they are
+    if (m_rowBlocks + literals >= m_rowWords) {
+        m_rowData.resize(offset);
+        m_rowData.insert(m_rowData.end(), row, row + m_rowWords);
+        offset |= RAW_ROW;
+    }
+    m_rowOffsets.push_back(static_cast<uint32_t>(offset));
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+class CollisionBvh;
+class ThreadPool;
+
+// Potentially visible set between standing spots of a level, baked once at load.
+// Samples are points of a floor grid plus every cover position, each at a
+// standing and a crouching eye height; two samples see each other when an
+// any-hit ray between their eyes is clear. The bake casts the rays in packets
+// over a thread pool and keeps the symmetric visibility matrix as compressed
+// bitset rows: every 64-bit word of a row is all clear, all set or stored
+// literally, with a 2-bit kind per word (32 to a block) ahead of the literals,
+// so a lookup is a few shifts, a popcount per block up to the word and one load.
+// Rows the encoding would not make smaller are stored as plain bitsets, and the
+// whole matrix is when that beats the encoded rows and their offsets.
+class VisibilitySet {
+public:
+    enum class Stance {
+        Standing,
+        Crouching
+    };
+
+    struct Settings {
+        float gridSpacing = 1.0f;
+        float standingEyeHeight = 1.7f;
+        float crouchingEyeHeight = 1.0f;
+        float playerRadius = 0.3f;      // Grid points the player could not stand on are dropped
+        float playerHeight = 1.8f;
+    };
+
+    struct Stats {
+        size_t samples = 0;
+        size_t rays = 0;
+        double seconds = 0.0;
+        size_t compressedBytes = 0;
+        size_t uncompressedBytes = 0;
+    };
+
+    VisibilitySet();
+    explicit VisibilitySet(const Settings& settings);
+
+    // Floor areas are axis-aligned rectangles (min and max corners on the floor)
+    // that get grid points; covers are exact standing spots.
+    void bake(const CollisionBvh& bvh, const std::vector<glm::vec3>& floorMin, const std::vector<glm::vec3>& floorMax,
+              const std::vector<glm::vec3>& covers, ThreadPool* pool = nullptr);
+    void clear();
+
+    // Sample for a spot: a cover within a quarter of the grid spacing, else the
+    // grid point of its cell. -1 when the spot is off the baked floor. One cell
+    // read; the covers near each cell are listed at bake time.
+    int findSample(const glm::vec3& position, Stance stance) const;
+
+    // Bit lookups
+    bool isVisible(int from, int to) const;
+
+    // Whether someone at from can see position; unknown spots count as exposed
+    bool isExposed(const glm::vec3& position, Stance stance, const glm::vec3& from, Stance fromStance) const;
+
+    // Samples that see this one, counted at bake time
+    uint32_t getExposure(int sample) const { return m_exposure[sample]; }
+
+    int getSampleCount() const { return static_cast<int>(m_points.size() * 2); }
+    glm::vec3 getSampleEye(int sample) const;
+    const Stats& getStats() const { return m_stats; }
+    size_t getMemoryUsage() const;
+
+private:
+    Settings m_settings;
+    Stats m_stats;
+
+    std::vector<glm::vec3> m_points;        // Feet; cover points follow the grid points
+    int m_firstCover;
+
+    // Grid cell -> point index (-1 for none) over the floor and cover bounds, and
+    // the covers a spot in the cell may snap to (cell i's are at [start[i], start[i + 1]))
+    glm::ivec2 m_gridOrigin;
+    glm::ivec2 m_gridSize;
+    std::vector<int32_t> m_gridPoints;
+    std::vector<uint32_t> m_cellCoverStart;
+    std::vector<int32_t> m_cellCovers;
+
+    // Rows back to back: kind blocks then literals, or the plain bitset when the
+    // offset has the raw flag (top bit) set. No offsets: the plain matrix.
+    uint32_t m_rowWords;
+    uint32_t m_rowBlocks;
+    std::vector<uint32_t> m_rowOffsets;
+    std::vector<uint64_t> m_rowData;
+    std::vector<uint32_t> m_exposure;
+
+    void compressRow(const uint64_t* row);
+};
@@ -1,7 +1,13 @@
 #include "Weapon.hpp"
+#include "MemoryTracker.hpp"
 #include <iostream>
 #include <algorithm>
 
+ObjectPool<Weapon>& Weapon::getPool() {
+    static ObjectPool<Weapon> pool(POOL_CAPACITY, MemoryTag::Weapon);
+    return pool;
+}
+
 Weapon::Weapon(const std::string& name, float damage, float fireRate, int magazineSize)
     : m_name(name)
     , m_damage(damage)
@@ -11,6 +17,7 @@ Weapon::Weapon(const std::string& name, float damage, float fireRate, int magazi
     , m_isReloading(false)
     , m_reloadTime(2.0f)  // Default 2 seconds reload time
     , m_spread(0.1f)      // Default spread
+    , m_pellets(1)
     , m_recoil(0.2f)      // Default recoil
     , m_isAutomatic(true) // Default to automatic
 {
@@ -23,6 +30,7 @@ Weapon::Weapon(const std::string& name, float damage, float fireRate, int magazi
     } else if (name == "Shotgun") {
         m_reloadTime = 3.0f;
         m_spread = 0.3f;
+        m_pellets = MAX_PELLETS;
         m_recoil = 0.8f;
         m_isAutomatic = false;
     } else if (name == "SMG") {
@@ -43,7 +51,7 @@ bool Weapon::shoot() {
     m_currentAmmo--;
     m_lastShotTime = std::chrono::steady_clock::now();
 
-    // Here we would trigger shooting effects, sounds, etc.
+    // Effects are spawned by the owner, which knows where the muzzle is
     return true;
 }
 
@@ -2,11 +2,23 @@
 
 #include <string>
 #include <chrono>
+#include "ObjectPool.hpp"
 
 class Weapon {
 public:
+    using Handle = PoolHandle<Weapon>;
+
+    // Three per player, for 64+ players
+    static const size_t POOL_CAPACITY = 256;
+
+    // Projectiles per shot, traced together as one ray packet
+    static const int MAX_PELLETS = 8;
+
     Weapon(const std::string& name, float damage, float fireRate, int magazineSize);
 
+    // Every weapon in a match lives here; reset it when the match ends
+    static ObjectPool<Weapon>& getPool();
+
     // Weapon actions
     bool shoot();
     void reload();
@@ -21,6 +33,8 @@ public:
     float getDamage() const { return m_damage; }
     int getAmmoCount() const { return m_currentAmmo; }
     int getMagazineSize() const { return m_magazineSize; }
+    float getSpread() const { return m_spread; }
+    int getPellets() const { return m_pellets; }
 
     // Update (for animations, reload timing, etc.)
     void update(float deltaTime);
@@ -40,6 +54,7 @@ private:
 
     // Weapon characteristics
     float m_spread;        // Accuracy spread
+    int m_pellets;         // Projectiles per shot, at most MAX_PELLETS
     float m_recoil;        // Recoil amount
     bool m_isAutomatic;    // Whether the weapon fires automatically
 };  
@@ -1,13 +1,25 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "AllocationCounter.hpp"
 #include "Camera.hpp"
 #include "Player.hpp"
 #include "Renderer.hpp"
 #include "Level.hpp"
+#include "MemoryTracker.hpp"
+#include "Benchmark.hpp"
+#include "FrameArena.hpp"
+#include "FramePacer.hpp"
+#include "GpuResourceRegistry.hpp"
+#include "Hud.hpp"
+#include "ThreadPool.hpp"
 
 // Window dimensions
 const unsigned int SCR_WIDTH = 1280;
@@ -18,7 +30,6 @@ float lastX = SCR_WIDTH / 2.0f;
 float lastY = SCR_HEIGHT / 2.0f;
 bool firstMouse = true;
 float deltaTime = 0.0f;
-float lastFrame = 0.0f;
 
 // Player pointer for callback access
 Player* g_player = nullptr;
@@ -83,7 +94,64 @@ void processInput(GLFWwindow* window) {
     }
 }
 
-int main() {
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--fps N] [--no-vsync] [--jit] [--no-gpu-driven] [--retain-mesh-data] [--level file.agl]"
+              << " [--benchmark [--frames N] [--warmup N] [--size WxH] [--shooters N] [--characters N] [--entities N] [--rays N] [--output file.json]]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // Parse command line
+    bool benchmarkMode = false;
+    Benchmark::Settings benchmarkSettings;
+    double targetFps = 0.0;
+    bool vsync = true;
+    bool justInTime = false;
+    bool gpuDriven = true;
+    bool retainMeshData = false;
+    std::string levelPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--fps" && i + 1 < argc) {
+            targetFps = std::atof(argv[++i]);
+        } else if (arg == "--no-vsync") {
+            vsync = false;
+        } else if (arg == "--jit") {
+            justInTime = true;
+        } else if (arg == "--no-gpu-driven") {
+            gpuDriven = false;
+        } else if (arg == "--level" && i + 1 < argc) {
+            levelPath = argv[++i];
+        } else if (arg == "--retain-mesh-data") {
+            retainMeshData = true;
+            benchmarkSettings.retainMeshData = true;
+        } else if (arg == "--benchmark") {
+            benchmarkMode = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            benchmarkSettings.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            benchmarkSettings.warmupFrames = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--size" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &benchmarkSettings.width, &benchmarkSettings.height) != 2 ||
+                benchmarkSettings.width <= 0 || benchmarkSettings.height <= 0) {
+                printUsage(argv[0]);
+                return -1;
+            }
+        } else if (arg == "--shooters" && i + 1 < argc) {
+            benchmarkSettings.shooters = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--characters" && i + 1 < argc) {
+            benchmarkSettings.characters = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--entities" && i + 1 < argc) {
+            benchmarkSettings.entities = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--rays" && i + 1 < argc) {
+            benchmarkSettings.rays = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--output" && i + 1 < argc) {
+            benchmarkSettings.outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
     // Initialize GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -99,6 +167,11 @@ int main() {
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
+    // Benchmark renders offscreen; the window only provides the context
+    if (benchmarkMode) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
+
     // Create window
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Ag-n - Indoor Battle Royale", nullptr, nullptr);
     if (window == nullptr) {
@@ -108,6 +181,35 @@ int main() {
     }
 
     glfwMakeContextCurrent(window);
+
+    if (benchmarkMode) {
+        int result = 0;
+        {
+            glewExperimental = GL_TRUE;
+            Renderer renderer(benchmarkSettings.width, benchmarkSettings.height);
+            if (!renderer.initialize()) {
+                std::cerr << "Failed to initialize renderer" << std::endl;
+                result = -1;
+            } else {
+                glfwSwapInterval(0);
+                renderer.setGpuDriven(gpuDriven);
+                Level level;
+                Benchmark benchmark(benchmarkSettings);
+                if (levelPath.empty()) {
+                    level.generateApartment();
+                } else if (!level.loadFromFile(levelPath)) {
+                    result = -1;
+                }
+                if (result == 0 && (!benchmark.run(renderer, level) || !benchmark.writeResults())) {
+                    result = -1;
+                }
+            }
+        }
+        GpuResourceRegistry::get().flush();
+        glfwTerminate();
+        return result;
+    }
+
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
@@ -123,53 +225,122 @@ int main() {
         return -1;
     }
 
-    // Create renderer
-    Renderer renderer(SCR_WIDTH, SCR_HEIGHT);
-    if (!renderer.initialize()) {
-        std::cerr << "Failed to initialize renderer" << std::endl;
-        return -1;
-    }
+    // Everything that owns GL objects is destroyed before the registry is flushed
+    {
+        // Create renderer
+        Renderer renderer(SCR_WIDTH, SCR_HEIGHT);
+        if (!renderer.initialize()) {
+            std::cerr << "Failed to initialize renderer" << std::endl;
+            return -1;
+        }
+
+        // Store renderer in window user pointer for callback access
+        glfwSetWindowUserPointer(window, &renderer);
+
+        // Create level
+        Level level;
+        if (levelPath.empty()) {
+            level.generateApartment();
+        } else if (!level.loadFromFile(levelPath)) {
+            return -1;
+        }
 
-    // Store renderer in window user pointer for callback access
-    glfwSetWindowUserPointer(window, &renderer);
+        // GPU-driven: untextured meshes are uploaded and drawn as one batch
+        renderer.setGpuDriven(gpuDriven);
+        if (renderer.wantsStaticBatch()) {
+            level.buildStaticBatch();
+        }
+        renderer.setStaticMeshes(level.getMeshes(), level.getStaticBatch());
+
+        // Geometry lives on the GPU; collision queries use the level's compact copy
+        if (!retainMeshData) {
+            level.setMeshResidency(MeshResidency::GpuOnly);
+        }
+        level.queueUploads(*renderer.getUploadQueue());
 
-    // Create level
-    Level level;
+        // Create player
+        Player player(glm::vec3(0.0f, 0.0f, 0.0f));
+        g_player = &player;
+        player.setParticleSystem(renderer.getParticles());
+        player.setDecalSystem(renderer.getDecals());
+        player.setLevel(&level);
 
-    // Create player
-    Player player(glm::vec3(0.0f, 0.0f, 0.0f));
-    g_player = &player;
+        // Workers for particle and other data-parallel updates
+        ThreadPool threadPool;
+        level.bakeVisibility(&threadPool);
 
-    // Set camera for renderer
-    renderer.setCamera(&player.getCamera());
+        // Set camera for renderer
+        renderer.setCamera(&player.getCamera());
 
-    // Game loop
-    while (!glfwWindowShouldClose(window)) {
-        // Calculate delta time
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        Hud hud(*renderer.getOverlay());
 
-        // Input
-        processInput(window);
+        // Frame pacing
+        glfwSwapInterval(vsync ? 1 : 0);
+        FramePacer pacer;
+        pacer.setTargetFps(targetFps);
+        pacer.setJustInTime(justInTime);
 
-        // Update
-        player.update(deltaTime);
+        double statsTime = glfwGetTime();
+        int statsFrames = 0;
+        AllocationCounter::Snapshot statsHeap = AllocationCounter::get();
 
-        // Render
-        renderer.clear();
+        // Game loop
+        while (!glfwWindowShouldClose(window)) {
+            // Wait for the frame slot, then sample input as late as possible
+            pacer.waitForNextFrame();
+            FrameArena::beginFrame();
+            glfwPollEvents();
+            deltaTime = pacer.markInputSampled();
 
-        // Draw level
-        for (const auto& mesh : level.getMeshes()) {
-            renderer.drawMesh(mesh, glm::mat4(1.0f));
+            // Input
+            processInput(window);
+
+            // Update
+            player.update(deltaTime);
+            renderer.getParticles()->update(deltaTime, &threadPool);
+
+            // Render
+            renderer.beginFrame();
+            renderer.clear();
+            hud.build(player, renderer.getWidth(), renderer.getHeight());
+            renderer.endFrame();
+
+            // Swap buffers
+            glfwSwapBuffers(window);
+            pacer.endFrame();
+
+            // Frame rate and input latency in the title, once per second
+            statsFrames++;
+            double now = glfwGetTime();
+            if (now - statsTime >= 1.0) {
+                AllocationCounter::Snapshot heap = AllocationCounter::get();
+                char title[192];
+                std::snprintf(title, sizeof(title),
+                              "Ag-n - Indoor Battle Royale | %.0f fps | latency %.1f ms avg, %.1f ms max | %.1f allocs/frame",
+                              statsFrames / (now - statsTime), pacer.getAverageLatency(), pacer.getMaxLatency(),
+                              static_cast<double>((heap - statsHeap).allocations) / statsFrames);
+                glfwSetWindowTitle(window, title);
+                MemoryTracker::update(now - statsTime);
+                statsTime = now;
+                statsFrames = 0;
+                statsHeap = heap;
+            }
         }
 
-        // Swap buffers and poll events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // End of the match: where the memory went
+        MemoryTracker::update(glfwGetTime() - statsTime);
+        MemoryTracker::dump(std::cout);
+
+        // Match teardown is one pool reset; the player's handles go stale
+        Weapon::getPool().reset();
+
+        // Callbacks must not reach the objects going out of scope
+        g_player = nullptr;
+        glfwSetWindowUserPointer(window, nullptr);
     }
 
     // Cleanup
+    GpuResourceRegistry::get().flush();
     glfwTerminate();
     return 0;
 }